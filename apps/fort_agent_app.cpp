@@ -1,17 +1,27 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <unistd.h>
 
 #include <boost/asio.hpp>
 #include <boost/program_options.hpp>
 #include <spdlog/spdlog.h>
+#include <spdlog/async.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/rotating_file_sink.h>
 
 #include <fort_agent/dbgTrace.h>
 #include <fort_agent/fort_agent.h>
+#include <fort_agent/ioBackend.h>
 
 namespace po = boost::program_options;
 
@@ -21,12 +31,29 @@ struct Configuration {
     int coap_port = 5683;
     std::string log_level = "info";
     std::string log_file = "/var/log/fort-agent/fort-agent.log";
+    bool log_async = true;
+    size_t log_queue_size = 8192;
+    std::string log_overflow = "drop_oldest";
+    int log_flush_s = 1;
     std::string interface;
     std::string device;
     std::string remote_addr;
     std::string local_addr;
     uint16_t remote_port = 5683;
     uint16_t local_port = 0;
+    int io_threads = 1;
+    std::vector<std::string> cache_ttl;
+    double client_rate = 0;
+    size_t client_burst = 2048;
+    size_t mtu = FORT_AGENT_BUFFER_UNIT_SZ;
+    int link_ping_ms = 100;
+    int link_silence_ms = 250;
+    int jaus_spin_us = 0;
+    double control_rate_hz = 50;
+    double wrench_rate_hz = 25;
+    std::string joystick_deadband = "0";
+    std::string joystick_hysteresis = "0";
+    int heartbeat_timeout_ms = 500;
 };
 
 po::options_description getFortAgentOptions(Configuration& config) {
@@ -43,11 +70,145 @@ po::options_description getFortAgentOptions(Configuration& config) {
         ("net,n", po::value<std::string>(&config.local_addr)->required(), "Local network interface")
         ("config,c", po::value<std::string>(), "Path to config file")
         ("log_file", po::value<std::string>(&config.log_file), "Log file path")
+        ("log_async", po::value<bool>(&config.log_async),
+            "Write the log file from a background thread instead of the logging thread")
+        ("log_queue_size", po::value<size_t>(&config.log_queue_size), "Log lines the async logger can queue")
+        ("log_overflow", po::value<std::string>(&config.log_overflow),
+            "When the async log queue is full: block, or drop_oldest line")
+        ("log_flush_s", po::value<int>(&config.log_flush_s),
+            "Seconds between flushes of the async log file")
+        ("io_threads", po::value<int>(&config.io_threads), "Number of threads running the IO service")
+        ("cache_ttl", po::value<std::vector<std::string>>(&config.cache_ttl)->composing(),
+            "Cache GET responses for a resource, as uri=seconds (repeatable)")
+        ("client_rate", po::value<double>(&config.client_rate),
+            "Serial link budget per UDP client in bytes/s, 0 to share the link evenly")
+        ("client_burst", po::value<size_t>(&config.client_burst), "Bytes a UDP client may burst above its rate")
+        ("mtu", po::value<size_t>(&config.mtu),
+            "Largest CoAP message in one UDP datagram or SLIP frame, must match the SRC Pro")
+        ("link_ping_ms", po::value<int>(&config.link_ping_ms),
+            "Milliseconds between CoAP pings of the SRC Pro, 0 disables link monitoring")
+        ("link_silence_ms", po::value<int>(&config.link_silence_ms),
+            "Milliseconds without serial RX before the link is reported silent")
+        ("jaus_spin_us", po::value<int>(&config.jaus_spin_us),
+            "Microseconds the JAUS thread polls for joystick input before sleeping")
+        ("control_rate_hz", po::value<double>(&config.control_rate_hz),
+            "Rate of the vehicle state machine's heartbeat and control checks")
+        ("wrench_rate_hz", po::value<double>(&config.wrench_rate_hz),
+            "Rate of SetWrenchEffort commands to the vehicle, at most control_rate_hz")
+        ("joystick_deadband", po::value<std::string>(&config.joystick_deadband),
+            "Raw counts around center read as zero, one value or six as lx,ly,lz,rx,ry,rz")
+        ("joystick_hysteresis", po::value<std::string>(&config.joystick_hysteresis),
+            "Raw counts an axis must move before a sample is forwarded, one value or six")
+        ("heartbeat_timeout_ms", po::value<int>(&config.heartbeat_timeout_ms),
+            "Milliseconds without a report from the vehicle before it is treated as lost")
         ;
 
     return desc;
 }
 
+UartCoapBridgeSettings getBridgeSettings(const Configuration& config) {
+    UartCoapBridgeSettings settings;
+
+    for (const auto& entry : config.cache_ttl) {
+        const auto split = entry.rfind('=');
+        if (split == std::string::npos || split == 0) {
+            throw std::runtime_error("cache_ttl must be uri=seconds, got '" + entry + "'");
+        }
+        settings.cacheTtls[entry.substr(0, split)] =
+            std::chrono::seconds(std::stol(entry.substr(split + 1)));
+    }
+
+    settings.clientRate = config.client_rate;
+    settings.clientBurst = config.client_burst;
+
+    // Room for a CoAP header, token and options at the bottom, a UDP payload at the top
+    if (config.mtu < 64 || config.mtu > 65507) {
+        throw std::runtime_error("mtu must be between 64 and 65507, got " + std::to_string(config.mtu));
+    }
+    settings.mtu = config.mtu;
+
+    // A ping is lost once the next one would be due twice over
+    settings.linkHealth.pingInterval = std::chrono::milliseconds(std::max(0, config.link_ping_ms));
+    settings.linkHealth.pingTimeout = 2 * settings.linkHealth.pingInterval;
+    settings.linkHealth.silenceThreshold = std::chrono::milliseconds(std::max(0, config.link_silence_ms));
+
+    return settings;
+}
+
+// One threshold for every axis, or one per axis as lx,ly,lz,rx,ry,rz, in raw counts
+std::array<uint16_t, JoystickFilter::axisCount> getJoystickThresholds(const std::string& name,
+                                                                      const std::string& value) {
+    std::vector<long> counts;
+    size_t start = 0;
+    while (start <= value.size()) {
+        const size_t end = std::min(value.find(',', start), value.size());
+        const std::string item = value.substr(start, end - start);
+        size_t used = 0;
+        long count = -1;
+        try {
+            count = std::stol(item, &used);
+        }
+        catch (std::exception&) {
+        }
+        if (used == 0 || item.find_first_not_of(' ', used) != std::string::npos ||
+            count < 0 || count > JOYSTICK_RAW_MAX) {
+            throw std::runtime_error(name + " must be raw counts between 0 and " +
+                                     std::to_string(JOYSTICK_RAW_MAX) + ", got '" + value + "'");
+        }
+        counts.push_back(count);
+        start = end + 1;
+    }
+    if (counts.size() != 1 && counts.size() != JoystickFilter::axisCount) {
+        throw std::runtime_error(name + " needs one value or " + std::to_string(JoystickFilter::axisCount) +
+                                 ", got '" + value + "'");
+    }
+
+    std::array<uint16_t, JoystickFilter::axisCount> thresholds;
+    for (size_t axis = 0; axis < thresholds.size(); axis++) {
+        thresholds[axis] = static_cast<uint16_t>(counts[counts.size() == 1 ? 0 : axis]);
+    }
+    return thresholds;
+}
+
+JausBridgeSettings getJausBridgeSettings(const Configuration& config) {
+    JausBridgeSettings settings;
+    settings.spinBeforeSleep = std::chrono::microseconds(std::max(0, config.jaus_spin_us));
+
+    if (!(config.control_rate_hz >= 1 && config.control_rate_hz <= 1000)) {
+        throw std::runtime_error("control_rate_hz must be between 1 and 1000, got " +
+                                 std::to_string(config.control_rate_hz));
+    }
+    settings.controlRateHz = config.control_rate_hz;
+
+    // Wrench efforts are sent from the control tick, so it can't stream any faster
+    if (!(config.wrench_rate_hz > 0 && config.wrench_rate_hz <= config.control_rate_hz)) {
+        throw std::runtime_error("wrench_rate_hz must be above 0 and at most control_rate_hz, got " +
+                                 std::to_string(config.wrench_rate_hz));
+    }
+    settings.wrenchRateHz = config.wrench_rate_hz;
+
+    settings.joystickFilter.deadband = getJoystickThresholds("joystick_deadband", config.joystick_deadband);
+    settings.joystickFilter.hysteresis = getJoystickThresholds("joystick_hysteresis", config.joystick_hysteresis);
+
+    // The vehicle is asked for four pulses per timeout, faster than 80 Hz is more than JAUS needs
+    if (config.heartbeat_timeout_ms < 50) {
+        throw std::runtime_error("heartbeat_timeout_ms must be at least 50, got " +
+                                 std::to_string(config.heartbeat_timeout_ms));
+    }
+    settings.heartbeatTimeout = std::chrono::milliseconds(config.heartbeat_timeout_ms);
+    return settings;
+}
+
+spdlog::async_overflow_policy getLogOverflowPolicy(const Configuration& config) {
+    if (config.log_overflow == "block") {
+        return spdlog::async_overflow_policy::block;
+    }
+    if (config.log_overflow == "drop_oldest") {
+        return spdlog::async_overflow_policy::overrun_oldest;
+    }
+    throw std::runtime_error("log_overflow must be block or drop_oldest, got '" + config.log_overflow + "'");
+}
+
 void setupDefaultLogger(const Configuration& config) {
     try {
         constexpr std::size_t max_file_size = 10 * 1024 * 1024; // 10 MB
@@ -57,14 +218,32 @@ void setupDefaultLogger(const Configuration& config) {
             config.log_file, max_file_size, max_files
         );
 
-        auto logger = std::make_shared<spdlog::logger>("fort_agent", file_sink);
+        std::shared_ptr<spdlog::logger> logger;
+        if (config.log_async) {
+            // One worker keeps the lines in order; the threads logging only queue a message
+            spdlog::init_thread_pool(config.log_queue_size, 1);
+            logger = std::make_shared<spdlog::async_logger>("fort_agent", file_sink, spdlog::thread_pool(),
+                                                            getLogOverflowPolicy(config));
+        } else {
+            logger = std::make_shared<spdlog::logger>("fort_agent", file_sink);
+        }
         spdlog::set_default_logger(logger);
 
         spdlog::level::level_enum level = spdlog::level::from_str(config.log_level);
         logger->set_level(level);
-        logger->flush_on(spdlog::level::info);
+        if (config.log_async) {
+            // Flushed by the worker, periodically and after anything that needs attention
+            logger->flush_on(spdlog::level::warn);
+            spdlog::flush_every(std::chrono::seconds(config.log_flush_s));
+        } else {
+            logger->flush_on(spdlog::level::info);
+        }
 
         spdlog::info("Logger initialized with level '{}' and file '{}'", config.log_level, config.log_file);
+        if (config.log_async) {
+            spdlog::info("Logging asynchronously, {} line queue, {} when full, flushed every {} s",
+                         config.log_queue_size, config.log_overflow, config.log_flush_s);
+        }
     }
     catch (const spdlog::spdlog_ex& ex) {
         std::cerr << "Logger setup failed: " << ex.what() << std::endl;
@@ -87,6 +266,8 @@ int main(int argc, char *argv[]) {
     Configuration config;
     po::options_description desc = getFortAgentOptions(config);
     po::variables_map vm;
+    UartCoapBridgeSettings bridgeSettings;
+    JausBridgeSettings jausSettings;
 
     try {
         // First: parse CLI
@@ -101,8 +282,21 @@ int main(int argc, char *argv[]) {
 
         // Apply all options
         po::notify(vm);
+        bridgeSettings = getBridgeSettings(config);
+        jausSettings = getJausBridgeSettings(config);
 
         // Now that config is populated, set up logging
+        if (config.log_async) {
+            getLogOverflowPolicy(config);
+            if (config.log_queue_size < 64) {
+                throw std::runtime_error("log_queue_size must be at least 64, got " +
+                                         std::to_string(config.log_queue_size));
+            }
+            if (config.log_flush_s < 1) {
+                throw std::runtime_error("log_flush_s must be at least 1, got " +
+                                         std::to_string(config.log_flush_s));
+            }
+        }
         setupDefaultLogger(config);
 
         // Handle help/version
@@ -127,21 +321,42 @@ int main(int argc, char *argv[]) {
     spdlog::info("Hosting CoAP server on {}:{}", config.local_addr, config.local_port);
     spdlog::info("FORT Agent starting up");
 
-    boost::asio::io_service ioService;
-
-    auto flushTimer = std::make_shared<boost::asio::steady_timer>(ioService);
+    // The reactor is fixed at build time (USE_IO_URING), but io_uring can still be unavailable at
+    // runtime (old kernel, kernel.io_uring_disabled), in which case the io_service can't be created
+    std::unique_ptr<boost::asio::io_service> ioServicePtr;
+    try {
+        ioServicePtr = std::make_unique<boost::asio::io_service>();
+    }
+    catch (const boost::system::system_error &e) {
+        spdlog::critical("Failed to initialize the {} I/O backend: {}", ioBackendName(), e.what());
+        spdlog::drop_all();
+        return 5;
+    }
+    boost::asio::io_service &ioService = *ioServicePtr;
+    spdlog::info("Using {} I/O backend", ioBackendName());
+
+    // The console has a thread of its own, and none at all when stdout isn't a terminal
+    const bool consoleIsTerminal = isatty(STDOUT_FILENO) == 1;
+    printToConsole.start(consoleIsTerminal, std::chrono::milliseconds(100));
+    if (!consoleIsTerminal) {
+        spdlog::info("stdout is not a terminal, console output disabled");
+    }
 
-    std::function<void()> scheduleFlush = [&]() {
-        flushTimer->expires_after(std::chrono::milliseconds(100));
-        flushTimer->async_wait([&](const boost::system::error_code& ec) {
-            if (!ec) {
-                printToConsole.flushConsoleMessages();
-                scheduleFlush(); // reschedule
-            }
+    // Periodic dump of transfer statistics and registered component counters
+    StatTrace statTrace(ioService);
+    if (consoleIsTerminal) {
+        StatTrace::addReporter([]() {
+            const ConsoleRenderer::Stats stats = printToConsole.stats();
+            spdlog::info("Console            : {} frames, {} dropped, {} coalesced, {} refreshes",
+                         stats.posted, stats.dropped, stats.coalesced, stats.refreshes);
         });
-    };
-
-    scheduleFlush(); // start the loop
+    }
+    if (config.log_async) {
+        StatTrace::addReporter([&config]() {
+            spdlog::info("Log queue          : {} lines dropped, {} line queue, {} when full",
+                         spdlog::thread_pool()->overrun_counter(), config.log_queue_size, config.log_overflow);
+        });
+    }
 
     try {
         // Initialize JAUS Bridge
@@ -157,19 +372,51 @@ int main(int argc, char *argv[]) {
         // Initialize UART-CoAP Bridge
         auto& uartCoapBridge = UartCoapBridgeSingleton::instance( 
             ioService, config.local_addr, config.local_port,
-            config.device, config.remote_addr, config.remote_port);
+            config.device, config.remote_addr, config.remote_port, bridgeSettings);
 
         // Start JAUS service loop, must be done after UartCoapBridge is initialized
-        jausBridge.startServiceLoop(); 
+        jausBridge.startServiceLoop(jausSettings);
        
-        // Start IO service loop
-        ioService.run();
+        // Start IO service loop.  Serial, UDP and CoAP tracking each run on their own strand, so
+        // extra threads let them proceed in parallel; the first thread to throw stops the others
+        // and the exception is rethrown here once they have all exited.
+        const int ioThreadCount = std::max(1, config.io_threads);
+        spdlog::info("Running IO service on {} thread(s)", ioThreadCount);
+
+        std::mutex ioFailureMutex;
+        std::exception_ptr ioFailure;
+        auto runIoService = [&]() {
+            try {
+                ioService.run();
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(ioFailureMutex);
+                if (!ioFailure) {
+                    ioFailure = std::current_exception();
+                }
+                ioService.stop();
+            }
+        };
+
+        std::vector<std::thread> ioThreads;
+        for (int i = 1; i < ioThreadCount; i++) {
+            ioThreads.emplace_back(runIoService);
+        }
+        runIoService();
+        for (auto &thread : ioThreads) {
+            thread.join();
+        }
+        if (ioFailure) {
+            std::rethrow_exception(ioFailure);
+        }
+        printToConsole.stop();
         return 0;
     }
     catch (std::runtime_error &e) {
         spdlog::critical("Stopping fort_agent due to fatal exception: {}",
                         e.what());
         ioService.stop();
+        printToConsole.stop();
         spdlog::drop_all();
         return 2;
     }
@@ -177,6 +424,7 @@ int main(int argc, char *argv[]) {
         spdlog::critical("Stopping fort_agent due to fatal exception: {}",
                         e.what());
         ioService.stop();
+        printToConsole.stop();
         spdlog::drop_all();
         return 3;
     }
@@ -184,6 +432,7 @@ int main(int argc, char *argv[]) {
         spdlog::critical(
             "Stopping fort_agent due to fatal but unknown exception");
         ioService.stop();
+        printToConsole.stop();
         spdlog::drop_all();
         return 4;
     }
@@ -0,0 +1,308 @@
+/* UDP echo benchmark for the Asio I/O backend.
+ *
+ * An echo server runs on its own io_service thread using the same pattern as the bridge's UDP side:
+ * async_wait(wait_read), then recvmmsg until the socket is drained and one sendmmsg per batch back.
+ * The main thread drives it with blocking round trips over loopback; --burst sends several
+ * datagrams per round trip so they can arrive as one batch.
+ * Build once with USE_IO_URING=OFF and once with USE_IO_URING=ON and compare:
+ *
+ *   - syscalls made by the reactor thread per round trip (needs perf_event access to the
+ *     raw_syscalls:sys_enter tracepoint, e.g. kernel.perf_event_paranoid <= 1 or CAP_PERFMON)
+ *   - kernel CPU time spent by the reactor thread per round trip
+ *   - round trip latency percentiles seen by the client
+ */
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <boost/asio.hpp>
+#include <fmt/format.h>
+
+#include <fort_agent/ioBackend.h>
+
+namespace {
+
+using boost::asio::ip::udp;
+
+struct Options {
+    size_t iterations = 20000;
+    size_t warmup = 1000;
+    size_t payload = 64;
+    size_t burst = 1;
+};
+
+Options parseOptions(int argc, char *argv[]) {
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string name = argv[i];
+        const size_t value = std::strtoul(argv[i + 1], nullptr, 10);
+        if (name == "--iterations") {
+            options.iterations = value;
+        } else if (name == "--warmup") {
+            options.warmup = value;
+        } else if (name == "--payload") {
+            options.payload = std::max<size_t>(1, std::min<size_t>(value, 1400));
+        } else if (name == "--burst") {
+            options.burst = std::max<size_t>(1, value);
+        } else {
+            fmt::print(stderr, "unknown option {}\n", name);
+            std::exit(1);
+        }
+    }
+    return options;
+}
+
+// Counts syscalls entered by the calling thread, or reports unavailable
+class SyscallCounter {
+public:
+    SyscallCounter() {
+        std::ifstream idFile("/sys/kernel/tracing/events/raw_syscalls/sys_enter/id");
+        if (!idFile) {
+            idFile.open("/sys/kernel/debug/tracing/events/raw_syscalls/sys_enter/id");
+        }
+        uint64_t id = 0;
+        if (!(idFile >> id)) {
+            return;
+        }
+
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_TRACEPOINT;
+        attr.size = sizeof(attr);
+        attr.config = id;
+        attr.disabled = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    ~SyscallCounter() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    bool available() const { return fd >= 0; }
+
+    void start() {
+        if (available()) {
+            ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    uint64_t stop() {
+        uint64_t count = 0;
+        if (available()) {
+            ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (::read(fd, &count, sizeof(count)) != sizeof(count)) {
+                count = 0;
+            }
+        }
+        return count;
+    }
+
+private:
+    int fd = -1;
+};
+
+std::chrono::microseconds threadSystemTime() {
+    rusage usage{};
+    ::getrusage(RUSAGE_THREAD, &usage);
+    return std::chrono::seconds(usage.ru_stime.tv_sec) +
+           std::chrono::microseconds(usage.ru_stime.tv_usec);
+}
+
+// Echoes every datagram back to its sender, mirroring UartCoapBridge::receiveFromRemote,
+// drainLocalSocket and sendBatchToRemote
+class EchoServer {
+public:
+    // UartCoapBridge::udpBatchSize
+    static constexpr size_t batchSize = 16;
+
+    explicit EchoServer(boost::asio::io_service &service) :
+        socket(service, udp::endpoint(boost::asio::ip::address_v4::loopback(), 0)) {
+        receive();
+    }
+
+    udp::endpoint endpoint() const { return socket.local_endpoint(); }
+
+    // Reactor thread only
+    double datagramsPerBatch() const { return batches == 0 ? 0 : static_cast<double>(datagrams) / batches; }
+
+private:
+    void receive() {
+        socket.async_wait(udp::socket::wait_read, [this](const boost::system::error_code &ec) {
+            if (ec) {
+                return;
+            }
+            drain();
+            receive();
+        });
+    }
+
+    void drain() {
+        while (true) {
+            for (size_t i = 0; i < batchSize; i++) {
+                iovs[i].iov_base = buffers[i].data();
+                iovs[i].iov_len = buffers[i].size();
+                msgs[i].msg_hdr = {};
+                msgs[i].msg_hdr.msg_name = &addrs[i];
+                msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+                msgs[i].msg_hdr.msg_iov = &iovs[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+                msgs[i].msg_len = 0;
+            }
+
+            const int received = ::recvmmsg(socket.native_handle(), msgs.data(), batchSize, MSG_DONTWAIT, nullptr);
+            if (received <= 0) {
+                return;
+            }
+            batches++;
+            datagrams += received;
+
+            // Send the batch back in place: same buffers, lengths and source addresses
+            for (int i = 0; i < received; i++) {
+                iovs[i].iov_len = msgs[i].msg_len;
+            }
+            const int sent = std::max(0, ::sendmmsg(socket.native_handle(), msgs.data(), received, MSG_DONTWAIT));
+            // The bridge hands leftovers to async_send_to; the buffers are reused here, so send them now
+            for (int i = sent; i < received; i++) {
+                udp::endpoint to;
+                std::memcpy(to.data(), &addrs[i], msgs[i].msg_hdr.msg_namelen);
+                to.resize(msgs[i].msg_hdr.msg_namelen);
+                boost::system::error_code ignored;
+                socket.send_to(boost::asio::buffer(buffers[i].data(), msgs[i].msg_len), to, 0, ignored);
+            }
+
+            if (static_cast<size_t>(received) < batchSize) {
+                return;  // socket drained
+            }
+        }
+    }
+
+    udp::socket socket;
+    std::array<std::array<uint8_t, 1500>, batchSize> buffers{};
+    std::array<sockaddr_storage, batchSize> addrs{};
+    std::array<iovec, batchSize> iovs{};
+    std::array<mmsghdr, batchSize> msgs{};
+    uint64_t batches = 0;
+    uint64_t datagrams = 0;
+};
+
+uint64_t percentile(const std::vector<uint64_t> &sorted, double pct) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    const size_t index = std::min(sorted.size() - 1,
+                                  static_cast<size_t>(pct / 100.0 * sorted.size()));
+    return sorted[index];
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    const Options options = parseOptions(argc, argv);
+
+    boost::asio::io_service service;
+    EchoServer server(service);
+
+    // Measurement window is opened and closed by the client; the reactor thread samples its own
+    // counters at those points since perf and rusage counters are per thread
+    std::atomic<int> phase{0};  // 0 warmup, 1 measuring, 2 done
+    uint64_t reactorSyscalls = 0;
+    std::chrono::microseconds reactorSystemTime{};
+    bool syscallsAvailable = false;
+
+    auto work = boost::asio::make_work_guard(service);
+    std::thread reactor([&]() {
+        SyscallCounter counter;
+        syscallsAvailable = counter.available();
+        bool measuring = false;
+        std::chrono::microseconds systemStart{};
+
+        while (!service.stopped()) {
+            service.run_one();
+            if (!measuring && phase.load() == 1) {
+                measuring = true;
+                systemStart = threadSystemTime();
+                counter.start();
+            } else if (measuring && phase.load() == 2) {
+                reactorSyscalls = counter.stop();
+                reactorSystemTime = threadSystemTime() - systemStart;
+                break;
+            }
+        }
+    });
+
+    udp::socket client(service, udp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+    const udp::endpoint target = server.endpoint();
+    std::vector<uint8_t> payload(options.payload, 0xA5);
+    std::vector<uint8_t> reply(1500);
+    std::vector<uint64_t> latenciesNs;
+    latenciesNs.reserve(options.iterations);
+
+    auto roundTrip = [&]() {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < options.burst; i++) {
+            client.send_to(boost::asio::buffer(payload), target);
+        }
+        for (size_t i = 0; i < options.burst; i++) {
+            client.receive(boost::asio::buffer(reply));
+        }
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    };
+
+    for (size_t i = 0; i < options.warmup; i++) {
+        roundTrip();
+    }
+
+    phase = 1;
+    const auto wallStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < options.iterations; i++) {
+        latenciesNs.push_back(roundTrip());
+    }
+    const auto wall = std::chrono::steady_clock::now() - wallStart;
+    phase = 2;
+
+    // one more round trip makes sure the reactor wakes up and sees the end of the window
+    roundTrip();
+    work.reset();
+    reactor.join();
+    service.stop();
+
+    std::sort(latenciesNs.begin(), latenciesNs.end());
+    const double trips = static_cast<double>(options.iterations);
+
+    fmt::print("backend            : {}\n", ioBackendName());
+    fmt::print("round trips        : {} x {} datagram(s) of {} bytes\n", options.iterations,
+               options.burst, options.payload);
+    fmt::print("throughput         : {:.0f} datagrams/s\n",
+               trips * options.burst / std::chrono::duration<double>(wall).count());
+    if (syscallsAvailable) {
+        fmt::print("reactor syscalls   : {:.2f} per round trip\n", reactorSyscalls / trips);
+    } else {
+        fmt::print("reactor syscalls   : n/a (perf_event_open on raw_syscalls:sys_enter not permitted)\n");
+    }
+    fmt::print("reactor system CPU : {:.2f} us per round trip\n", reactorSystemTime.count() / trips);
+    fmt::print("echo batches       : {:.2f} datagrams per recvmmsg\n", server.datagramsPerBatch());
+    fmt::print("latency us         : p50={:.1f} p99={:.1f} p99.9={:.1f} max={:.1f}\n",
+               percentile(latenciesNs, 50) / 1000.0, percentile(latenciesNs, 99) / 1000.0,
+               percentile(latenciesNs, 99.9) / 1000.0,
+               (latenciesNs.empty() ? 0 : latenciesNs.back()) / 1000.0);
+    return 0;
+}
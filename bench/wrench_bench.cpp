@@ -0,0 +1,132 @@
+/* Cost of building one SetWrenchEffort from a joystick sample, the agent's most frequent JAUS call.
+ *
+ * Times the three parts of JAUSClientImpl::sendWrenchEffort that run on the agent's side of
+ * component.sendMessage():
+ *
+ *   - normalizing the six axes with the original floating point formula
+ *   - normalizing them with the compile time joystickPercentTable
+ *   - allocating and filling the SetWrenchEffort message, and deleting it as OpenJAUS does
+ *
+ * Samples cycle through pseudo-random stick positions so the table lookups are not all cache hits
+ * on one line.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <openjaus/mobility_v1_1/PrimitiveDriver.h>
+
+#include <fort_agent/uart/FORTJoystick/FORTJoystickHelpers.h>
+
+namespace {
+
+using openjaus::mobility_v1_1::primitivedriver::SetWrenchEffort;
+
+struct Options {
+    size_t iterations = 2000000;
+    size_t samples = 1024;
+};
+
+Options parseOptions(int argc, char *argv[]) {
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string name = argv[i];
+        const size_t value = std::strtoul(argv[i + 1], nullptr, 10);
+        if (name == "--iterations") {
+            options.iterations = std::max<size_t>(1, value);
+        } else if (name == "--samples") {
+            options.samples = std::max<size_t>(1, value);
+        } else {
+            fmt::print(stderr, "unknown option {}\n", name);
+            std::exit(1);
+        }
+    }
+    return options;
+}
+
+// JAUSClientImpl::normalizeJoysticValue before the lookup table
+double legacyNormalize(int x) {
+    constexpr int min_raw = -2047;
+    constexpr int max_raw = 2047;
+    constexpr double min_norm = -100.0;
+    constexpr double max_norm = 100.0;
+
+    double scale = (max_norm - min_norm) / (max_raw - min_raw);
+    double midpoint_raw = (max_raw + min_raw) / 2.0;
+    double midpoint_norm = (max_norm + min_norm) / 2.0;
+
+    x = std::max(x, min_raw);
+    x = std::min(x, max_raw);
+    return midpoint_norm + (x - midpoint_raw) * scale;
+}
+
+template<typename Body>
+double nsPerCall(size_t iterations, Body body) {
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        body(i);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+           static_cast<double>(iterations);
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    const Options options = parseOptions(argc, argv);
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> axis(-JOYSTICK_RAW_MAX - 1, JOYSTICK_RAW_MAX);
+    std::vector<frc_joystick_data_t> samples(options.samples);
+    for (auto &sample : samples) {
+        for (jsCal_t *value : {&sample.leftXAxis, &sample.leftYAxis, &sample.leftZAxis,
+                               &sample.rightXAxis, &sample.rightYAxis, &sample.rightZAxis}) {
+            value->data = axis(rng);
+            value->dataOK = true;
+        }
+    }
+    auto sampleAt = [&](size_t i) -> const frc_joystick_data_t & { return samples[i % samples.size()]; };
+
+    volatile double sink = 0;
+    auto sixAxes = [&](const frc_joystick_data_t &data, auto normalize) {
+        sink = normalize(data.leftXAxis.data) + normalize(data.leftYAxis.data) + normalize(data.leftZAxis.data) +
+               normalize(data.rightXAxis.data) + normalize(data.rightYAxis.data) +
+               normalize(data.rightZAxis.data);
+    };
+
+    const double legacyNs = nsPerCall(options.iterations, [&](size_t i) {
+        sixAxes(sampleAt(i), legacyNormalize);
+    });
+    const double tableNs = nsPerCall(options.iterations, [&](size_t i) {
+        sixAxes(sampleAt(i), joystickPercent);
+    });
+    const double messageNs = nsPerCall(options.iterations / 10, [&](size_t i) {
+        const frc_joystick_data_t &data = sampleAt(i);
+        auto *message = new SetWrenchEffort();
+        auto &rec = message->getWrenchEffortRec();
+        rec.setPropulsiveLinearEffortX_percent(joystickPercent(data.leftXAxis.data));
+        rec.setPropulsiveLinearEffortY_percent(joystickPercent(data.leftYAxis.data));
+        rec.setPropulsiveLinearEffortZ_percent(joystickPercent(data.leftZAxis.data));
+        rec.setPropulsiveRotationalEffortX_percent(joystickPercent(data.rightXAxis.data));
+        rec.setPropulsiveRotationalEffortY_percent(joystickPercent(data.rightYAxis.data));
+        rec.setPropulsiveRotationalEffortZ_percent(joystickPercent(data.rightZAxis.data));
+        rec.disableResistiveLinearEffortX();
+        rec.disableResistiveLinearEffortY();
+        rec.disableResistiveLinearEffortZ();
+        rec.disableResistiveRotationalEffortX();
+        rec.disableResistiveRotationalEffortY();
+        rec.disableResistiveRotationalEffortZ();
+        delete message;
+    });
+
+    fmt::print("samples            : {} distinct, {} iterations\n", samples.size(), options.iterations);
+    fmt::print("normalize, formula : {:.1f} ns per six axes\n", legacyNs);
+    fmt::print("normalize, table   : {:.1f} ns per six axes\n", tableNs);
+    fmt::print("SetWrenchEffort    : {:.1f} ns to allocate, fill and free\n", messageNs);
+    return 0;
+}
@@ -0,0 +1,69 @@
+#ifndef FORT_AGENT_CLIENTADMISSION_H
+#define FORT_AGENT_CLIENTADMISSION_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/* Per-client token buckets in front of the serial link.
+ *
+ * Each UDP client (source port) gets a bucket refilled at its share of the link: the configured
+ * rate, or when that is zero the link rate divided by the number of clients that sent something in
+ * the last activeWindow.  A request is admitted when its client's bucket holds its length in bytes.
+ * Otherwise admit() returns how many seconds the client should wait, which the bridge sends back as
+ * a 5.03 Service Unavailable with that Max-Age instead of queueing the request.
+ *
+ * admit() must be called from one thread (the UDP strand); stats() is safe from any thread.
+ */
+class ClientAdmission {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    struct ClientStats {
+        uint16_t port;
+        uint64_t admitted;
+        uint64_t admittedBytes;
+        uint64_t rejected;
+    };
+
+    ClientAdmission(double linkBytesPerSecond, double clientBytesPerSecond, size_t burstBytes,
+                    std::chrono::milliseconds activeWindow = std::chrono::seconds(5));
+
+    // Returns 0 when the request may be forwarded, otherwise the seconds until it would be
+    uint32_t admit(uint16_t port, size_t length, Clock::time_point now = Clock::now());
+
+    std::vector<ClientStats> stats() const;
+
+private:
+    struct Client {
+        double tokens;
+        Clock::time_point refilled;
+        Clock::time_point lastSeen;
+        std::atomic<uint64_t> admitted{0};
+        std::atomic<uint64_t> admittedBytes{0};
+        std::atomic<uint64_t> rejected{0};
+    };
+
+    Client &client(uint16_t port, Clock::time_point now);
+
+    double shareFor(Clock::time_point now);
+
+    const double linkRate;
+    const double clientRate;
+    const double burst;
+    const Clock::duration window;
+
+    // Only the admitting thread inserts or erases, under clientsMutex so stats() can read
+    mutable std::mutex clientsMutex;
+    std::unordered_map<uint16_t, std::unique_ptr<Client>> clients;
+
+    size_t activeClients;
+    Clock::time_point activeCounted;
+};
+
+#endif //FORT_AGENT_CLIENTADMISSION_H
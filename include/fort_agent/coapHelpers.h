@@ -5,8 +5,10 @@
 #include <chrono>
 #include <cstdint>
 #include <exception>
+#include <functional>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #include <fort_agent/dbgTrace.h>
 
@@ -82,8 +84,68 @@ namespace Coap {
     // Parse reply
     CoapReply parseObserveReply(const uint8_t* buffer, size_t len);
 
+    // One option as it appears on the wire, value points into the message buffer
+    struct Option {
+        uint16_t number;
+        const uint8_t *value;
+        size_t length;
+    };
+
+    // Call fn for each option in order and return the offset of the payload (len if there is none).
+    // Throws a CoapException if an option runs past the end of the buffer.
+    size_t forEachOption(const uint8_t *buffer, size_t len,
+                         const std::function<void(const Option &)> &fn);
+
+    uint32_t decodeUintOption(const Option &option);
+
+    // Zero-copy view of a parsed message, only valid while the underlying buffer is
+    struct MessageView {
+        Type type;
+        uint8_t code;
+        uint16_t mid;
+        const uint8_t *token;
+        size_t tokenLength;
+        bool hasObserve;
+        uint32_t observe;
+        Format contentFormat;   // NONE when the option is absent
+        uint32_t maxAge;        // 60 when the option is absent (RFC 7252 5.10.5)
+        const uint8_t *payload;
+        size_t payloadLength;
+    };
+
+    // Throws a CoapException if the buffer is not valid CoAP
+    MessageView parseMessage(const uint8_t *buffer, size_t len);
+
+    // Identity of a request for caching and collapsing: the code, Uri-Path, Uri-Query and the other
+    // cache-key options (RFC 7252 5.4.6).  Observe is reported separately and not part of the key.
+    struct RequestKey {
+        std::string key;    // compare this
+        std::string uri;    // "cfg/setup/serialNumber", "deviceInfo?fwVersion"
+        std::string path;   // uri without the query
+        bool observe;
+    };
+
+    // Throws a CoapException if the buffer is not valid CoAP
+    RequestKey requestKey(const uint8_t *buffer, size_t len);
+
+    // Identifies one exchange with a UDP client: the client port plus the message token, or the MID
+    // when there is no token (only a piggybacked response can then be matched)
+    std::string exchangeKey(uint16_t port, const uint8_t *buffer);
+
+    // Append one option in delta encoding, options must be appended in ascending number order
+    void appendOption(std::vector<uint8_t> &out, uint16_t number, const uint8_t *value,
+                      size_t length, uint16_t &lastNumber);
+
+    void appendUintOption(std::vector<uint8_t> &out, uint16_t number, uint32_t value,
+                          uint16_t &lastNumber);
+
     std::array<uint8_t, 4> createResetMsg(uint16_t mid);
 
+    // Build a 5.03 Service Unavailable answering request into out, which must hold
+    // COAP_TOKEN_START_INDEX + COAP_TOKEN_MAX_LEN + 6 bytes.  Max-Age tells the client when to try
+    // again.  Returns its length.
+    size_t createServiceUnavailable(const uint8_t *request, uint32_t maxAge, uint8_t *out);
+
     // Definitions
     constexpr auto midTimeoutTime = std::chrono::seconds(
         250); /* CoAP RFC 7252 4.8.2 max exchange lifetime == 247s */
@@ -91,6 +153,28 @@ namespace Coap {
     constexpr size_t COAP_TOKEN_MAX_LEN = 8;
     constexpr size_t COAP_TOKEN_START_INDEX = 4;
 
+    // Fixed-size counterparts of requestKey and exchangeKey for the hot paths that must not allocate
+
+    // 64-bit FNV-1a over the code and the number, length and value of every cache-key option
+    struct RequestHash {
+        uint64_t value;
+        bool observe;
+    };
+
+    // Throws a CoapException if the buffer is not valid CoAP
+    RequestHash requestHash(const uint8_t *buffer, size_t len);
+
+    struct ExchangeId {
+        uint16_t port;
+        uint8_t tokenLength;                            // 0 when bytes holds the MID
+        std::array<uint8_t, COAP_TOKEN_MAX_LEN> bytes;  // unused bytes are zero
+
+        bool operator==(const ExchangeId &other) const {
+            return port == other.port && tokenLength == other.tokenLength && bytes == other.bytes;
+        }
+    };
+
+    ExchangeId exchangeId(uint16_t port, const uint8_t *buffer);
 
 }
 
@@ -0,0 +1,113 @@
+#ifndef FORT_AGENT_COAPOBSERVEHUB_H
+#define FORT_AGENT_COAPOBSERVEHUB_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fort_agent/coapHelpers.h>
+
+/* Shares one device-side Observe relationship per resource among any number of UDP observers.
+ *
+ * The first Observe registration (GET with Observe=0) for a resource is rewritten with a token the
+ * hub owns and sent to the device from hubPort.  Later registrations for the same resource are
+ * added to the hub's observer list and answered right away with the latest notification.  Every
+ * notification the device sends to hubPort crosses the serial link once and is replicated locally
+ * to each observer with that observer's token, as a NON with a MID from the hub.  CON
+ * notifications are acknowledged to the device by the hub.
+ *
+ * Observers leave with a GET Observe=1 or by answering a notification with RST.  When the last
+ * one leaves, the device-side registration is cancelled.  A notification with an error code ends
+ * the subscription for everyone.
+ *
+ * Not thread safe: call from the UDP strand.
+ */
+class CoapObserveHub {
+public:
+    // Pseudo client port used for the hub's own exchanges with the device; never a real UDP port
+    static constexpr uint16_t hubPort = 0;
+
+    typedef std::function<void(uint16_t port, const std::vector<uint8_t> &message)> EmitFn;
+
+    struct Stats {
+        size_t subscriptions;
+        size_t observers;
+        uint64_t notifications;     // received from the device
+        uint64_t replicated;        // sent to observers
+        uint64_t registrationsShared;  // registrations served without a new device subscription
+    };
+
+    explicit CoapObserveHub(size_t maxObserversPerResource = 32);
+
+    // Handles Observe registrations/deregistrations and RSTs to hub notifications.  Returns true
+    // when the message was consumed; toClient and toDevice receive any messages to send.
+    bool onRequest(uint16_t port, const uint8_t *msg, size_t len, const EmitFn &toClient,
+                   const EmitFn &toDevice);
+
+    // Handles a message the device addressed to hubPort
+    void onDeviceMessage(const uint8_t *msg, size_t len, const EmitFn &toClient, const EmitFn &toDevice);
+
+    Stats stats() const;
+
+private:
+    struct Observer {
+        uint16_t port;
+        std::array<uint8_t, Coap::COAP_TOKEN_MAX_LEN> token;
+        uint8_t tokenLength;
+        Coap::Type requestType;
+        uint16_t requestMid;
+        bool answered;      // has received at least one message from the hub
+        uint16_t lastMid;   // MID of the last notification sent, for matching RSTs
+
+        bool is(uint16_t p, const uint8_t *t, uint8_t tl) const;
+    };
+
+    struct Subscription {
+        std::string key;                    // Coap::requestKey of the registration
+        std::vector<uint8_t> request;       // the first client's registration
+        std::vector<Observer> observers;
+        std::vector<uint8_t> latest;        // last notification from the device, empty until answered
+    };
+
+    typedef std::unordered_map<std::string, Subscription>::iterator SubscriptionIt;
+
+    static Observer observerFor(uint16_t port, const Coap::MessageView &view);
+
+    // Copy of a device message for one observer: the observer's token, a MID from the hub (or the
+    // request's MID for the ACK to a CON registration) and the device's options and payload
+    void send(Observer &observer, const std::vector<uint8_t> &message, bool keepObserve,
+              const EmitFn &toClient);
+
+    // The registration in sub.request re-addressed to the device under the hub token
+    std::vector<uint8_t> deviceRequest(const Subscription &sub, const std::string &token,
+                                       uint32_t observeValue, Coap::Type type, uint16_t mid) const;
+
+    // Drops a subscription, cancelling it on the device with a CON Observe=1 unless handed off
+    void endSubscription(SubscriptionIt sub, bool cancelOnDevice, const EmitFn &toDevice);
+
+    std::string nextToken();
+
+    void updateCounts();
+
+    const size_t observerLimit;
+
+    std::unordered_map<std::string, Subscription> subscriptions;    // by hub token
+    std::unordered_map<std::string, std::string> byKey;             // request key -> hub token
+    std::unordered_map<std::string, Observer> closing;              // hub token -> deregistering client
+    uint16_t tokenCounter;
+    uint16_t midCounter;
+    std::vector<uint8_t> scratch;
+
+    std::atomic<size_t> subscriptionCount{0};
+    std::atomic<size_t> observerCount{0};
+    std::atomic<uint64_t> notifications{0};
+    std::atomic<uint64_t> replicated{0};
+    std::atomic<uint64_t> shared{0};
+};
+
+#endif //FORT_AGENT_COAPOBSERVEHUB_H
@@ -12,6 +12,7 @@
 #include <boost/asio.hpp>
 
 #include <fort_agent/dbgTrace.h>
+#include <fort_agent/timedStrand.h>
 
 class MappedMid {
 public:
@@ -35,6 +36,9 @@ public:
  *
  * Port/MID mappings can be overwritten by newer messages with the same MID but different port, and
  * expire after midTImeoutTime.
+ *
+ * The MID map is not locked: udpToSerial, serialToUdp and clear must be called on strand(), which
+ * is also where the expiry timer runs.
  */
 
 class CoapPortTracker {
@@ -55,6 +59,8 @@ public:
 
     void clear();
 
+    TimedStrand &strand() { return trackerStrand; }
+
 private:
     const uint16_t defaultPort;
 
@@ -67,6 +73,7 @@ private:
     void trackMid(uint16_t port, uint16_t mid);
 
     std::map<uint16_t, MappedMid> mids;
+    TimedStrand trackerStrand;
     boost::asio::steady_timer midExpirationTimer;
 public:
     // Debug helper
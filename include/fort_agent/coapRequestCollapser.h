@@ -0,0 +1,94 @@
+#ifndef FORT_AGENT_COAPREQUESTCOLLAPSER_H
+#define FORT_AGENT_COAPREQUESTCOLLAPSER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <fort_agent/coapHelpers.h>
+
+/* Collapses identical GETs from different UDP clients into one serial exchange.
+ *
+ * The first GET for a given Coap::requestHash is the leader and goes to the device as usual.  While
+ * it is outstanding, onRequest() parks identical GETs from other exchanges instead of forwarding
+ * them.  When the leader's response comes back through onResponse(), a copy is emitted for every
+ * parked request with that request's own MID and token restored: an ACK for a CON request answered
+ * by a piggybacked response, a NON otherwise.
+ *
+ * A leader that has not been answered within leaderTimeout is abandoned; its parked requests are
+ * dropped and the clients' own retransmissions start a new exchange.  Retransmissions of the
+ * leader itself are always forwarded, and duplicates of a parked request are absorbed.
+ *
+ * Requests are keyed by Coap::requestHash and Coap::ExchangeId in a table of maxInFlight slots
+ * reserved up front, so a GET that is not collapsed allocates nothing.  When every slot holds a
+ * live leader, new GETs are forwarded without being tracked.
+ *
+ * Observe registrations are not collapsed.  Not thread safe: call from the UDP strand.
+ */
+class CoapRequestCollapser {
+public:
+    typedef std::function<void(uint16_t port, const std::vector<uint8_t> &message)> EmitFn;
+
+    struct Stats {
+        uint64_t forwarded;     // GETs sent to the device as a leader
+        uint64_t collapsed;     // GETs parked behind a leader instead of being sent
+        uint64_t fannedOut;     // responses copied to parked clients
+        uint64_t abandoned;     // parked GETs dropped because their leader timed out
+        size_t inFlight;
+    };
+
+    explicit CoapRequestCollapser(std::chrono::milliseconds leaderTimeout = std::chrono::seconds(2),
+                                  size_t maxWaiters = 32, size_t maxInFlight = 128);
+
+    // Returns true when the request has been parked and must not be forwarded
+    bool onRequest(uint16_t port, const uint8_t *msg, size_t len);
+
+    // Emits a copy of a leader's response for each parked request
+    void onResponse(uint16_t port, const uint8_t *msg, size_t len, const EmitFn &emit);
+
+    Stats stats() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Waiter {
+        uint16_t port;
+        Coap::Type type;
+        uint16_t mid;
+        std::array<uint8_t, Coap::COAP_TOKEN_MAX_LEN> token;
+        uint8_t tokenLength;
+    };
+
+    struct InFlight {
+        uint64_t request;       // Coap::requestHash of the forwarded request
+        Coap::ExchangeId leader;
+        Clock::time_point sent;
+        std::vector<Waiter> waiters;
+    };
+
+    void abandon(InFlight &flight);
+
+    // Swaps the last flight into the freed slot, so flights stays packed
+    void remove(std::vector<InFlight>::iterator it);
+
+    void pruneStale(Clock::time_point now);
+
+    const std::chrono::milliseconds timeout;
+    const size_t waiterLimit;
+    const size_t flightLimit;
+
+    std::vector<InFlight> flights;  // capacity reserved for flightLimit
+    std::vector<uint8_t> scratch;
+
+    std::atomic<uint64_t> forwarded{0};
+    std::atomic<uint64_t> collapsed{0};
+    std::atomic<uint64_t> fannedOut{0};
+    std::atomic<uint64_t> abandoned{0};
+    std::atomic<size_t> inFlightCount{0};
+};
+
+#endif //FORT_AGENT_COAPREQUESTCOLLAPSER_H
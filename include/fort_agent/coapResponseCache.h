@@ -0,0 +1,91 @@
+#ifndef FORT_AGENT_COAPRESPONSECACHE_H
+#define FORT_AGENT_COAPRESPONSECACHE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fort_agent/coapHelpers.h>
+
+/* Caching proxy for GET requests from UDP clients.
+ *
+ * onRequest() sees every request a client sends to the bridge.  A GET for a resource with a fresh
+ * cached response is answered from the cache with the client's own MID and token, and never
+ * reaches the serial link.  Other GETs are remembered by (port, token) so that onResponse(), which
+ * sees every message going back to a client, can store the device's 2.05 Content reply.  A POST,
+ * PUT or DELETE to a path drops every cached response for that path, and the answers to GETs for
+ * it still in flight are passed on without being stored.
+ *
+ * A response is cached for the per-resource TTL from the configuration if there is one, otherwise
+ * for its Max-Age when the device sent that option explicitly.  Responses with neither are never
+ * cached, so resources that change quickly (joystick, safety) stay pass-through.  Observe requests
+ * are never served from or stored into the cache.
+ *
+ * Not thread safe: both calls must come from the UDP strand.  stats() may be read from any thread.
+ */
+class CoapResponseCache {
+public:
+    typedef std::map<std::string, std::chrono::seconds> TtlMap;
+
+    struct Stats {
+        uint64_t lookups;       // cacheable GETs seen
+        uint64_t hits;          // of those, answered from the cache
+        uint64_t stores;        // responses stored
+        uint64_t invalidations; // entries dropped because of a POST/PUT/DELETE
+        size_t entries;
+    };
+
+    explicit CoapResponseCache(TtlMap resourceTtls = {}, size_t maxEntries = 64);
+
+    // Returns true and fills reply when the request can be answered from the cache
+    bool onRequest(uint16_t port, const uint8_t *msg, size_t len, std::vector<uint8_t> &reply);
+
+    void onResponse(uint16_t port, const uint8_t *msg, size_t len);
+
+    Stats stats() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Entry {
+        std::string path;
+        uint8_t code;
+        std::vector<std::pair<uint16_t, std::vector<uint8_t>>> options;  // without Max-Age
+        std::vector<uint8_t> payload;
+        Clock::time_point expires;
+    };
+
+    struct PendingGet {
+        std::string key;
+        std::string uri;
+        std::string path;
+        Clock::time_point sent;
+    };
+
+    void buildReply(const Entry &entry, const Coap::MessageView &request,
+                    std::vector<uint8_t> &reply) const;
+
+    void invalidate(const std::string &path);
+
+    void evictOne();
+
+    const TtlMap ttls;
+    const size_t capacity;
+
+    std::unordered_map<std::string, Entry> entries;
+    std::unordered_map<std::string, PendingGet> pending;
+
+    std::atomic<uint64_t> lookups{0};
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> stores{0};
+    std::atomic<uint64_t> invalidations{0};
+    std::atomic<size_t> entryCount{0};
+};
+
+#endif //FORT_AGENT_COAPRESPONSECACHE_H
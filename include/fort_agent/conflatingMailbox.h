@@ -0,0 +1,50 @@
+#ifndef FORT_AGENT_CONFLATINGMAILBOX_H
+#define FORT_AGENT_CONFLATINGMAILBOX_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/* Single-slot mailbox where the latest value wins, between one producer and one consumer thread.
+ *
+ * This is a triple buffer.  The producer writes into its own slot and swaps it with the shared
+ * middle slot.  The consumer swaps the middle slot for its own only when a fresh value is there.
+ * Neither side waits for the other or allocates.  A value the consumer has not taken yet is
+ * overwritten by the next publish(), which reports the conflation so the caller can count it.
+ */
+template<typename T>
+class ConflatingMailbox {
+public:
+    // Producer only.  Returns false when this replaced a value the consumer never took.
+    bool publish(const T &value) {
+        slots[back] = value;
+        const uint8_t previous = middle.exchange(static_cast<uint8_t>(back | freshBit), std::memory_order_acq_rel);
+        back = previous & indexMask;
+        return (previous & freshBit) == 0;
+    }
+
+    // Consumer only.  False when nothing was published since the last take().
+    bool take(T &value) {
+        if ((middle.load(std::memory_order_relaxed) & freshBit) == 0) {
+            return false;
+        }
+        const uint8_t previous = middle.exchange(front, std::memory_order_acq_rel);
+        front = previous & indexMask;
+        value = slots[front];
+        return true;
+    }
+
+    bool hasNew() const { return (middle.load(std::memory_order_acquire) & freshBit) != 0; }
+
+private:
+    static constexpr uint8_t indexMask = 0x03;
+    static constexpr uint8_t freshBit = 0x04;
+    static constexpr size_t cacheLine = 64;
+
+    alignas(cacheLine) std::atomic<uint8_t> middle{1};
+    alignas(cacheLine) uint8_t back = 0;     // producer's slot
+    alignas(cacheLine) uint8_t front = 2;    // consumer's slot
+    alignas(cacheLine) std::array<T, 3> slots{};
+};
+
+#endif //FORT_AGENT_CONFLATINGMAILBOX_H
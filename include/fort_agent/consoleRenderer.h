@@ -0,0 +1,84 @@
+#ifndef FORT_AGENT_CONSOLERENDERER_H
+#define FORT_AGENT_CONSOLERENDERER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <fort_agent/mpscRing.h>
+
+/* Console output written by a thread of its own, so a slow terminal or a stdout pipe nobody reads
+ * never holds up the threads producing the text.
+ *
+ * Callers hand over whole frames.  post() queues a frame to be printed once, in order; when the
+ * queue is full the frame is dropped and counted instead of waiting.  show() replaces the
+ * full-screen status frame, of which only the latest is printed, so a burst of updates between two
+ * refreshes is coalesced.  The view set with setView() is rendered by the console thread on every
+ * refresh, for text that is cheaper to build from the latest state than to queue.
+ *
+ * Until start() is called with output enabled, e.g. when stdout is not a terminal, post() and
+ * show() discard frames at once and enabled() tells producers not to build them.
+ */
+class ConsoleRenderer {
+public:
+    struct Stats {
+        uint64_t posted;        // frames queued by post()
+        uint64_t dropped;       // frames dropped because the queue was full
+        uint64_t coalesced;     // show() frames replaced before they were printed
+        uint64_t refreshes;     // refreshes that wrote anything
+    };
+
+    static constexpr size_t queueCapacity = 64;
+
+    explicit ConsoleRenderer(std::ostream &out);
+    ~ConsoleRenderer();
+
+    // Any thread.  False if the frame was dropped.
+    bool post(std::string frame);
+    // Any thread.  Replace the status frame, printed with the next refresh.
+    void show(std::string frame);
+    // Any thread, rendered by the console thread after the queued frames
+    void setView(std::function<std::string()> view);
+
+    // Start the console thread refreshing every interval, or discard all output if !enable
+    void start(bool enable, std::chrono::milliseconds interval);
+    // Print what is still queued and join the console thread
+    void stop();
+
+    bool enabled() const { return active.load(std::memory_order_relaxed); }
+
+    Stats stats() const;
+
+private:
+    std::ostream &out;
+    std::atomic<bool> active{false};
+    MpscRing<std::string, queueCapacity> queue;
+    // Latest show() frame, swapped in and out through the atomic shared_ptr functions
+    std::shared_ptr<std::string> screen;
+
+    std::thread thread;
+    std::mutex wakeMutex;
+    std::function<std::string()> view;  // guarded by wakeMutex
+    std::condition_variable wake;
+    bool running = false;
+
+    std::atomic<uint64_t> postedCount{0};
+    std::atomic<uint64_t> droppedCount{0};
+    std::atomic<uint64_t> coalescedCount{0};
+    std::atomic<uint64_t> refreshCount{0};
+
+    void run(std::chrono::milliseconds interval);
+    void refresh(const std::function<std::string()> &render);
+};
+
+// The agent's console, on stdout
+extern ConsoleRenderer printToConsole;
+
+#endif //FORT_AGENT_CONSOLERENDERER_H
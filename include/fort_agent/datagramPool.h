@@ -0,0 +1,122 @@
+#ifndef FORT_AGENT_DATAGRAMPOOL_H
+#define FORT_AGENT_DATAGRAMPOOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+class DatagramPool;
+
+/* One datagram sized buffer.  Slots live inside the slab owned by a DatagramPool and are only
+ * handed out through DatagramPtr, which keeps an intrusive reference count in the slot itself so
+ * a buffer can be captured by several asio handlers without a shared_ptr control block.
+ */
+class DatagramSlot {
+public:
+    uint8_t *data() { return storage; }
+
+    const uint8_t *data() const { return storage; }
+
+    size_t capacity() const { return size; }
+
+private:
+    friend class DatagramPool;
+    friend class DatagramPtr;
+
+    DatagramPool *pool = nullptr;  // nullptr when heap allocated because the pool was exhausted
+    std::atomic<uint32_t> refs{0};
+    uint8_t *storage = nullptr;
+    size_t size = 0;
+};
+
+/* Reference counted handle to a DatagramSlot, returned to its pool when the last copy goes away */
+class DatagramPtr {
+public:
+    DatagramPtr() = default;
+
+    DatagramPtr(const DatagramPtr &other) : slot(other.slot) { retain(); }
+
+    DatagramPtr(DatagramPtr &&other) noexcept : slot(other.slot) { other.slot = nullptr; }
+
+    DatagramPtr &operator=(DatagramPtr other) noexcept {
+        std::swap(slot, other.slot);
+        return *this;
+    }
+
+    ~DatagramPtr() { reset(); }
+
+    void reset();
+
+    uint8_t *data() const { return slot->data(); }
+
+    size_t capacity() const { return slot->capacity(); }
+
+    explicit operator bool() const { return slot != nullptr; }
+
+private:
+    friend class DatagramPool;
+
+    explicit DatagramPtr(DatagramSlot *s) : slot(s) { retain(); }
+
+    void retain() {
+        if (slot != nullptr) {
+            slot->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    DatagramSlot *slot = nullptr;
+};
+
+struct DatagramPoolStats {
+    size_t capacity;        // number of slab buffers
+    size_t bufferSize;      // bytes per buffer
+    size_t inUse;           // slab buffers currently handed out
+    size_t highWater;       // most slab buffers ever handed out at once
+    uint64_t acquired;      // total successful acquisitions from the slab
+    uint64_t exhausted;     // acquisitions that found the slab empty and fell back to the heap
+};
+
+/* Fixed-size slab of datagram buffers shared by the UDP and serial forwarding paths.
+ *
+ * All buffers are allocated once at construction.  acquire() pops a free slot and release (via
+ * the last DatagramPtr going out of scope) pushes it back, so steady-state forwarding does no
+ * heap allocation.  If every slot is in flight acquire() still succeeds with a one-off heap
+ * buffer, which is counted as an exhaustion so the pool can be resized.
+ */
+class DatagramPool {
+public:
+    DatagramPool(size_t bufferSize, size_t bufferCount);
+
+    DatagramPool(const DatagramPool &) = delete;
+
+    DatagramPool &operator=(const DatagramPool &) = delete;
+
+    DatagramPtr acquire();
+
+    size_t bufferSize() const { return size; }
+
+    DatagramPoolStats stats() const;
+
+private:
+    friend class DatagramPtr;
+
+    void release(DatagramSlot *slot);
+
+    const size_t size;
+    const size_t count;
+
+    std::unique_ptr<uint8_t[]> slab;
+    std::unique_ptr<DatagramSlot[]> slots;
+
+    mutable std::mutex freeMutex;
+    std::vector<DatagramSlot *> freeList;
+    size_t highWater;
+    uint64_t acquired;
+    uint64_t exhausted;
+};
+
+#endif //FORT_AGENT_DATAGRAMPOOL_H
@@ -1,6 +1,10 @@
 #ifndef FORT_AGENT_DBG_TRACE_H
 #define FORT_AGENT_DBG_TRACE_H
 
+#include <atomic>
+#include <functional>
+#include <vector>
+
 #include <boost/asio.hpp>
 #include <spdlog/spdlog.h>
 
@@ -43,11 +47,16 @@ public:
 };
 
 class StatTrace {
-    inline static int RequestsToEpc;
-    inline static int RequestsToNsc;
+    // Counted on the CoAP tracker strand and read by the stats timer, which may run on another
+    // io thread
+    inline static std::atomic<int> RequestsToEpc{0};
+    inline static std::atomic<int> RequestsToNsc{0};
+
+    inline static std::atomic<int> ResponsesFromEpc{0};
+    inline static std::atomic<int> ResponsesFromNsc{0};
 
-    inline static int ResponsesFromEpc;
-    inline static int ResponsesFromNsc;
+    // Components with their own counters register here to be included in the periodic dump
+    inline static std::vector<std::function<void()>> reporters;
 
 public:
     StatTrace(boost::asio::io_service &service) :
@@ -60,27 +69,36 @@ public:
     static constexpr int statTracePeriodSeconds = 10;
 
     static void DisplayAllData() {
-        spdlog::info("Requests To Epc    : {}", RequestsToEpc);
-        spdlog::info("Requests To Nsc    : {}", RequestsToNsc);
-        spdlog::info("Responses From Epc : {}", ResponsesFromEpc);
-        spdlog::info("Responses From Nsc : {}", ResponsesFromNsc);
+        spdlog::info("Requests To Epc    : {}", RequestsToEpc.load(std::memory_order_relaxed));
+        spdlog::info("Requests To Nsc    : {}", RequestsToNsc.load(std::memory_order_relaxed));
+        spdlog::info("Responses From Epc : {}", ResponsesFromEpc.load(std::memory_order_relaxed));
+        spdlog::info("Responses From Nsc : {}", ResponsesFromNsc.load(std::memory_order_relaxed));
+
+        for (const auto &reporter : reporters) {
+            reporter();
+        }
+    }
+
+    // Must be called during start-up, before the io_service begins running
+    static void addReporter(std::function<void()> reporter) {
+        reporters.push_back(std::move(reporter));
     }
 
     static void resetStats() {
-        RequestsToEpc = 0;
-        RequestsToNsc = 0;
-        ResponsesFromEpc = 0;
-        ResponsesFromNsc = 0;
+        RequestsToEpc.exchange(0, std::memory_order_relaxed);
+        RequestsToNsc.exchange(0, std::memory_order_relaxed);
+        ResponsesFromEpc.exchange(0, std::memory_order_relaxed);
+        ResponsesFromNsc.exchange(0, std::memory_order_relaxed);
     }
 
 
-    static void incrementRequestsToEpc() { RequestsToEpc++; };
+    static void incrementRequestsToEpc() { RequestsToEpc.fetch_add(1, std::memory_order_relaxed); };
 
-    static void incrementRequestsToNsc() { RequestsToNsc++; };
+    static void incrementRequestsToNsc() { RequestsToNsc.fetch_add(1, std::memory_order_relaxed); };
 
-    static void incrementResponsesFromEpc() { ResponsesFromEpc++; };
+    static void incrementResponsesFromEpc() { ResponsesFromEpc.fetch_add(1, std::memory_order_relaxed); };
 
-    static void incrementResponsesFromNsc() { ResponsesFromNsc++; };
+    static void incrementResponsesFromNsc() { ResponsesFromNsc.fetch_add(1, std::memory_order_relaxed); };
 
     void printStats() {
         DisplayAllData();
@@ -0,0 +1,80 @@
+#ifndef FORT_AGENT_FAIRSCHEDULER_H
+#define FORT_AGENT_FAIRSCHEDULER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <fort_agent/datagramPool.h>
+
+/* Deficit round robin over the frames waiting for the serial link, one queue per client port.
+ *
+ * Each client with queued frames gets quantumBytes of credit per round and sends frames while its
+ * credit covers them, so a client with a deep queue cannot hold the link while others wait.  Frames
+ * are only taken when the serial handler has room for them, keeping the ordering decision here
+ * instead of in the serial TX buffer.  A client's queue is bounded; enqueue() refuses frames past
+ * that and counts them as dropped.
+ *
+ * enqueue() and next() must be called from one thread (the serial strand); stats() is safe from
+ * any thread.
+ */
+class FairScheduler {
+public:
+    struct Frame {
+        uint16_t port;
+        DatagramPtr data;
+        size_t length;
+    };
+
+    struct ClientStats {
+        uint16_t port;
+        uint64_t frames;    // sent to the serial link
+        uint64_t bytes;
+        uint64_t dropped;   // refused because the client's queue was full
+        size_t queued;
+    };
+
+    explicit FairScheduler(size_t quantumBytes = 256, size_t maxQueuedPerClient = 16);
+
+    // Returns false, leaving data with the caller, when the client already has maxQueuedPerClient
+    // waiting
+    bool enqueue(uint16_t port, DatagramPtr &&data, size_t length);
+
+    // Pops the next frame in round robin order if fits(length) says the link can take it
+    bool next(const std::function<bool(size_t length)> &fits, Frame &out);
+
+    bool empty() const { return active.empty(); }
+
+    std::vector<ClientStats> stats() const;
+
+private:
+    struct Client {
+        std::deque<Frame> queue;
+        size_t deficit = 0;
+        bool inTurn = false;
+        std::atomic<uint64_t> frames{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<size_t> queued{0};
+    };
+
+    Client &client(uint16_t port);
+
+    const size_t quantum;
+    const size_t queueLimit;
+
+    // Only the scheduling thread inserts or erases, under clientsMutex so stats() can read
+    mutable std::mutex clientsMutex;
+    std::unordered_map<uint16_t, std::unique_ptr<Client>> clients;
+
+    // Clients with queued frames, in round robin order
+    std::deque<uint16_t> active;
+};
+
+#endif //FORT_AGENT_FAIRSCHEDULER_H
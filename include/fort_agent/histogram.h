@@ -0,0 +1,92 @@
+#ifndef FORT_AGENT_HISTOGRAM_H
+#define FORT_AGENT_HISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <spdlog/fmt/fmt.h>
+
+/* Lock-free power-of-two histogram used for the agent's runtime metrics.
+ *
+ * Bucket 0 holds zero, bucket N holds values in [2^(N-1), 2^N).  Recording is a couple of relaxed
+ * atomic increments so it is safe from any thread and cheap enough for per-packet use.  Percentiles
+ * are reported as the upper bound of the bucket they fall in, which is plenty for spotting tails.
+ */
+class Histogram {
+public:
+    static constexpr size_t bucketCount = 64;
+
+    void record(uint64_t value) {
+        buckets[bucketFor(value)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t prev = largest.load(std::memory_order_relaxed);
+        while (value > prev &&
+               !largest.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+
+    uint64_t max() const { return largest.load(std::memory_order_relaxed); }
+
+    double mean() const {
+        const uint64_t n = count();
+        return n == 0 ? 0.0 : static_cast<double>(sum.load(std::memory_order_relaxed)) / n;
+    }
+
+    // Upper bound of the bucket containing the given percentile (0-100)
+    uint64_t percentile(double pct) const {
+        const uint64_t n = count();
+        if (n == 0) {
+            return 0;
+        }
+
+        const uint64_t target = static_cast<uint64_t>(n * pct / 100.0 + 0.5);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < bucketCount; i++) {
+            seen += buckets[i].load(std::memory_order_relaxed);
+            if (seen >= target && seen > 0) {
+                return i == 0 ? 0 : std::min(max(), (uint64_t(1) << i) - 1);
+            }
+        }
+        return max();
+    }
+
+    void reset() {
+        for (auto &bucket : buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        total.store(0, std::memory_order_relaxed);
+        sum.store(0, std::memory_order_relaxed);
+        largest.store(0, std::memory_order_relaxed);
+    }
+
+    // One-line summary for the stats dump, e.g. "n=120 mean=3.2 p50<=3 p99<=15 max=16"
+    std::string summary() const {
+        return fmt::format("n={} mean={:.1f} p50<={} p99<={} max={}", count(), mean(),
+                           percentile(50), percentile(99), max());
+    }
+
+private:
+    static size_t bucketFor(uint64_t value) {
+        size_t bucket = 0;
+        while (value != 0 && bucket < bucketCount - 1) {
+            value >>= 1;
+            bucket++;
+        }
+        return bucket;
+    }
+
+    std::array<std::atomic<uint64_t>, bucketCount> buckets{};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> largest{0};
+};
+
+#endif //FORT_AGENT_HISTOGRAM_H
@@ -0,0 +1,24 @@
+#ifndef FORT_AGENT_IOBACKEND_H
+#define FORT_AGENT_IOBACKEND_H
+
+#include <boost/asio.hpp>
+
+/* Boost.Asio chooses its reactor at compile time.  Building with USE_IO_URING=ON defines
+ * BOOST_ASIO_HAS_IO_URING and BOOST_ASIO_DISABLE_EPOLL for every target, which makes io_uring the
+ * backend for the serial port, UDP sockets and timers; otherwise epoll is used on Linux.
+ */
+inline const char *ioBackendName() {
+#if defined(BOOST_ASIO_HAS_IO_URING_AS_DEFAULT)
+    return "io_uring";
+#elif defined(BOOST_ASIO_HAS_EPOLL)
+    return "epoll";
+#elif defined(BOOST_ASIO_HAS_KQUEUE)
+    return "kqueue";
+#elif defined(BOOST_ASIO_HAS_IOCP)
+    return "iocp";
+#else
+    return "select";
+#endif
+}
+
+#endif //FORT_AGENT_IOBACKEND_H
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Deadline based liveness check for the controlled JAUS component.
+ *
+ * OpenJAUS callback threads call beat() for every ReportHeartbeatPulse or other report from the
+ * component, which only stores a timestamp.  The JAUS service thread sleeps until deadline() and
+ * calls expired(), which reports the loss once, the moment the timeout passes, instead of waiting
+ * for the next poll.  A later beat clears the loss.
+ *
+ * Nothing is watched until the first beat, so an undiscovered vehicle is never reported lost.
+ */
+class HeartbeatMonitor {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats {
+        uint64_t beats;         /**< reports from the controlled component */
+        uint64_t losses;        /**< timeouts reported by expired() */
+        uint64_t recoveries;    /**< beats after a loss */
+    };
+
+    explicit HeartbeatMonitor(Clock::duration timeout = std::chrono::milliseconds(500)) : limit(timeout) {}
+
+    /** Set the timeout, call before the service thread runs. */
+    void setTimeout(Clock::duration timeout) { limit = timeout; }
+
+    Clock::duration timeout() const { return limit; }
+
+    /** Record a report from the controlled component.  Safe from any thread. */
+    void beat(Clock::time_point now = Clock::now());
+
+    /** @return true if a beat arrived within the timeout.  Safe from any thread. */
+    bool alive(Clock::time_point now = Clock::now()) const;
+
+    /** When expired() should next be called, Clock::time_point::max() while there is nothing to watch. */
+    Clock::time_point deadline() const;
+
+    /**
+     * @return true once per loss, when the timeout has passed since the last beat.
+     * @param sinceLastBeat set to the time from the last beat to now, the detection latency.
+     * Service thread only.
+     */
+    bool expired(Clock::time_point now, Clock::duration& sinceLastBeat);
+
+    Stats stats() const;
+
+private:
+    Clock::duration limit;
+    // Clock ticks of the last beat, 0 before the first
+    std::atomic<Clock::rep> lastBeat{0};
+    // Service thread only: the lastBeat value that was reported lost
+    Clock::rep lostAt = 0;
+    bool lost = false;
+
+    std::atomic<uint64_t> beatCount{0};
+    std::atomic<uint64_t> lossCount{0};
+    std::atomic<uint64_t> recoveryCount{0};
+};
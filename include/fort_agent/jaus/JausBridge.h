@@ -1,18 +1,44 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <cstring>
-#include <queue>
-#include <mutex>
-#include <condition_variable>
 #include <thread>
 
+#include <boost/circular_buffer.hpp>
+
+#include <fort_agent/conflatingMailbox.h>
+#include <fort_agent/histogram.h>
+#include <fort_agent/observeSubscriptions.h>
+#include <fort_agent/responseDispatcher.h>
+#include <fort_agent/spscRing.h>
+#include <fort_agent/timedStrand.h>
+#include <fort_agent/wakeSignal.h>
+#include <fort_agent/jaus/HeartbeatMonitor.h>
 #include <fort_agent/jaus/JausClient.h>
+#include <fort_agent/jaus/JoystickFilter.h>
+#include <fort_agent/jaus/TickSchedule.h>
 #include <fort_agent/jaus/vehicleStateMachine.h>
 #include <fort_agent/uart/FORTJoystick/FORTJoystickHelpers.h>
 
+/** Service thread tuning, filled in from fort-agent.conf */
+struct JausBridgeSettings {
+    /** How long the service thread polls for input before sleeping, 0 sleeps straight away */
+    std::chrono::microseconds spinBeforeSleep{0};
+    /** Rate of VehicleStateMachine::update() calls, which run the heartbeat and control checks */
+    double controlRateHz = 50;
+    /** Rate of SetWrenchEffort messages while READY, effectively rounded to the control tick */
+    double wrenchRateHz = 25;
+    /** Axis deadband and hysteresis deciding which joystick samples count as changed */
+    JoystickFilter::Settings joystickFilter{};
+    /** Silence from the controlled component after which the state machine is told the heartbeat is lost */
+    std::chrono::milliseconds heartbeatTimeout{500};
+};
+
 class JausBridge
 {
 public:
+    /** Tracking ids for requests the agent sends to the SRC Pro; responses come back through ResponseDispatcher. */
     enum class JausPort : uint16_t {
         START = 900,
         SAFETY,
@@ -68,17 +94,26 @@ public:
         stopServiceLoop(); // ensures cleanup
     }
 
-    bool evaluateCoapJausMessage(JausBridge::JausPort jausPort, const uint8_t* payload, size_t payloadLen);
+    /** Register a handler for each SRC Pro response the bridge consumes. */
+    void registerResponseHandlers(ResponseDispatcher& dispatcher);
+    /** Hand joystick input to the service thread.  Single producer: only call from the CoAP tracker strand. */
     void postInput(const frc_combined_data_t& input);
+    /** Tell the service thread a JAUS response arrived.  Safe from any thread. */
     void postJAUSResponse();
-    void startServiceLoop();
+    /** Tell the heartbeat monitor the controlled component was heard from.  Safe from any thread. */
+    void postHeartbeat() { heartbeat.beat(); }
+    /** @return true if the controlled component was heard from within the heartbeat timeout. */
+    bool isHeartbeatAlive() const { return heartbeat.alive(); }
+    std::chrono::steady_clock::duration heartbeatTimeout() const { return heartbeat.timeout(); }
+    void startServiceLoop(const JausBridgeSettings& settings = JausBridgeSettings());
     void stopServiceLoop();
 
 
 private:
-    struct BridgeMessage {
-        enum class Kind { JoystickInput, JAUSResponse } kind;
-        frc_combined_data_t joystickInput; // Serial port joystick input
+    struct JoystickInput {
+        frc_combined_data_t data; // Serial port joystick input
+        std::chrono::steady_clock::time_point posted;
+        uint64_t sequence;
     };
 
     std::string serialNumber;
@@ -86,12 +121,53 @@ private:
     BatteryStatus batteryStatus;
 
     std::unique_ptr<JAUSClient> jausClient;
-    std::queue<BridgeMessage> inputQueue;
-    std::mutex queueMutex;
-    std::condition_variable queueCV;
-    bool running = false;
+    /** Drops joystick samples that only differ by sensor noise, owned by the tracker strand */
+    JoystickFilter joystickFilter;
+    /**
+     * Joystick input from the tracker strand to the service thread, without locks or allocation.
+     * Samples that only move the sticks go through latestInput, where a newer sample replaces one
+     * the service thread has not picked up yet.  Samples that change a button go through eventRing
+     * in order, so no press or release is lost.  If the ring is full they wait in eventBacklog,
+     * owned by the tracker strand; the service thread posts a drain to that strand once it has made
+     * room, so a backlogged edge does not wait for the next joystick sample.
+     */
+    static constexpr size_t eventBacklogCapacity = 256;
+    ConflatingMailbox<JoystickInput> latestInput;
+    SpscRing<JoystickInput, 64> eventRing;
+    boost::circular_buffer<JoystickInput> eventBacklog{eventBacklogCapacity};
+    /** Set by the tracker strand while eventBacklog holds edges, taken by the service thread */
+    std::atomic<bool> backlogged{false};
+    TimedStrand* inputStrand = nullptr;
+    uint64_t inputSequence = 0;
+    int32_t postedButtons = -1;
+    uint64_t handledSequence = 0;
+    /** JAUS responses come from OpenJAUS threads, they only need counting */
+    std::atomic<uint32_t> pendingResponses{0};
+    WakeSignal inputReady;
+    std::chrono::microseconds spinBeforeSleep{0};
+    /** Control loop tick, owned by the service thread */
+    TickSchedule controlTicks;
+    Histogram tickJitterUs;
+    Histogram tickDurationUs;
+    /** Liveness of the controlled component, its deadline is one of the service thread's wake-ups */
+    HeartbeatMonitor heartbeat;
+    Histogram heartbeatDetectionMs;
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> inputsConflated{0};
+    std::atomic<uint64_t> eventsBacklogged{0};
+    std::atomic<uint64_t> eventsDropped{0};
+    Histogram handoffLatencyUs;
+    Histogram queueDepth;
     std::thread serviceThread;
     std::unique_ptr<VehicleStateMachine> stateMachine; 
+    /** Observe registrations the bridge depends on, re-registered when they go quiet or the link recovers. */
+    ObserveSubscriptions subscriptions;
     void serviceLoop();
+    void publishInput(const frc_combined_data_t& input);
+    bool drainBacklog();
+    void handleInput(const JoystickInput& input);
+    void controlTick(std::chrono::steady_clock::time_point now);
+    void checkHeartbeat(std::chrono::steady_clock::time_point now);
+    void reportStats() const;
 };
 
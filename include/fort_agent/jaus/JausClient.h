@@ -18,7 +18,9 @@ public:
     /** Initialise the underlying OpenJAUS component and register callbacks. */
     virtual void initializeJAUS() = 0;
     /**
-     * Discover a remote vehicle that exposes the JAUS Primitive Driver service.
+     * Select a remote vehicle that exposes the JAUS Primitive Driver service.
+     * Called on the JAUS service thread, so it must answer from already
+     * discovered components rather than wait on the network.
      * @return true if a valid target was located and cached.
      */
     virtual bool discoverVehicle() = 0;
@@ -47,6 +49,6 @@ public:
     virtual bool isHeartbeatAlive() const = 0;
     /** Stream calibrated joystick data to the remote primitive driver. */
     virtual void sendWrenchEffort(const frc_joystick_data_t& data) = 0;
-    /** @return Human readable name of the selected remote component. */
+    /** @return Human readable name of the selected remote component, without a registry lookup. */
     virtual std::string getComponentName() = 0;
 };
\ No newline at end of file
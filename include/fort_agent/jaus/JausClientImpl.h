@@ -1,5 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 //OpenJAUS
 #include <openjaus/Components/Base.h>
 #include <openjaus/mobility_v1_1/GlobalPoseSensor.h>
@@ -7,10 +13,14 @@
 #include <openjaus/system/Application.h>
 
 #include <fort_agent/jaus/JausClient.h>
+#include <fort_agent/jaus/JausReports.h>
+#include <fort_agent/jaus/VehicleDirectory.h>
+#include <fort_agent/seqlockSnapshot.h>
 
 class JAUSClientImpl : public JAUSClient {
 public:
     JAUSClientImpl();
+    ~JAUSClientImpl() override;
     bool discoverVehicle() override;
     bool sendRequestControl() override;
     bool hasControl() const override;
@@ -29,24 +39,84 @@ public:
     static void handleReleaseControlResponse(const openjaus::model::ControlResponse& response);
     static bool handleIncomingReportControl(openjaus::core_v1_1::informclass::ReportControl& incoming);
     static bool handleIncomingReportStatus(openjaus::core_v1_1::informclass::ReportStatus& incoming);
+    static bool handleIncomingReportHeartbeatPulse(openjaus::core_v1_1::liveness::ReportHeartbeatPulse& incoming);
     static bool handleIncomingReportGlobalPose(openjaus::mobility_v1_1::globalposesensor::ReportGlobalPose& incoming);
     static bool handleIncomingReportGeomagneticProperty(openjaus::mobility_v1_1::globalposesensor::ReportGeomagneticProperty& incoming);
     static bool handleIncomingReportWrenchEffort(openjaus::mobility_v1_1::primitivedriver::ReportWrenchEffort& incoming);
     static void handleEventRequestResponse(const openjaus::model::EventRequestResponseArgs& response);
 private:
-    static std::string toString(double value, bool enabled);
-    static double normalizeJoysticValue(int x);
+    /** Console frames for the reports received since the last call, empty if none. */
+    static std::string renderChangedReports();
+    /** Background thread keeping vehicles current, so discoverVehicle() never queries the registry. */
+    void refreshVehicles();
+    void stopRefresher();
+    /** Subscribe to on-change ReportStatus and ReportControl from serverAddress, dropping older subscriptions. */
+    void subscribeToStateEvents();
+    void unsubscribeFromStateEvents();
+    /** Wake the state machine, only called when something it acts on has changed. */
+    static void notifyTransition(const char* what);
+    /**
+     * Feed the heartbeat monitor if a message came from the controlled component.
+     * @return false for messages from any other component, which the states must not act on.
+     */
+    static bool noteReportFrom(const openjaus::transport::Address& source);
+    static uint32_t packAddress(const openjaus::transport::Address& address);
+
     // Any additional initialization if needed
     openjaus::components::Base component;
     openjaus::transport::Address serverAddress;
+    std::string serverName;
+
+    // Primitive Driver components found by the refresher thread
+    static constexpr std::chrono::milliseconds discoveryInterval{500};
+    VehicleDirectory vehicles;
+    std::thread discoveryThread;
+    std::mutex discoveryMutex;
+    std::condition_variable discoveryWake;
+    bool discoveryRunning = false;
+    bool discoveryRequested = false;
 
     bool reportGlobalPoseSubscribed = false;
     uint32_t reportGlobalPoseSubscriptionId = 0;
     bool reportWrenchEffortSubscribed = false;
     uint32_t reportWrenchEffortSubscriptionId = 0;
 
-    static bool controlGranted;
-    static bool requestPending;
+    // On-change event subscriptions replacing status and control polling
+    bool reportStatusSubscribed = false;
+    uint32_t reportStatusSubscriptionId = 0;
+    bool reportControlSubscribed = false;
+    uint32_t reportControlSubscriptionId = 0;
+    bool reportHeartbeatPulseSubscribed = false;
+    uint32_t reportHeartbeatPulseSubscriptionId = 0;
+
+    /*
+     * Written from OpenJAUS callback threads, read by the JAUS service thread.  The states read
+     * these after postJAUSResponse(), which is only posted on a change.
+     */
+    static std::atomic<bool> controlGranted;
+    static std::atomic<bool> requestPending;
+    // When the outstanding QueryStatus was sent, 0 if none; retried after statusQueryTimeout
+    static constexpr std::chrono::seconds statusQueryTimeout{1};
+    static std::atomic<std::chrono::steady_clock::rep> statusQuerySentAt;
+    static std::atomic<bool> vehicleReady;
+    // serverAddress packed by packAddress(), 0 until a vehicle is selected, for the callbacks
+    static std::atomic<uint32_t> controlledComponent;
+    // Our own address, set before the component runs, to tell whether ReportControl names us
+    static openjaus::transport::Address ownAddress;
+    // Last reported status, only used to log and detect transitions in the callbacks
+    static std::mutex statusMutex;
     static openjaus::core_v1_1::informclass::fields::reportstatus::reportstatusrec::Status currentStatus;
+    // Latest reports, stored by the callbacks and only rendered to text when shown.  Each callback
+    // stores a whole report of its own, the counts live apart so no callback reads back a snapshot.
+    static SeqlockSnapshot<PoseReport> latestPose;
+    static SeqlockSnapshot<GeomagneticReport> latestGeomagnetic;
+    static SeqlockSnapshot<WrenchReport> latestWrench;
+    static SeqlockSnapshot<ControlReport> latestControl;
+    static std::atomic<uint64_t> poseCount;
+    static std::atomic<uint64_t> geomagneticCount;
+    static std::atomic<uint64_t> wrenchCount;
+    static std::atomic<uint64_t> controlCount;
+    // The pose with the latest magnetic variation filled in, false if neither was received yet
+    static bool loadPose(PoseReport& pose);
 
 };
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Compact copies of the JAUS reports the agent receives.
+ *
+ * OpenJAUS callbacks fill these in and publish them as SeqlockSnapshot values; nothing is
+ * formatted on the receive thread.  The text shown on the console or in the statistics is
+ * rendered from the latest snapshot only when it is asked for.
+ */
+
+/** Fields a report left out are flagged in a bit mask and shown as N/A. */
+using ReportFieldMask = uint16_t;
+
+/** ReportGlobalPose, shown with the magnetic variation from the latest GeomagneticReport. */
+struct PoseReport {
+    enum Field : ReportFieldMask {
+        LATITUDE = 1 << 0,
+        LONGITUDE = 1 << 1,
+        ALTITUDE = 1 << 2,
+        ROLL = 1 << 3,
+        PITCH = 1 << 4,
+        YAW = 1 << 5,
+        MAGNETIC_VARIATION = 1 << 6,
+    };
+
+    double latitudeDeg;
+    double longitudeDeg;
+    double altitudeM;
+    double rollRad;
+    double pitchRad;
+    double yawRad;
+    double magneticVariationRad;
+    ReportFieldMask fields;
+    uint64_t count;     /**< reports received so far */
+};
+
+/** ReportGeomagneticProperty, kept apart from the pose so the two callbacks never share a snapshot. */
+struct GeomagneticReport {
+    double magneticVariationRad;
+    uint64_t count;
+};
+
+/** ReportWrenchEffort, linear X Y Z then rotational X Y Z, in percent. */
+struct WrenchReport {
+    std::array<double, 6> propulsive;
+    std::array<double, 6> resistive;
+    ReportFieldMask propulsiveFields;   /**< bit n set if propulsive[n] was reported */
+    ReportFieldMask resistiveFields;
+    uint64_t count;
+};
+
+/** ReportControl: the component holding control and its authority. */
+struct ControlReport {
+    uint16_t subsystemId;
+    uint8_t nodeId;
+    uint8_t componentId;
+    uint8_t authorityCode;
+    uint64_t count;
+};
+
+/** Multi-line console frames, as the callbacks used to print for every report. */
+std::string renderFrame(const PoseReport& pose);
+std::string renderFrame(const WrenchReport& wrench);
+std::string renderFrame(const ControlReport& control);
+
+/** One line summaries for the statistics log. */
+std::string renderSummary(const PoseReport& pose);
+std::string renderSummary(const WrenchReport& wrench);
+std::string renderSummary(const ControlReport& control);
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <fort_agent/uart/FORTJoystick/FORTJoystickHelpers.h>
+
+/**
+ * @brief Decides which joystick samples are worth handing to the JAUS thread.
+ *
+ * The calibrated axes are noisy in their low bits, so nearly every SRC Pro notification differs
+ * from the last one.  Two per-axis thresholds, in raw counts, take that noise out:
+ *
+ * - deadband: values within this distance of centre are forwarded as exactly 0, so a stick at
+ *   rest commands no effort and its noise is ignored;
+ * - hysteresis: an axis only counts as moved once it is more than this far from the value last
+ *   forwarded.  Returning to centre always counts.
+ *
+ * A keypad change or a change of an axis' dataOK flag is always forwarded.  The six axes are
+ * compared as one fixed-width array, which the compiler turns into a few SIMD instructions.
+ *
+ * Not thread safe: call accept() from the CoAP tracker strand.  stats() may be read from anywhere.
+ */
+class JoystickFilter {
+public:
+    static constexpr size_t axisCount = 6;
+
+    struct Settings {
+        std::array<uint16_t, axisCount> deadband;     /**< lx, ly, lz, rx, ry, rz */
+        std::array<uint16_t, axisCount> hysteresis;
+    };
+
+    struct Stats {
+        uint64_t samples;
+        uint64_t forwarded;
+        uint64_t keypadChanges;
+        /** Samples where the axis changed but stayed inside its deadband or hysteresis band */
+        std::array<uint64_t, axisCount> axisSuppressed;
+    };
+
+    explicit JoystickFilter(const Settings& settings = Settings());
+
+    /** Replace the thresholds, call before the first sample. */
+    void configure(const Settings& settings);
+
+    /** Apply the deadband to sample in place and return true if it should be forwarded. */
+    bool accept(frc_combined_data_t& sample);
+
+    Stats stats() const;
+
+    /** Fraction of samples not forwarded, 0 before any sample */
+    double suppressionRatio() const;
+
+private:
+    // Padded to eight lanes of 16 bits, one 128-bit vector
+    static constexpr size_t lanes = 8;
+    using Axes = std::array<int16_t, lanes>;
+
+    static Axes axesOf(const frc_joystick_data_t& data);
+    static uint8_t okFlagsOf(const frc_joystick_data_t& data);
+
+    Axes deadband{};
+    Axes hysteresis{};
+
+    bool first = true;
+    Axes lastRaw{};
+    Axes lastForwarded{};
+    uint16_t lastButtons = 0;
+    uint8_t lastOkFlags = 0;
+
+    std::atomic<uint64_t> samples{0};
+    std::atomic<uint64_t> forwarded{0};
+    std::atomic<uint64_t> keypadChanges{0};
+    std::array<std::atomic<uint64_t>, axisCount> axisSuppressed{};
+};
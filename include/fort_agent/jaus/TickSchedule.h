@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Fixed rate deadlines for the JAUS service thread's control tick.
+ *
+ * Ticks are due on a grid of whole periods from start().  A tick that finishes after the next
+ * grid point does not make the thread run the missed ticks back to back: complete() moves the
+ * deadline to the first grid point after the tick finished and counts the skipped ones as
+ * overruns.  Service thread only, apart from stats().
+ */
+class TickSchedule {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats {
+        uint64_t ticks;         /**< ticks completed */
+        uint64_t overruns;      /**< grid points skipped because a tick ran past them */
+    };
+
+    explicit TickSchedule(Clock::duration period = std::chrono::milliseconds(20)) : interval(period) {}
+
+    /** Set the period from a rate in Hz, call before start(). */
+    void setRate(double hz);
+
+    Clock::duration period() const { return interval; }
+
+    /** The first tick is due one period after now. */
+    void start(Clock::time_point now);
+
+    /** When the next tick is due. */
+    Clock::time_point deadline() const { return next; }
+
+    bool due(Clock::time_point now) const { return now >= next; }
+
+    /** Record a tick that finished at done and move the deadline on. */
+    void complete(Clock::time_point done);
+
+    Stats stats() const;
+
+private:
+    Clock::duration interval;
+    Clock::time_point next;
+    std::atomic<uint64_t> tickCount{0};
+    std::atomic<uint64_t> overrunCount{0};
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Ranked list of JAUS components offering the Primitive Driver service.
+ *
+ * A background refresher queries the OpenJAUS registry and calls update() with what it found;
+ * the JAUS service thread only ever reads the published snapshot, which is a pointer copy.  An
+ * R-Down press during discovery is therefore answered from memory and never waits on the
+ * registry.  A new snapshot is only published when the set of components or their names changed.
+ *
+ * Vehicles are ranked with the one selected last first, so a refresh never switches vehicles
+ * under the operator, then named components before unnamed ones, then by address.
+ */
+class VehicleDirectory {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Vehicle {
+        uint32_t id;        /**< subsystem << 16 | node << 8 | component */
+        std::string name;   /**< registry name, empty if unknown */
+    };
+
+    struct Snapshot {
+        std::vector<Vehicle> vehicles;  /**< best candidate first */
+        uint64_t generation;            /**< changes published so far */
+    };
+
+    struct Stats {
+        uint64_t refreshes;     /**< registry queries */
+        uint64_t changes;       /**< refreshes that published a new list */
+        uint64_t reads;         /**< snapshot() calls */
+    };
+
+    VehicleDirectory();
+
+    /**
+     * Refresher only: replace the list with what the registry returned.
+     * @return true if a new snapshot was published.
+     */
+    bool update(std::vector<Vehicle> found, Clock::time_point now = Clock::now());
+
+    /** The current list, never null.  Safe from any thread. */
+    std::shared_ptr<const Snapshot> snapshot() const;
+
+    /** Rank id first from the next refresh on, e.g. once it has been selected.  Safe from any thread. */
+    void prefer(uint32_t id);
+
+    /** Time since the registry was last queried, Clock::duration::max() before the first refresh. */
+    Clock::duration age(Clock::time_point now = Clock::now()) const;
+
+    /** Name known for id from the last refresh, empty if none.  Refresher only. */
+    std::string knownName(uint32_t id) const;
+
+    Stats stats() const;
+
+private:
+    // Written by the refresher, read through the atomic shared_ptr functions
+    std::shared_ptr<const Snapshot> current;
+    std::atomic<uint32_t> preferred{0};
+    // Clock ticks of the last refresh, 0 before the first
+    std::atomic<Clock::rep> refreshedAt{0};
+
+    std::atomic<uint64_t> refreshCount{0};
+    std::atomic<uint64_t> changeCount{0};
+    mutable std::atomic<uint64_t> readCount{0};
+
+    void rank(std::vector<Vehicle>& vehicles) const;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <fort_agent/jaus/JausClient.h>
+
+/**
+ * @brief Sends SetWrenchEffort at a fixed rate from the latest joystick sample.
+ *
+ * Joystick notifications arrive as fast and as unevenly as the SRC Pro sends them, and only when
+ * something changed.  The streamer decouples the JAUS command stream from that: update() only
+ * stores the sample, and poll(), called from the control tick, sends the newest sample once per
+ * period.  Between notifications the last sample is sent again, so the vehicle sees a steady
+ * stream; a burst of notifications still produces one command per period.  Missed periods are
+ * skipped, never caught up.
+ *
+ * A sample is only held while the joystick is known to still be there: confirm() is called for
+ * every live notification, including those the filter drops as unchanged.  Once neither a new
+ * sample nor a confirmation arrived for the hold limit, e.g. because the SRC Pro link went silent
+ * or the Observe stream died, the streamer sends zero effort instead.
+ *
+ * The rate is process wide and set once at start-up, since each ReadyState owns its own streamer
+ * and streaming must stop with the state.  Statistics are process wide for the same reason.
+ */
+class WrenchStreamer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats {
+        uint64_t samples;       /**< update() calls */
+        uint64_t sent;          /**< SetWrenchEffort messages */
+        uint64_t held;          /**< sends repeating a sample already sent */
+        uint64_t superseded;    /**< samples replaced before they were sent */
+        uint64_t expired;       /**< held samples replaced by zero effort */
+    };
+
+    /** Set the stream rate, call before any state machine runs. */
+    static void setRate(double hz);
+
+    static Clock::duration period();
+
+    /** Longest a sample is repeated without a confirmation, call before any state machine runs. */
+    static void setMaxHold(Clock::duration limit);
+
+    /** The joystick is still live and where it was last reported.  Safe from any thread. */
+    static void confirm(Clock::time_point now = Clock::now());
+
+    static Stats stats();
+
+    explicit WrenchStreamer(JAUSClient& client) : client(client) {}
+
+    /** Store the newest joystick sample, sent at the next period. */
+    void update(const frc_joystick_data_t& sample, Clock::time_point now = Clock::now());
+
+    /** Send the latest sample if a period is due. */
+    void poll(Clock::time_point now = Clock::now());
+
+private:
+    JAUSClient& client;
+    frc_joystick_data_t latest{};
+    bool haveSample = false;
+    bool fresh = false;
+    bool zeroed = false;
+    Clock::time_point sampleAt{};
+    Clock::time_point nextSend{};
+
+    static std::atomic<Clock::rep> periodTicks;
+    static std::atomic<Clock::rep> maxHoldTicks;
+    // Clock ticks of the last confirm(), 0 before the first
+    static std::atomic<Clock::rep> confirmedAt;
+    static std::atomic<uint64_t> sampleCount;
+    static std::atomic<uint64_t> sentCount;
+    static std::atomic<uint64_t> heldCount;
+    static std::atomic<uint64_t> supersededCount;
+    static std::atomic<uint64_t> expiredCount;
+};
@@ -41,13 +41,14 @@ public:
     void handleResponse() override {
         if (client.hasControl()) {
             controlGranted = true;
-        } else {
-            // let ask again?
+        } else if (controlRequested && !client.isRequestPending()) {
+            // rejected, let ask again? A status change while waiting on the answer isn't a rejection
             displayTextOnJoystick("Requesting Control", "Retry...");
             client.sendRequestControl();
         }
     }
     
+    void handleHeartbeatLost() override {}
     void update() override {}
 
     /** Advance to StandbyState when JAUS grants control authority. */
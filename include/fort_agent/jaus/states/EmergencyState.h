@@ -21,6 +21,10 @@ public:
         // Ignore Retry in emergency
     }
 
+    void handleHeartbeatLost() override {
+        // Already disabled
+    }
+
     void update() override {
         // Could monitor heartbeat or wait for manual reset
     }
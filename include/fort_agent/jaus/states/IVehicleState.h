@@ -22,6 +22,8 @@ public:
     virtual void handleInput(const frc_combined_data_t & input) = 0;
     /** React to the latest JAUS response queued by the client. */
     virtual void handleResponse() = 0;
+    /** The controlled component went silent for longer than the heartbeat timeout. */
+    virtual void handleHeartbeatLost() = 0;
     /** Periodic tick invoked from the bridge service loop. */
     virtual void update() = 0;
     /**
@@ -28,6 +28,7 @@ public:
     }
 
     void handleResponse() override {}
+    void handleHeartbeatLost() override {}
     void update() override {}
 
     std::unique_ptr<IVehicleState> next() override {
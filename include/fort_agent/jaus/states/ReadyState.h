@@ -1,24 +1,27 @@
 #pragma once
 
 #include <fort_agent/jaus/JausClient.h>
+#include <fort_agent/jaus/WrenchStreamer.h>
 #include <fort_agent/jaus/states/IVehicleState.h>
 #include <fort_agent/jaus/states/EmergencyState.h>
 #include <fort_agent/jaus/states/StandbyState.h>
 
 
-#include <chrono>
 
 /**
  * @brief Active control state where joystick data flows continuously to JAUS.
  *
- * The state monitors heartbeat health and control ownership.  A missed
- * heartbeat triggers @ref EmergencyState.  Control loss can be handled in the
+ * Joystick reports are streamed as SetWrenchEffort at a fixed rate by a
+ * @ref WrenchStreamer, which stops with the state.
+ * The state monitors heartbeat health and control ownership.  The bridge
+ * reports a missed heartbeat the moment its deadline passes, which triggers
+ * @ref EmergencyState.  Control loss can be handled in the
  * future by returning to standby.
  */
 class ReadyState : public IVehicleState {
 public:
     ReadyState(JAUSClient& client) : 
-        IVehicleState(), client(client), lastHeartbeatCheck(std::chrono::steady_clock::now()) 
+        IVehicleState(), client(client), wrench(client)
         {}
 
     /** Vibrate motors and inform the driver when the vehicle is ready. */
@@ -27,31 +30,30 @@ public:
         vibrateJoystick(true, true); // Vibrate both motors on entering ready state
     }
 
-    /** Forward every joystick report to JAUS as a wrench effort setpoint. */
+    /** Latest joystick report becomes the wrench effort setpoint, streamed from update(). */
     void handleInput(const frc_combined_data_t& input) override {
-        // Send joystick data to JAUS
-        client.sendWrenchEffort(input.joystick_data);
+        wrench.update(input.joystick_data);
         }
 
-    /** Placeholder hook for JAUS responses that arrive while READY. */
+    /** Woken by a status or control change while READY; control loss is noticed here first. */
     void handleResponse() override {
-        // Really should not have anything but this is where we can handle heartbeat stuff
+        if (!client.hasControl()) {
+            hasControl = false;
+        }
+    }
+
+    /** Pushed by the bridge's heartbeat monitor, no polling needed. */
+    void handleHeartbeatLost() override {
+        emergencyTriggered = true;
     }
 
     /**
-     * @brief Monitor heartbeat cadence and control ownership.
+     * @brief Stream the wrench effort and watch control ownership.
      *
-     * Runs each control loop tick to ensure the vehicle remains responsive and
-     * keeps authority; loss of either triggers a state transition.
+     * Runs each control loop tick; loss of control triggers a state transition.
      */
     void update() override {
-        auto now = std::chrono::steady_clock::now();
-        if (now - lastHeartbeatCheck > std::chrono::seconds(1)) {
-            lastHeartbeatCheck = now;
-            if (!client.isHeartbeatAlive()) {
-                emergencyTriggered = true;
-            }
-        }
+        wrench.poll();
 
         if (!client.hasControl()) {
             hasControl = false;
@@ -73,9 +75,9 @@ public:
 
 private:
     JAUSClient& client;
+    WrenchStreamer wrench;
     bool emergencyTriggered = false;
     bool hasControl = true;
-    std::chrono::steady_clock::time_point lastHeartbeatCheck;
 
     /** Lightweight bitmask helper for keypad input state. */
     bool isButtonPressed(uint16_t status, KeypadButton button) {
@@ -26,6 +26,8 @@ public:
 
     void handleResponse() override {}
 
+    void handleHeartbeatLost() override {}
+
     std::unique_ptr<IVehicleState> next() override {
         return std::move(nextState);
     }
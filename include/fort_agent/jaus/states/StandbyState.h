@@ -8,8 +8,8 @@
  * @brief Waits for the operator to bring the vehicle into READY state.
  *
  * Control has already been granted.  The next step is to request a resume
- * command and poll JAUS status until the vehicle reports READY, at which point
- * the machine progresses to @ref ReadyState.
+ * command and wait for the ReportStatus event saying the vehicle is READY, at
+ * which point the machine progresses to @ref ReadyState.
  */
 class StandbyState : public IVehicleState {
 public:
@@ -23,8 +23,8 @@ public:
 
     // TODO, some of those action should be triggered by JAUS messages/state managment instead of keypad input
     /**
-     * First R-Down press sends Resume and triggers an immediate status query to
-     * verify when READY is reached.
+     * First R-Down press sends Resume and one status query, in case the vehicle
+     * was already READY and no change event will follow.
      */
     void handleInput(const frc_combined_data_t& input) override {
         if (isRDown(input.keypad_data.buttonStatus) && !rDownPressed) {
@@ -32,7 +32,7 @@ public:
             if (!resumeRequested) {
                 resumeRequested = client.sendRequestResume();
                 displayTextOnJoystick("Requesting", "Active state...");
-                // This will trigger a response later to indicate that control is granted
+                // Only answered with a wake-up if the vehicle is READY, later changes come as events
                 client.queryStatus();
             } 
         } else if (!isRDown(input.keypad_data.buttonStatus)) {
@@ -42,11 +42,14 @@ public:
 
     void update() override {}
 
-    void handleResponse() override { 
-        if (client.hasReadyState() == false) {
-            client.queryStatus();
-            displayTextOnJoystick("Requesting", "Active state Retry...");
-        } else {
+    void handleHeartbeatLost() override {}
+
+    /**
+     * Woken when the vehicle status changes.  The client is subscribed to
+     * ReportStatus events, so there is nothing to re-query while it isn't READY.
+     */
+    void handleResponse() override {
+        if (client.hasReadyState()) {
             readyStateGranted = true;
         }
     }
@@ -20,6 +20,11 @@ public:
         transitionIfNeeded();
     }
 
+    void handleHeartbeatLost() {
+        currentState->handleHeartbeatLost();
+        transitionIfNeeded();
+    }
+
     void update() {
         currentState->update();
         transitionIfNeeded();
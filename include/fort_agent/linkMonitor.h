@@ -0,0 +1,98 @@
+#ifndef FORT_AGENT_LINKMONITOR_H
+#define FORT_AGENT_LINKMONITOR_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include <boost/asio.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <fort_agent/histogram.h>
+#include <fort_agent/timedStrand.h>
+
+/* Serial link health: CoAP ping round trip times, ping loss and RX silence.
+ *
+ * Every pingInterval the monitor sends an empty CON (a CoAP ping, RFC 7252 4.3), which the SRC Pro
+ * answers with an RST carrying the same MID.  onFrame() sees every frame read from the serial port;
+ * it consumes the matching RST, recording the round trip, and notes the time of the last RX.  A ping
+ * not answered within pingTimeout counts as lost.  When nothing at all has been received for
+ * silenceThreshold the link is reported SILENT through the event callback, and RECOVERED with the
+ * length of the outage once frames arrive again.
+ *
+ * Runs on the serial strand: onFrame() and poll() must be called there.  rtt() and stats() are
+ * safe from any thread.
+ */
+class LinkMonitor {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    enum class Event {
+        SILENT,
+        RECOVERED
+    };
+
+    // Sends one message to the serial port, false if it could not be queued
+    typedef std::function<bool(const uint8_t *message, size_t length)> SendFn;
+    typedef std::function<void(Event event, std::chrono::milliseconds silence)> EventFn;
+
+    struct Settings {
+        std::chrono::milliseconds pingInterval{100};    // 0 disables pings and silence checks
+        std::chrono::milliseconds pingTimeout{200};
+        std::chrono::milliseconds silenceThreshold{250};
+    };
+
+    struct Stats {
+        uint64_t pingsSent;
+        uint64_t pongs;
+        uint64_t lost;
+        uint64_t silenceEvents;
+        bool silent;
+        uint64_t sinceLastRxMs;
+    };
+
+    LinkMonitor(boost::asio::io_service &service, TimedStrand &strand, SendFn send, Settings settings,
+                EventFn onEvent = nullptr);
+
+    // Start the ping timer
+    void start();
+
+    // Returns true when frame is the answer to a ping and must not be forwarded
+    bool onFrame(const uint8_t *frame, size_t length, Clock::time_point now = Clock::now());
+
+    // One monitoring step: expire the outstanding ping, check for silence and send the next ping
+    void poll(Clock::time_point now = Clock::now());
+
+    // Ping round trip times in microseconds
+    const Histogram &rtt() const { return rttUs; }
+
+    // Fraction of pings that timed out, 0 before any ping was sent
+    double lossRate() const;
+
+    Stats stats() const;
+
+private:
+    void schedule();
+
+    TimedStrand &strand;
+    boost::asio::steady_timer timer;
+    const SendFn send;
+    const Settings settings;
+    const EventFn onEvent;
+
+    bool pingOutstanding;
+    uint16_t pingMid;
+    Clock::time_point pingSent;
+    std::atomic<int64_t> lastRx;    // Clock ticks, read by stats()
+    std::atomic<bool> silent{false};
+
+    Histogram rttUs;
+    std::atomic<uint64_t> pingsSent{0};
+    std::atomic<uint64_t> pongs{0};
+    std::atomic<uint64_t> lost{0};
+    std::atomic<uint64_t> silenceEvents{0};
+};
+
+#endif //FORT_AGENT_LINKMONITOR_H
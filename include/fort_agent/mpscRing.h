@@ -0,0 +1,91 @@
+#ifndef FORT_AGENT_MPSCRING_H
+#define FORT_AGENT_MPSCRING_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/* Bounded lock-free ring for handing items from any number of producer threads to one consumer
+ * thread.
+ *
+ * Every slot carries a sequence number telling whose turn it is: a producer claims the next slot
+ * with a compare-exchange on the tail, moves its item in and then publishes the slot; the consumer
+ * takes a slot once it is published and hands it back for the next lap.  push() never waits, it
+ * fails when the ring is full so the caller can drop or count the item.  Items are moved in and
+ * out of preallocated slots.
+ */
+template<typename T, size_t Capacity>
+class MpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    static constexpr size_t capacity = Capacity;
+
+    MpscRing() {
+        for (size_t i = 0; i < Capacity; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Any thread, false when the ring is full
+    bool push(T item) {
+        size_t tail = tailIndex.load(std::memory_order_relaxed);
+        Slot *slot;
+        for (;;) {
+            slot = &slots[tail & mask];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const intptr_t lap = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(tail);
+            if (lap == 0) {
+                if (tailIndex.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (lap < 0) {
+                return false;
+            } else {
+                tail = tailIndex.load(std::memory_order_relaxed);
+            }
+        }
+        slot->item = std::move(item);
+        slot->sequence.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only, false when the ring is empty or the oldest push is still being written
+    bool pop(T &item) {
+        const size_t head = headIndex.load(std::memory_order_relaxed);
+        Slot &slot = slots[head & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1) {
+            return false;
+        }
+        item = std::move(slot.item);
+        slot.sequence.store(head + Capacity, std::memory_order_release);
+        headIndex.store(head + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Approximate, claimed slots count even before their item is written
+    size_t size() const {
+        const size_t head = headIndex.load(std::memory_order_relaxed);
+        const size_t tail = tailIndex.load(std::memory_order_relaxed);
+        return tail - head;
+    }
+
+    bool empty() const { return size() == 0; }
+
+private:
+    static constexpr size_t mask = Capacity - 1;
+    static constexpr size_t cacheLine = 64;
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T item;
+    };
+
+    alignas(cacheLine) std::atomic<size_t> headIndex{0};
+    alignas(cacheLine) std::atomic<size_t> tailIndex{0};
+    alignas(cacheLine) std::array<Slot, Capacity> slots;
+};
+
+#endif //FORT_AGENT_MPSCRING_H
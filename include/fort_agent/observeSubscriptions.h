@@ -0,0 +1,91 @@
+#ifndef FORT_AGENT_OBSERVESUBSCRIPTIONS_H
+#define FORT_AGENT_OBSERVESUBSCRIPTIONS_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fort_agent/coapHelpers.h>
+
+/* Keeps the agent's own Observe relationships with the SRC Pro alive.
+ *
+ * Each subscription is registered with the id its notifications are dispatched under and a function
+ * that sends the Observe registration.  Every notification refreshes it for freshFor, or for the
+ * notification's Max-Age when freshFor is zero.  A subscription that goes past that without a
+ * notification, or whose notification ends the observation (an error code or no Observe option), is
+ * flagged stale and re-registered.  It is then retried with a backoff that doubles from
+ * initialBackoff up to maxBackoff until notifications flow again.  resubscribeAll() re-registers
+ * everything at once, for when the device has reconnected.
+ *
+ * Every registration uses a new MID so the device does not discard it as a duplicate.  All methods
+ * are thread safe; the register functions are called with the internal lock held and must not call
+ * back into this class.
+ */
+class ObserveSubscriptions {
+public:
+    typedef std::chrono::steady_clock Clock;
+    typedef std::function<void(uint16_t mid)> RegisterFn;
+
+    struct Settings {
+        std::chrono::milliseconds initialBackoff{100};
+        std::chrono::milliseconds maxBackoff{2000};
+    };
+
+    struct Stats {
+        std::string name;
+        bool stale;
+        uint64_t notifications;
+        uint64_t registrations;
+        uint64_t staleEvents;
+        std::chrono::milliseconds sinceLastNotification;
+    };
+
+    ObserveSubscriptions(uint16_t firstMid, Settings settings);
+
+    void add(uint16_t id, std::string name, RegisterFn subscribe,
+             std::chrono::milliseconds freshFor = std::chrono::milliseconds(0));
+
+    // Send every registration and start tracking freshness
+    void start(Clock::time_point now = Clock::now());
+
+    void onNotification(uint16_t id, const Coap::MessageView &msg, Clock::time_point now = Clock::now());
+
+    void resubscribeAll(Clock::time_point now = Clock::now());
+
+    // Re-register whatever is due and return when poll() next needs to run
+    Clock::time_point poll(Clock::time_point now = Clock::now());
+
+    std::vector<Stats> stats() const;
+
+    void reportStats() const;
+
+private:
+    struct Subscription {
+        std::string name;
+        RegisterFn subscribe;
+        std::chrono::milliseconds freshFor;
+        Clock::time_point deadline;
+        Clock::time_point lastNotification;
+        std::chrono::milliseconds backoff;
+        uint16_t mid;       // of the latest registration
+        bool stale;
+        uint64_t notifications;
+        uint64_t registrations;
+        uint64_t staleEvents;
+    };
+
+    void registerNow(Subscription &sub, Clock::time_point now);
+
+    const Settings settings;
+
+    mutable std::mutex mutex;
+    std::map<uint16_t, Subscription> subscriptions;
+    uint16_t nextMid;
+    bool started;
+};
+
+#endif //FORT_AGENT_OBSERVESUBSCRIPTIONS_H
@@ -0,0 +1,74 @@
+#ifndef FORT_AGENT_RESPONSEDISPATCHER_H
+#define FORT_AGENT_RESPONSEDISPATCHER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fort_agent/coapHelpers.h>
+#include <fort_agent/histogram.h>
+
+/* Routes CoAP responses that the agent requested on its own behalf to the component that consumes
+ * them, instead of forwarding them to a UDP client.
+ *
+ * Requests sent with UartCoapBridge::sendSRCRequest carry a tracking id in place of a UDP port.
+ * Ids in [firstId, firstId + capacity) belong to the dispatcher: owns() is a range check and
+ * dispatch() indexes a table by id, so the cost is the same for every resource.  Components
+ * register a handler per id and receive the already parsed message; each handler's call count and
+ * processing time are recorded automatically.
+ */
+class ResponseDispatcher {
+public:
+    typedef std::function<void(const Coap::MessageView &)> Handler;
+
+    static constexpr size_t capacity = 200;
+
+    explicit ResponseDispatcher(uint16_t firstId);
+
+    ResponseDispatcher(const ResponseDispatcher &) = delete;
+
+    ResponseDispatcher &operator=(const ResponseDispatcher &) = delete;
+
+    // Throws std::invalid_argument if the id is outside the table or already has a handler.
+    // Safe to call while other threads dispatch.
+    void registerHandler(uint16_t id, std::string name, Handler handler);
+
+    bool owns(uint16_t id) const { return id >= first && static_cast<size_t>(id - first) < capacity; }
+
+    // Hand an owned message to its handler.  Messages for ids without a handler are counted and
+    // dropped.  Throws a CoapException if the message can't be parsed.
+    void dispatch(uint16_t id, const uint8_t *message, size_t len);
+
+    uint64_t callCount(uint16_t id) const;
+
+    uint64_t unhandledCount() const { return unhandled.load(std::memory_order_relaxed); }
+
+    // Per-handler counts and timing for the stats dump
+    void reportStats() const;
+
+private:
+    struct Entry {
+        uint16_t id;
+        std::string name;
+        Handler handler;
+        std::atomic<uint64_t> calls{0};
+        Histogram processingUs;
+    };
+
+    const uint16_t first;
+
+    // Entries are published once and never replaced, so dispatch only needs an acquire load
+    std::array<std::atomic<Entry *>, capacity> table{};
+    std::mutex registerMutex;
+    std::vector<std::unique_ptr<Entry>> entries;
+
+    std::atomic<uint64_t> unhandled{0};
+};
+
+#endif //FORT_AGENT_RESPONSEDISPATCHER_H
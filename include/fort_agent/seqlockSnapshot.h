@@ -0,0 +1,71 @@
+#ifndef FORT_AGENT_SEQLOCKSNAPSHOT_H
+#define FORT_AGENT_SEQLOCKSNAPSHOT_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/* Latest value of a small trivially copyable record, written by any thread and read by any number
+ * of readers without locks.
+ *
+ * A sequence lock: the sequence is odd while a write is in progress, and a reader retries until it
+ * copied the value between two equal even sequences.  Writers never wait on readers, so a message
+ * callback pays one copy per report; readers only retry if they overlap a write.  The value is
+ * held in atomic words so the concurrent copy is well defined.  Concurrent writers take turns on
+ * the sequence.
+ */
+template<typename T>
+class SeqlockSnapshot {
+    static_assert(std::is_trivially_copyable<T>::value, "snapshots are copied word by word");
+
+public:
+    void store(const T &value) {
+        uint64_t words[wordCount] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        uint64_t sequence = seq.load(std::memory_order_relaxed);
+        do {
+            sequence &= ~uint64_t(1);
+        } while (!seq.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire,
+                                            std::memory_order_relaxed));
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < wordCount; i++) {
+            data[i].store(words[i], std::memory_order_relaxed);
+        }
+        seq.store(sequence + 2, std::memory_order_release);
+    }
+
+    // False if nothing was stored yet
+    bool load(T &value) const {
+        uint64_t words[wordCount];
+        uint64_t before;
+        uint64_t after;
+        do {
+            before = seq.load(std::memory_order_acquire);
+            for (size_t i = 0; i < wordCount; i++) {
+                words[i] = data[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = seq.load(std::memory_order_relaxed);
+        } while (before != after || (before & 1) != 0);
+
+        if (before == 0) {
+            return false;
+        }
+        std::memcpy(&value, words, sizeof(T));
+        return true;
+    }
+
+    // Number of stores so far, e.g. to tell whether anything changed since the last render
+    uint64_t version() const { return seq.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr size_t wordCount = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint64_t> seq{0};
+    std::array<std::atomic<uint64_t>, wordCount> data{};
+};
+
+#endif //FORT_AGENT_SEQLOCKSNAPSHOT_H
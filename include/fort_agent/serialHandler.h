@@ -1,6 +1,8 @@
 #ifndef FORT_AGENT_SERIALHANDLER_H
 #define FORT_AGENT_SERIALHANDLER_H
 
+#include <vector>
+
 #include <boost/asio.hpp>
 #include <boost/asio/high_resolution_timer.hpp>
 #include <boost/asio/serial_port.hpp>
@@ -8,6 +10,7 @@
 
 #include <fort_agent/dbgTrace.h>
 #include <fort_agent/slip.h>
+#include <fort_agent/timedStrand.h>
 
 
 enum class State {
@@ -19,26 +22,49 @@ enum class State {
 
 typedef std::function<void(const std::string &)> errorCb;
 typedef std::function<void(uint8_t *, uint32_t)> dataCb;
+typedef std::function<void()> readDoneCb;
+typedef std::function<void()> writeReadyCb;
 
 class SerialHandler {
 public:
     SerialHandler(boost::asio::io_service &ioService,
                   const std::string &serialPath,
                   errorCb onFailure,
-                  dataCb onData);
+                  dataCb onData,
+                  readDoneCb onReadDone = nullptr,
+                  writeReadyCb onWriteReady = nullptr,
+                  size_t mtu = FORT_AGENT_BUFFER_UNIT_SZ);
 
+    // Sends the message as one SLIP frame, false if it is longer than mtu() or doesn't fit in the
+    // TX buffer.  Must be called on strand(); other strands hand messages over with strand().post()
     bool asyncSendMessageToSerialPort(const void *dataBytes, size_t dataLen);
 
+    // True when a message of dataLen bytes would fit in the TX buffer even if every byte needed
+    // escaping, or the buffer is empty.  Must be called on strand().
+    bool canSend(size_t dataLen) const;
+
+    // Largest message sent or received in one SLIP frame
+    size_t mtu() const { return frameSize; }
+
+    // Raw link throughput, 10 bits on the wire per byte
+    static constexpr size_t linkBytesPerSecond() { return baudRate / 10; }
+
+    // All serial RX/TX handlers, including onData and onReadDone, run on this strand
+    TimedStrand &strand() { return serialStrand; }
+
 private:
 
     boost::asio::io_service &service;
     boost::asio::serial_port serial;
+    TimedStrand serialStrand;
     static constexpr int baudRate = 115200;
     static constexpr boost::asio::serial_port_base::flow_control::type flowControl = boost::asio::serial_port_base::flow_control::none;
 
     State state;
 
-    std::array<uint8_t, FORT_AGENT_BUFFER_UNIT_SZ> readTempBuffer;
+    const size_t frameSize;
+
+    std::vector<uint8_t> readTempBuffer;
     boost::circular_buffer<uint8_t> readBuffer;
     boost::circular_buffer<uint8_t> writeBuffer;
     bool writeInProgress;
@@ -46,6 +72,10 @@ private:
     // Callbacks
     errorCb onFailure;
     dataCb onData;
+    // Invoked once every frame decoded from a single serial read has been passed to onData
+    readDoneCb onReadDone;
+    // Invoked after each completed write, when TX buffer space has been freed
+    writeReadyCb onWriteReady;
 
     // Operational
     void enterOperationalState();
@@ -65,12 +95,13 @@ private:
     void asyncWriteToSerialPortCb(const boost::system::error_code &ec,
                                   size_t bytes_transferred);
 
-    static constexpr size_t RX_BUFFER_SIZE = FORT_AGENT_BUFFER_UNIT_SZ;
-    static constexpr size_t TX_BUFFER_SIZE = FORT_AGENT_BUFFER_UNIT_SZ;
+    // Buffers are sized from the MTU: RX holds one frame, TX two worst case encoded frames
+    static constexpr size_t txFramesBuffered = 2;
 
     FortAgentSlip::slip_descriptor_s slip_desc;
     FortAgentSlip::slip_handler_s slip_handle;
-    uint8_t slip_buffer[FORT_AGENT_BUFFER_UNIT_SZ];
+    std::vector<uint8_t> slip_buffer;
+    std::vector<uint8_t> encodeBuffer;
 
 
 };
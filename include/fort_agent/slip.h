@@ -6,12 +6,20 @@
 
 #include <fort_agent/dbgTrace.h>
 
+// Default MTU: largest CoAP message carried in one SLIP frame or UDP datagram
 #define FORT_AGENT_BUFFER_UNIT_SZ 512
 
 namespace FortAgentSlip {
+    // Worst case encoded size of a message: every byte escaped plus the END bytes either side
+    constexpr uint32_t slipEncodedMaxSize(uint32_t length) {
+        return 2 * length + 2;
+    }
+
+    // dataToBeSent must hold slipEncodedMaxSize(length) bytes.  Returns 0 if length exceeds mtu.
     uint32_t
     createSlipEncodedMessage(uint8_t *dataToBeSent, const uint8_t *const data,
-                             uint32_t length);
+                             uint32_t length,
+                             uint32_t mtu = FORT_AGENT_BUFFER_UNIT_SZ);
     // https://github.com/marcinbor85/slip
 
 #define SLIP_SPECIAL_BYTE_END           0xC0
@@ -0,0 +1,76 @@
+#ifndef FORT_AGENT_SPSCRING_H
+#define FORT_AGENT_SPSCRING_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/* Bounded lock-free ring for handing items from exactly one producer thread to exactly one consumer
+ * thread.
+ *
+ * push() and pop() are wait-free: the head and tail indices are published with release/acquire and
+ * each side keeps a cached copy of the other side's index, so the shared cache lines are only read
+ * when the ring looks full or empty.  Items are copied into preallocated slots; nothing allocates
+ * after construction.  A "single producer" may be an asio strand, since the strand orders its
+ * handlers even when they run on different threads.
+ */
+template<typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    static constexpr size_t capacity = Capacity;
+
+    // Producer only, false when the ring is full
+    bool push(const T &item) {
+        const size_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail - cachedHead == Capacity) {
+            cachedHead = headIndex.load(std::memory_order_acquire);
+            if (tail - cachedHead == Capacity) {
+                return false;
+            }
+        }
+        slots[tail & mask] = item;
+        tailIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only, false when the ring is empty
+    bool pop(T &item) {
+        const size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == cachedTail) {
+            cachedTail = tailIndex.load(std::memory_order_acquire);
+            if (head == cachedTail) {
+                return false;
+            }
+        }
+        item = slots[head & mask];
+        headIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Exact from either end, approximate from any other thread
+    size_t size() const {
+        const size_t head = headIndex.load(std::memory_order_acquire);
+        const size_t tail = tailIndex.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    bool empty() const { return size() == 0; }
+
+private:
+    static constexpr size_t mask = Capacity - 1;
+    static constexpr size_t cacheLine = 64;
+
+    // Consumer side
+    alignas(cacheLine) std::atomic<size_t> headIndex{0};
+    size_t cachedTail = 0;
+
+    // Producer side
+    alignas(cacheLine) std::atomic<size_t> tailIndex{0};
+    size_t cachedHead = 0;
+
+    alignas(cacheLine) std::array<T, Capacity> slots{};
+};
+
+#endif //FORT_AGENT_SPSCRING_H
@@ -0,0 +1,59 @@
+#ifndef FORT_AGENT_TIMEDSTRAND_H
+#define FORT_AGENT_TIMEDSTRAND_H
+
+#include <chrono>
+#include <string>
+#include <utility>
+
+#include <boost/asio.hpp>
+
+#include <fort_agent/histogram.h>
+
+/* An io_service strand that remembers how long posted work waited before it ran.
+ *
+ * Each independent part of the forwarding path (serial port, UDP socket, CoAP tracker) owns one of
+ * these so its handlers never run concurrently with each other, while the different parts can run
+ * on different worker threads.  Completion handlers for async operations are bound with wrap();
+ * work handed over from another strand goes through post(), which records the queue latency.
+ */
+class TimedStrand {
+public:
+    TimedStrand(boost::asio::io_service &service, std::string name) :
+        strand(service),
+        label(std::move(name)),
+        latencyUs() {}
+
+    TimedStrand(const TimedStrand &) = delete;
+
+    TimedStrand &operator=(const TimedStrand &) = delete;
+
+    template<typename Handler>
+    void post(Handler &&handler) {
+        const auto queued = std::chrono::steady_clock::now();
+        boost::asio::post(strand,
+                          [this, queued, work = std::forward<Handler>(handler)]() mutable {
+                              latencyUs.record(std::chrono::duration_cast<std::chrono::microseconds>(
+                                  std::chrono::steady_clock::now() - queued).count());
+                              work();
+                          });
+    }
+
+    template<typename Handler>
+    auto wrap(Handler &&handler) {
+        return boost::asio::bind_executor(strand, std::forward<Handler>(handler));
+    }
+
+    bool runningInThisThread() const { return strand.running_in_this_thread(); }
+
+    const std::string &name() const { return label; }
+
+    // Time between post() and the handler starting, in microseconds
+    const Histogram &queueLatency() const { return latencyUs; }
+
+private:
+    boost::asio::io_service::strand strand;
+    const std::string label;
+    Histogram latencyUs;
+};
+
+#endif //FORT_AGENT_TIMEDSTRAND_H
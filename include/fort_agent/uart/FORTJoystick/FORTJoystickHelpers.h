@@ -4,10 +4,14 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <cstddef> 
 #include <string>
 
+#include <fort_agent/uart/FORTJoystick/JoystickDisplay.h>
+
 /** Number of data bits used in calibrated joystick samples. */
 #define CALIBRATED_JS_DATA_BITS (12)
 /** Remaining bit count dedicated to flags and reserved padding. */
@@ -94,6 +98,30 @@ inline bool isButtonPressed(uint16_t status, KeypadButton button) {
     return (status & static_cast<uint16_t>(button)) != 0;
 }
 
+/** Calibrated axis full scale, the most negative raw value is clamped to -JOYSTICK_RAW_MAX. */
+constexpr int JOYSTICK_RAW_MAX = (1 << (CALIBRATED_JS_DATA_BITS - 1)) - 1;
+constexpr size_t JOYSTICK_RAW_COUNT = 1 << CALIBRATED_JS_DATA_BITS;
+
+/** Linear map of a clamped raw axis value onto [-100, 100] percent. */
+constexpr double joystickPercentOf(int raw) {
+    return std::max(-JOYSTICK_RAW_MAX, std::min(raw, JOYSTICK_RAW_MAX)) * (100.0 / JOYSTICK_RAW_MAX);
+}
+
+/** joystickPercentOf() for every 12-bit raw value, indexed by raw + 2048, computed at compile time. */
+inline constexpr std::array<double, JOYSTICK_RAW_COUNT> joystickPercentTable = [] {
+    std::array<double, JOYSTICK_RAW_COUNT> table{};
+    for (size_t i = 0; i < table.size(); i++) {
+        table[i] = joystickPercentOf(static_cast<int>(i) - JOYSTICK_RAW_MAX - 1);
+    }
+    return table;
+}();
+
+/** Axis value in percent, a table lookup instead of floating point math per sample. */
+inline double joystickPercent(int raw) {
+    raw = std::max(-JOYSTICK_RAW_MAX - 1, std::min(raw, JOYSTICK_RAW_MAX));
+    return joystickPercentTable[raw + JOYSTICK_RAW_MAX + 1];
+}
+
 /** Dump joystick and keypad state to stdout for debugging. */
 void printJoystickStatus(const frc_combined_data_t& js);
 /** Compute CRC-16 used by joystick and keypad payloads. */
@@ -103,7 +131,9 @@ bool decode_combined_payload(const uint8_t* data, size_t size);
 /** Extract battery telemetry values from a CBOR payload. */
 BatteryStatus decode_battery_payload(const uint8_t* payload, size_t size);
 
-/** Render text on the SRC Pro user display. */
+/** Render text on the upper half of the SRC Pro user display, sent by the next due flush. */
 void displayTextOnJoystick(const std::string& text, const std::string& subtext);
+/** The display model behind displayTextOnJoystick, flushed from the JAUS service thread. */
+JoystickDisplay& joystickDisplay();
 /** Trigger joystick vibration motors. */
 void vibrateJoystick(bool leftMotor, bool rightMotor);
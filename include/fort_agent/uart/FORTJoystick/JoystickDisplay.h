@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+/**
+ * @brief Model of the SRC Pro user display that only sends what changed.
+ *
+ * The display has four 18-character lines, written either as 6-character segments or as a
+ * two-line half.  Callers set the text they want on screen; nothing is sent until the first
+ * change has waited out the coalescing window, so a burst of state changes only sends the last
+ * text.  flush() then compares the wanted text with what the screen is known to show and sends
+ * the changed segments, or the whole half when that is fewer bytes on the serial link.  The
+ * display mode is only switched when it differs from the last one sent.
+ *
+ * Single threaded, except invalidate(), which may be called from any thread, e.g. when the SRC
+ * Pro restarted and the screen contents are unknown.
+ */
+class JoystickDisplay {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t lineCount = 4;
+    static constexpr size_t segmentCount = 3;
+    static constexpr size_t segmentWidth = 6;
+    static constexpr size_t lineWidth = segmentCount * segmentWidth;
+
+    /** Where flush() sends its updates, normally the coapSRCPro display requests. */
+    struct Sink {
+        std::function<void(uint8_t mode)> mode;
+        std::function<void(uint8_t line, uint8_t segment, const std::string& text6)> segment;
+        std::function<void(const std::string& line0, const std::string& line1, bool upperHalf)> half;
+    };
+
+    struct Stats {
+        uint64_t requests;      /**< setText() calls */
+        uint64_t unchanged;     /**< requests for text already wanted */
+        uint64_t coalesced;     /**< changes merged into an update already waiting */
+        uint64_t segments;      /**< segment writes sent */
+        uint64_t halves;        /**< two-line writes sent */
+        uint64_t modeSwitches;  /**< mode writes sent */
+        uint64_t modeSkipped;   /**< mode requests already in effect */
+    };
+
+    JoystickDisplay(Sink sink, Clock::duration window);
+
+    /** Switch the display mode, sent with the next flush unless already in effect. */
+    void setMode(uint8_t mode, Clock::time_point now = Clock::now());
+
+    /** Show line0 and line1 on the upper or lower half, padded or cut to lineWidth. */
+    void setText(bool upperHalf, const std::string& line0, const std::string& line1,
+                 Clock::time_point now = Clock::now());
+
+    /** When pending changes are due, Clock::time_point::max() when there are none. */
+    Clock::time_point deadline() const;
+
+    /**
+     * Send the pending changes once the window has passed.
+     * @return true if anything was sent.
+     */
+    bool flush(Clock::time_point now = Clock::now());
+
+    /** Forget what the screen shows, so the next flush rewrites it.  Safe from any thread. */
+    void invalidate();
+
+    Stats stats() const;
+
+private:
+    using Line = std::array<char, lineWidth>;
+
+    Sink sink;
+    const Clock::duration window;
+
+    std::array<Line, lineCount> wanted;
+    std::array<Line, lineCount> shown;
+    bool shownKnown = false;
+    int wantedMode = -1;
+    int shownMode = -1;
+    // Time of the first change not sent yet, max() when everything is sent
+    Clock::time_point pendingSince = Clock::time_point::max();
+    std::atomic<bool> invalidated{false};
+
+    std::atomic<uint64_t> requestCount{0};
+    std::atomic<uint64_t> unchangedCount{0};
+    std::atomic<uint64_t> coalescedCount{0};
+    std::atomic<uint64_t> segmentWrites{0};
+    std::atomic<uint64_t> halfWrites{0};
+    std::atomic<uint64_t> modeWrites{0};
+    std::atomic<uint64_t> modeSkippedCount{0};
+
+    void markPending(Clock::time_point now);
+    void flushHalf(size_t firstLine);
+};
@@ -5,9 +5,36 @@
 #include <boost/asio/serial_port.hpp>
 
 #include <fort_agent/dbgTrace.h>
+#include <fort_agent/clientAdmission.h>
+#include <fort_agent/coapObserveHub.h>
 #include <fort_agent/coapPortTracker.h>
+#include <fort_agent/coapRequestCollapser.h>
+#include <fort_agent/coapResponseCache.h>
+#include <fort_agent/datagramPool.h>
+#include <fort_agent/fairScheduler.h>
+#include <fort_agent/histogram.h>
+#include <fort_agent/linkMonitor.h>
+#include <fort_agent/responseDispatcher.h>
 #include <fort_agent/serialHandler.h>
 #include <fort_agent/spammyLogMsg.h>
+#include <fort_agent/timedStrand.h>
+
+// Optional bridge behaviour, filled in from fort-agent.conf
+struct UartCoapBridgeSettings {
+    // GET cache lifetime per resource ("cfg/setup/serialNumber", "deviceInfo?fwVersion"), overrides Max-Age
+    CoapResponseCache::TtlMap cacheTtls;
+
+    // Serial link budget per client in bytes/s, 0 shares the link evenly between active clients
+    double clientRate = 0;
+    // Bytes a client may send in a burst above its rate
+    size_t clientBurst = 2048;
+
+    // Largest CoAP message accepted over UDP and carried in one SLIP frame, must match the SRC Pro
+    size_t mtu = FORT_AGENT_BUFFER_UNIT_SZ;
+
+    // CoAP ping interval and RX silence threshold for the serial link health monitor
+    LinkMonitor::Settings linkHealth;
+};
 
 class UartCoapBridge {
 public:
@@ -17,14 +44,27 @@ public:
         uint16_t localPort,
         const std::string &serialPath,
         const std::string &remoteAddr,
-        uint16_t remotePort
+        uint16_t remotePort,
+        const UartCoapBridgeSettings &settings = {}
     );
 
     ~UartCoapBridge() = default;
 
-    // This function directly send to the SRC, it will manage the token creation
+    // This function directly send to the SRC, it will manage the token creation.
+    // Safe to call from any thread, the message is handed to the tracker and serial strands.
     void sendSRCRequest(const std::vector<uint8_t> &coapMsg, const uint16_t port);
 
+    // Handlers for responses to sendSRCRequest, keyed by the port passed there.  Handlers run on
+    // the CoAP tracker strand.
+    ResponseDispatcher &responses() { return responseDispatcher; }
+
+    // The strand those handlers run on, for components that hand follow-up work back to it
+    TimedStrand &responseStrand() { return coapPorts.strand(); }
+
+    // Called on the serial strand when the link monitor sees the SRC Pro go silent or come back.
+    // Must be called during start-up, before the io_service begins running.
+    void addLinkListener(LinkMonitor::EventFn listener);
+
 private:
     // Reference to the boost asio service
     boost::asio::io_service &ioService;
@@ -36,13 +76,21 @@ private:
 
     void serialDataReceived(uint8_t *message, uint32_t size);
 
+    void serialReadDone();
+
+    // Feed the serial handler from serialScheduler while it has room, run on the serial strand
+    void serialWriteReady();
+
+    // Pings the SRC Pro and watches for RX silence, runs on the serial strand
+    std::unique_ptr<LinkMonitor> linkMonitor;
+    std::vector<LinkMonitor::EventFn> linkListeners;
+
     // Listen on local UDP port
     uint16_t listenPort;
     boost::asio::ip::address localHost;
     boost::asio::ip::udp::endpoint localEndpoint;
     boost::asio::ip::udp::socket localSocket;
     boost::asio::deadline_timer localBindRetryTimer;
-    boost::asio::ip::udp::endpoint from;  // Dummy variable used by async_recv_from, when receiving UDP from local clients
     static constexpr int localBindRetrySeconds = 5;
     boost::asio::ip::address remoteHost;
 
@@ -50,17 +98,128 @@ private:
 
     void receiveFromRemote();
 
+    // Read every datagram currently queued on the socket, in batches of udpBatchSize
+    void drainLocalSocket();
+
+    bool acceptFromRemote(const boost::asio::ip::udp::endpoint &from);
+
     void sendToRemote(boost::asio::ip::udp::endpoint to,
-                      std::shared_ptr<uint8_t[]> data, std::size_t length);
+                      DatagramPtr data, std::size_t length);
+
+    // Datagram buffers shared by UDP RX/TX and serial RX, sized for one MTU plus tracking tokens
+    const size_t mtu;
+    static constexpr size_t trackingTokenHeadroom = 3;
+    static constexpr size_t datagramPoolSize = 64;
+    DatagramPool datagramPool;
+
+    /* Datagrams are handed between strands a batch at a time:
+     *
+     *   serial strand  --serialRxBatch-->  tracker strand (serialToUdp, local responses)  -->  UDP strand (sendmmsg)
+     *   UDP strand (recvmmsg)  -->  tracker strand (udpToSerial)  -->  serial strand (SLIP encode, write)
+     *
+     * so each strand owns the state it touches and nothing on the forwarding path takes a lock.
+     */
+    struct PendingDatagram {
+        boost::asio::ip::udp::endpoint to;  // remote client, or the sender for UDP RX
+        DatagramPtr data;
+        std::size_t length;
+    };
+    static constexpr size_t udpBatchSize = 16;
+    struct DatagramBatch {
+        std::array<PendingDatagram, udpBatchSize> entries;
+        size_t count = 0;
+
+        bool full() const { return count == udpBatchSize; }
+
+        void push(boost::asio::ip::udp::endpoint to, DatagramPtr data, std::size_t length) {
+            entries[count++] = {to, std::move(data), length};
+        }
+    };
+
+    // Frames decoded from the current serial read, owned by the serial strand
+    DatagramBatch serialRxBatch;
+
+    void handOffSerialBatch();
+
+    // Run on the tracker strand
+    void processSerialBatch(DatagramBatch &batch);
+
+    void processRemoteBatch(DatagramBatch &batch);
+
+    // Run on the serial strand.  Queue a tracked frame for its port; if that queue is full, log it
+    // and, for a request, add a 5.03 answering it to refused.  False if the frame was refused.
+    bool queueForSerial(const boost::asio::ip::udp::endpoint &to, DatagramPtr &&data, size_t length,
+                        DatagramBatch &refused);
+
+    // Hand the 5.03s from queueForSerial to the tracker strand, routed back like device responses
+    void returnRefused(DatagramBatch &refused);
+
+    // Run on the UDP strand.  Device responses: feed the cache, observe hub and collapsed
+    // requests, then send
+    void flushToRemote(DatagramBatch &batch);
+
+    // Run on the UDP strand.  Send as is, for replies built locally and copies of device responses
+    void sendBatchToRemote(DatagramBatch &batch);
+
+    // Answer a GET from the response cache, queueing the reply into replies
+    bool serveFromCache(const boost::asio::ip::udp::endpoint &from, const DatagramPtr &data,
+                        std::size_t length, DatagramBatch &replies);
+
+    // Caching proxy for client GETs, owned by the UDP strand
+    CoapResponseCache responseCache;
+    std::vector<uint8_t> cacheReply;
+
+    // Parks GETs identical to one already waiting on the device, owned by the UDP strand
+    CoapRequestCollapser requestCollapser;
+
+    // Copy each parked client's answer out of the leader responses in batch
+    void fanOutResponses(const DatagramBatch &batch);
+
+    // One device Observe subscription per resource shared by all observers, owned by the UDP strand
+    CoapObserveHub observeHub;
+
+    // Let the observe hub handle a registration, deregistration or RST from a client
+    bool shareObservation(const boost::asio::ip::udp::endpoint &from, const DatagramPtr &data,
+                          std::size_t length, DatagramBatch &replies, DatagramBatch &toSerial);
+
+    // Take the device's messages to the observe hub out of batch and replicate them to observers
+    void replicateNotifications(DatagramBatch &batch);
+
+    // Copy message into a pooled buffer queued for port, dropped if it doesn't fit
+    void queueMessage(DatagramBatch &batch, uint16_t port, const std::vector<uint8_t> &message);
+
+    // Token bucket per client in front of the serial link, owned by the UDP strand
+    ClientAdmission admission;
+
+    // Answer a request over its client's budget with 5.03 and a Max-Age instead of forwarding it
+    bool shedOverload(const boost::asio::ip::udp::endpoint &from, const DatagramPtr &data,
+                      std::size_t length, DatagramBatch &replies);
+
+    // Round robin between clients for the serial TX buffer, owned by the serial strand
+    FairScheduler serialScheduler;
+
+    // Owns localSocket, localBindRetryTimer, responseCache, requestCollapser, observeHub, admission
+    // and failedToSendToRemote
+    TimedStrand udpStrand;
+
+    Histogram rxBatchSizes;
+    Histogram txBatchSizes;
+
+    void reportStats();
 
     // Relay received CoAP messages to the right client
     CoapPortTracker coapPorts;
 
+    // Responses the agent consumes itself instead of forwarding
+    ResponseDispatcher responseDispatcher;
+
     // Reduce repetitive log spam
     SpammyLogMsg failedToBindLocal;
     SpammyLogMsg failedToReceiveFromRemote;
     SpammyLogMsg failedToSendSerial;
     SpammyLogMsg failedToListenSerial;
+    SpammyLogMsg failedToForwardSerial;
+    SpammyLogMsg serialQueueFull;   // serial strand
 
     std::map<uint16_t, SpammyLogMsg> failedToSendToRemote;
 
@@ -9,7 +9,8 @@ public:
         uint16_t localPort,
         const std::string& serialPath,
         const std::string& remoteAddr,
-        uint16_t remotePort
+        uint16_t remotePort,
+        const UartCoapBridgeSettings& settings = {}
     );
 
     static UartCoapBridge& instance(); // safe overload
@@ -0,0 +1,120 @@
+#ifndef FORT_AGENT_WAKESIGNAL_H
+#define FORT_AGENT_WAKESIGNAL_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if !defined(__linux__)
+#include <condition_variable>
+#include <mutex>
+#endif
+
+/* Puts one consumer thread to sleep until a producer has published work, for use with a lock-free
+ * queue such as SpscRing.
+ *
+ * The consumer calls waitUntil() with a predicate that checks its queues.  It polls the predicate
+ * for up to spinFor first, which avoids a sleep and wake-up when work arrives within microseconds,
+ * then sleeps on an eventfd (a mutex and condition variable elsewhere).  Producers call notify()
+ * after publishing; it only makes a system call when the consumer is actually asleep.
+ */
+class WakeSignal {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Stats {
+        uint64_t sleeps;        // times the consumer blocked
+        uint64_t wakeups;       // notify() calls that had to wake it
+        uint64_t spinHits;      // waits satisfied while spinning
+    };
+
+    WakeSignal();
+
+    ~WakeSignal();
+
+    WakeSignal(const WakeSignal &) = delete;
+
+    WakeSignal &operator=(const WakeSignal &) = delete;
+
+    // Producer side, call after publishing work.  Safe from any thread.
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_relaxed)) {
+            wakeupCount.fetch_add(1, std::memory_order_relaxed);
+            signal();
+        }
+    }
+
+    // Consumer side: returns true as soon as ready() does, false once deadline has passed
+    template<typename Ready>
+    bool waitUntil(Clock::time_point deadline, Ready ready,
+                   std::chrono::microseconds spinFor = std::chrono::microseconds(0)) {
+        if (ready()) {
+            return true;
+        }
+
+        if (spinFor.count() > 0) {
+            const Clock::time_point spinUntil = std::min(deadline, Clock::now() + spinFor);
+            do {
+                if (ready()) {
+                    spinHitCount.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+                pause();
+            } while (Clock::now() < spinUntil);
+        }
+
+        for (;;) {
+            sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (ready()) {
+                sleeping.store(false, std::memory_order_relaxed);
+                return true;
+            }
+            sleepCount.fetch_add(1, std::memory_order_relaxed);
+            const bool signalled = sleepUntil(deadline);
+            sleeping.store(false, std::memory_order_relaxed);
+            if (ready()) {
+                return true;
+            }
+            if (!signalled) {
+                return false;
+            }
+        }
+    }
+
+    Stats stats() const {
+        return {sleepCount.load(std::memory_order_relaxed), wakeupCount.load(std::memory_order_relaxed),
+                spinHitCount.load(std::memory_order_relaxed)};
+    }
+
+private:
+    void signal();
+
+    // False when the deadline passed without a signal
+    bool sleepUntil(Clock::time_point deadline);
+
+    static void pause() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    std::atomic<bool> sleeping{false};
+    std::atomic<uint64_t> sleepCount{0};
+    std::atomic<uint64_t> wakeupCount{0};
+    std::atomic<uint64_t> spinHitCount{0};
+
+#if defined(__linux__)
+    int eventFd;
+#else
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool signalled = false;
+#endif
+};
+
+#endif //FORT_AGENT_WAKESIGNAL_H
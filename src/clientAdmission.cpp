@@ -0,0 +1,96 @@
+#include <fort_agent/clientAdmission.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr size_t pruneThreshold = 64;
+    constexpr auto recountInterval = std::chrono::milliseconds(100);
+}
+
+ClientAdmission::ClientAdmission(double linkBytesPerSecond, double clientBytesPerSecond, size_t burstBytes,
+                                 std::chrono::milliseconds activeWindow) :
+    linkRate(linkBytesPerSecond),
+    clientRate(clientBytesPerSecond),
+    burst(static_cast<double>(burstBytes)),
+    window(activeWindow),
+    clientsMutex(),
+    clients(),
+    activeClients(1),
+    activeCounted() {
+}
+
+uint32_t ClientAdmission::admit(uint16_t port, size_t length, Clock::time_point now) {
+    const double rate = shareFor(now);
+    Client &c = client(port, now);
+
+    const double elapsed = std::chrono::duration<double>(now - c.refilled).count();
+    c.tokens = std::min(burst, c.tokens + elapsed * rate);
+    c.refilled = now;
+    c.lastSeen = now;
+
+    // a request bigger than the whole bucket is let through once the bucket is full
+    const double cost = std::min(static_cast<double>(length), burst);
+    if (c.tokens >= cost) {
+        c.tokens -= cost;
+        c.admitted.fetch_add(1, std::memory_order_relaxed);
+        c.admittedBytes.fetch_add(length, std::memory_order_relaxed);
+        return 0;
+    }
+
+    c.rejected.fetch_add(1, std::memory_order_relaxed);
+    return std::max<uint32_t>(1, static_cast<uint32_t>(std::ceil((cost - c.tokens) / rate)));
+}
+
+std::vector<ClientAdmission::ClientStats> ClientAdmission::stats() const {
+    std::lock_guard<std::mutex> lock(clientsMutex);
+    std::vector<ClientStats> result;
+    result.reserve(clients.size());
+    for (const auto &entry : clients) {
+        result.push_back({entry.first, entry.second->admitted.load(std::memory_order_relaxed),
+                          entry.second->admittedBytes.load(std::memory_order_relaxed),
+                          entry.second->rejected.load(std::memory_order_relaxed)});
+    }
+    std::sort(result.begin(), result.end(),
+              [](const ClientStats &a, const ClientStats &b) { return a.port < b.port; });
+    return result;
+}
+
+ClientAdmission::Client &ClientAdmission::client(uint16_t port, Clock::time_point now) {
+    auto it = clients.find(port);
+    if (it != clients.end()) {
+        return *it->second;
+    }
+
+    std::lock_guard<std::mutex> lock(clientsMutex);
+    if (clients.size() >= pruneThreshold) {
+        // forget clients that have been quiet for a while, they start again with a full bucket
+        for (auto stale = clients.begin(); stale != clients.end();) {
+            if (now - stale->second->lastSeen > window) {
+                stale = clients.erase(stale);
+            } else {
+                stale++;
+            }
+        }
+    }
+
+    auto created = std::make_unique<Client>();
+    created->tokens = burst;
+    created->refilled = now;
+    created->lastSeen = now;
+    return *clients.emplace(port, std::move(created)).first->second;
+}
+
+double ClientAdmission::shareFor(Clock::time_point now) {
+    if (clientRate > 0) {
+        return clientRate;
+    }
+
+    if (now - activeCounted >= recountInterval) {
+        activeClients = std::max<size_t>(1, std::count_if(clients.begin(), clients.end(), [&](const auto &entry) {
+            return now - entry.second->lastSeen <= window;
+        }));
+        activeCounted = now;
+    }
+    return linkRate / static_cast<double>(activeClients);
+}
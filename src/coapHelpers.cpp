@@ -1,4 +1,7 @@
 #include <fort_agent/coapHelpers.h>
+
+#include <algorithm>
+
 #include <spdlog/fmt/ostr.h>
 #include <boost/crc.hpp>
 
@@ -89,10 +92,29 @@ std::array<uint8_t, 4> Coap::createResetMsg(uint16_t mid) {
                                   static_cast<uint8_t>(mid & 0xff)};
 }
 
+size_t Coap::createServiceUnavailable(const uint8_t *request, uint32_t maxAge, uint8_t *out) {
+    const uint8_t tokenLength = getTokenLength(request);
+    const bool confirmable = getCoapType(request) == Type::CON;
+    // ACK to a CON, NON otherwise, code 5.03, same MID and token
+    out[0] = static_cast<uint8_t>((1 << 6) | (confirmable ? 0x20 : 0x10) | tokenLength);
+    out[1] = 0xA3;
+    out[2] = request[2];
+    out[3] = request[3];
+    std::copy_n(request + COAP_TOKEN_START_INDEX, tokenLength, out + COAP_TOKEN_START_INDEX);
+    size_t length = COAP_TOKEN_START_INDEX + tokenLength;
+    out[length++] = 0xD4;  // Max-Age (14): delta 13 + 1 extended byte, 4 byte value
+    out[length++] = 14 - 13;
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out[length++] = static_cast<uint8_t>(maxAge >> shift);
+    }
+    return length;
+}
+
 
 static void encodeOption(std::vector<uint8_t>& out,
                          uint16_t number,
-                         const std::string& value,
+                         const uint8_t* value,
+                         size_t valueLen,
                          uint16_t& lastNumber) {
     uint16_t delta = number - lastNumber;
     lastNumber = number;
@@ -109,7 +131,7 @@ static void encodeOption(std::vector<uint8_t>& out,
 
     uint8_t deltaNibble, lenNibble;
     encodeExtended(delta, deltaNibble);
-    encodeExtended(value.size(), lenNibble);
+    encodeExtended(valueLen, lenNibble);
 
     out.push_back((deltaNibble << 4) | lenNibble);
 
@@ -121,14 +143,21 @@ static void encodeOption(std::vector<uint8_t>& out,
     }
 
     // Extended length
-    if (lenNibble == 13) out.push_back(value.size() - 13);
+    if (lenNibble == 13) out.push_back(valueLen - 13);
     else if (lenNibble == 14) {
-        out.push_back((value.size() - 269) >> 8);
-        out.push_back((value.size() - 269) & 0xFF);
+        out.push_back((valueLen - 269) >> 8);
+        out.push_back((valueLen - 269) & 0xFF);
     }
 
     // Value bytes
-    out.insert(out.end(), value.begin(), value.end());
+    out.insert(out.end(), value, value + valueLen);
+}
+
+static void encodeOption(std::vector<uint8_t>& out,
+                         uint16_t number,
+                         const std::string& value,
+                         uint16_t& lastNumber) {
+    encodeOption(out, number, reinterpret_cast<const uint8_t*>(value.data()), value.size(), lastNumber);
 }
 
 static void encodeUintOption(std::vector<uint8_t>& out,
@@ -242,6 +271,197 @@ std::vector<uint8_t> Coap::buildMessage(Type type, Method method, uint16_t mid,
 }
 
 
+size_t Coap::forEachOption(const uint8_t *buffer, size_t len,
+                           const std::function<void(const Option &)> &fn) {
+    if (!looksLikeCoap(buffer, len)) {
+        throw CoapException("Cannot parse options, buffer is not valid CoAP");
+    }
+
+    // reads an extended delta/length field for the given nibble, advancing index
+    auto extended = [&](uint8_t nibble, size_t &index) -> uint32_t {
+        if (nibble < 13) {
+            return nibble;
+        }
+        if (nibble == 13) {
+            if (index + 1 > len) {
+                throw CoapException("Truncated CoAP option header");
+            }
+            return 13 + buffer[index++];
+        }
+        if (nibble == 14) {
+            if (index + 2 > len) {
+                throw CoapException("Truncated CoAP option header");
+            }
+            const uint32_t value = 269 + ((buffer[index] << 8) | buffer[index + 1]);
+            index += 2;
+            return value;
+        }
+        throw CoapException("Reserved CoAP option nibble 15");
+    };
+
+    size_t index = COAP_TOKEN_START_INDEX + getTokenLength(buffer);
+    uint32_t number = 0;
+    while (index < len && buffer[index] != 0xFF) {
+        const uint8_t optByte = buffer[index++];
+        number += extended(optByte >> 4, index);
+        const uint32_t optLen = extended(optByte & 0x0F, index);
+        if (index + optLen > len || number > 0xFFFF) {
+            throw CoapException(format("CoAP option {} overruns message of {} bytes", number, len));
+        }
+        fn({static_cast<uint16_t>(number), buffer + index, optLen});
+        index += optLen;
+    }
+
+    if (index < len) {
+        index++;  // skip payload marker
+    }
+    return std::min(index, len);
+}
+
+uint32_t Coap::decodeUintOption(const Option &option) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < option.length && i < 4; i++) {
+        value = (value << 8) | option.value[i];
+    }
+    return value;
+}
+
+Coap::MessageView Coap::parseMessage(const uint8_t *buffer, size_t len) {
+    MessageView view{};
+    if (!looksLikeCoap(buffer, len)) {
+        throw CoapException("Cannot parse message, buffer is not valid CoAP");
+    }
+
+    view.type = getCoapType(buffer);
+    view.code = getCode(buffer);
+    view.mid = getMid(buffer);
+    view.token = buffer + COAP_TOKEN_START_INDEX;
+    view.tokenLength = getTokenLength(buffer);
+    view.contentFormat = Format::NONE;
+    view.maxAge = 60;
+
+    const size_t payloadStart = forEachOption(buffer, len, [&view](const Option &option) {
+        switch (option.number) {
+            case 6:  // Observe
+                view.hasObserve = true;
+                view.observe = decodeUintOption(option);
+                break;
+            case 12:  // Content-Format
+                view.contentFormat = static_cast<Format>(decodeUintOption(option));
+                break;
+            case 14:  // Max-Age
+                view.maxAge = decodeUintOption(option);
+                break;
+            default:
+                break;
+        }
+    });
+
+    view.payload = buffer + payloadStart;
+    view.payloadLength = len - payloadStart;
+    return view;
+}
+
+Coap::RequestKey Coap::requestKey(const uint8_t *buffer, size_t len) {
+    RequestKey result{};
+    std::string query;
+    std::string otherOptions;
+
+    forEachOption(buffer, len, [&](const Option &option) {
+        const std::string value(reinterpret_cast<const char *>(option.value), option.length);
+        switch (option.number) {
+            case 6:  // Observe
+                result.observe = true;
+                break;
+            case 11:  // Uri-Path
+                if (!result.path.empty()) {
+                    result.path += '/';
+                }
+                result.path += value;
+                break;
+            case 15:  // Uri-Query
+                query += query.empty() ? "?" : "&";
+                query += value;
+                break;
+            default:
+                // NoCacheKey options (RFC 7252 5.4.6) don't distinguish requests
+                if ((option.number & 0x1E) != 0x1C) {
+                    otherOptions += format(";{}={}", option.number, value);
+                }
+                break;
+        }
+    });
+
+    result.uri = result.path + query;
+    result.key = format("{}:{}{}", getCode(buffer), result.uri, otherOptions);
+    return result;
+}
+
+std::string Coap::exchangeKey(uint16_t port, const uint8_t *buffer) {
+    std::string key(reinterpret_cast<const char *>(&port), sizeof(port));
+    const uint8_t tokenLength = getTokenLength(buffer);
+    if (tokenLength == 0) {
+        const uint16_t mid = getMid(buffer);
+        key.append(reinterpret_cast<const char *>(&mid), sizeof(mid));
+    } else {
+        key.append(reinterpret_cast<const char *>(buffer + COAP_TOKEN_START_INDEX), tokenLength);
+    }
+    return key;
+}
+
+Coap::RequestHash Coap::requestHash(const uint8_t *buffer, size_t len) {
+    constexpr uint64_t fnvPrime = 0x100000001B3;
+    RequestHash result{0xCBF29CE484222325, false};
+
+    auto mix = [&result](const uint8_t *bytes, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            result.value = (result.value ^ bytes[i]) * fnvPrime;
+        }
+    };
+
+    const uint8_t code = getCode(buffer);
+    mix(&code, 1);
+    forEachOption(buffer, len, [&](const Option &option) {
+        if (option.number == 6) {  // Observe
+            result.observe = true;
+            return;
+        }
+        // NoCacheKey options (RFC 7252 5.4.6) don't distinguish requests
+        if ((option.number & 0x1E) == 0x1C) {
+            return;
+        }
+        const uint8_t header[4] = {static_cast<uint8_t>(option.number >> 8),
+                                   static_cast<uint8_t>(option.number & 0xFF),
+                                   static_cast<uint8_t>(option.length >> 8),
+                                   static_cast<uint8_t>(option.length & 0xFF)};
+        mix(header, sizeof(header));
+        mix(option.value, option.length);
+    });
+    return result;
+}
+
+Coap::ExchangeId Coap::exchangeId(uint16_t port, const uint8_t *buffer) {
+    ExchangeId id{port, getTokenLength(buffer), {}};
+    if (id.tokenLength == 0) {
+        id.bytes[0] = buffer[2];
+        id.bytes[1] = buffer[3];
+    } else {
+        std::copy_n(buffer + COAP_TOKEN_START_INDEX, std::min<size_t>(id.tokenLength, COAP_TOKEN_MAX_LEN),
+                    id.bytes.begin());
+    }
+    return id;
+}
+
+void Coap::appendOption(std::vector<uint8_t> &out, uint16_t number, const uint8_t *value,
+                        size_t length, uint16_t &lastNumber) {
+    encodeOption(out, number, value, length, lastNumber);
+}
+
+void Coap::appendUintOption(std::vector<uint8_t> &out, uint16_t number, uint32_t value,
+                            uint16_t &lastNumber) {
+    encodeUintOption(out, number, value, lastNumber);
+}
+
 Coap::CoapReply Coap::parseObserveReply(const uint8_t* buffer, size_t len) {
     CoapReply reply;
 
@@ -0,0 +1,326 @@
+#include <fort_agent/coapObserveHub.h>
+
+#include <algorithm>
+#include <random>
+
+#include <spdlog/spdlog.h>
+
+namespace {
+    constexpr uint8_t codeGet = 0x01;
+    constexpr uint16_t optionObserve = 6;
+    constexpr uint32_t observeRegister = 0;
+    constexpr uint32_t observeDeregister = 1;
+    constexpr size_t closingLimit = 64;
+
+    void appendHeader(std::vector<uint8_t> &out, Coap::Type type, uint8_t code, uint16_t mid,
+                      const uint8_t *token, size_t tokenLength) {
+        out.push_back(static_cast<uint8_t>((1 << 6) | (static_cast<uint8_t>(type) << 4) | tokenLength));
+        out.push_back(code);
+        out.push_back(static_cast<uint8_t>(mid >> 8));
+        out.push_back(static_cast<uint8_t>(mid & 0xFF));
+        out.insert(out.end(), token, token + tokenLength);
+    }
+}
+
+bool CoapObserveHub::Observer::is(uint16_t p, const uint8_t *t, uint8_t tl) const {
+    return port == p && tokenLength == tl && std::equal(t, t + tl, token.begin());
+}
+
+CoapObserveHub::CoapObserveHub(size_t maxObserversPerResource) :
+    observerLimit(maxObserversPerResource),
+    subscriptions(),
+    byKey(),
+    closing(),
+    tokenCounter(0),
+    midCounter(static_cast<uint16_t>(std::random_device()())),
+    scratch() {
+}
+
+bool CoapObserveHub::onRequest(uint16_t port, const uint8_t *msg, size_t len, const EmitFn &toClient,
+                               const EmitFn &toDevice) {
+    FXN_TRACE;
+    if (!Coap::looksLikeCoap(msg, len)) {
+        return false;
+    }
+
+    // A client rejecting one of our notifications has stopped observing
+    if (Coap::isEmpty(msg)) {
+        if (Coap::getCoapType(msg) != Coap::Type::RST) {
+            return false;
+        }
+        const uint16_t mid = Coap::getMid(msg);
+        for (auto sub = subscriptions.begin(); sub != subscriptions.end(); sub++) {
+            auto &observers = sub->second.observers;
+            auto observer = std::find_if(observers.begin(), observers.end(), [&](const Observer &o) {
+                return o.port == port && o.answered && o.lastMid == mid;
+            });
+            if (observer != observers.end()) {
+                spdlog::debug("Port {} reset notification for {}, removing observer", port, sub->second.key);
+                observers.erase(observer);
+                if (observers.empty()) {
+                    endSubscription(sub, true, toDevice);
+                }
+                updateCounts();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    if (Coap::getCode(msg) != codeGet) {
+        return false;
+    }
+
+    Coap::MessageView view;
+    Coap::RequestKey key;
+    try {
+        view = Coap::parseMessage(msg, len);
+        key = Coap::requestKey(msg, len);
+    }
+    catch (CoapException &e) {
+        return false;
+    }
+    if (!view.hasObserve || view.tokenLength > Coap::COAP_TOKEN_MAX_LEN) {
+        return false;
+    }
+
+    const Observer candidate = observerFor(port, view);
+    auto keyIt = byKey.find(key.key);
+
+    if (view.observe == observeRegister) {
+        if (keyIt == byKey.end()) {
+            const std::string token = nextToken();
+            Subscription &sub = subscriptions[token];
+            sub.key = key.key;
+            sub.request.assign(msg, msg + len);
+            sub.observers.push_back(candidate);
+            byKey[key.key] = token;
+            updateCounts();
+
+            spdlog::debug("Observe {}: registering with the device for port {}", key.uri, port);
+            toDevice(hubPort, deviceRequest(sub, token, observeRegister, view.type, view.mid));
+            return true;
+        }
+
+        auto sub = subscriptions.find(keyIt->second);
+        auto &observers = sub->second.observers;
+        auto existing = std::find_if(observers.begin(), observers.end(), [&](const Observer &o) {
+            return o.is(port, view.token, candidate.tokenLength);
+        });
+        if (existing != observers.end()) {
+            // re-registration or retransmission, answer it like a new one
+            *existing = candidate;
+        } else if (observers.size() >= observerLimit) {
+            return false;  // too many, let this one have its own device subscription
+        } else {
+            observers.push_back(candidate);
+            existing = observers.end() - 1;
+            shared.fetch_add(1, std::memory_order_relaxed);
+            updateCounts();
+        }
+
+        if (!sub->second.latest.empty()) {
+            send(*existing, sub->second.latest, true, toClient);
+        } else {
+            // still waiting on the device, in case the registration was lost resend it
+            toDevice(hubPort, deviceRequest(sub->second, sub->first, observeRegister, view.type, view.mid));
+        }
+        return true;
+    }
+
+    if (view.observe == observeDeregister && keyIt != byKey.end()) {
+        auto sub = subscriptions.find(keyIt->second);
+        auto &observers = sub->second.observers;
+        auto existing = std::find_if(observers.begin(), observers.end(), [&](const Observer &o) {
+            return o.is(port, view.token, candidate.tokenLength);
+        });
+        if (existing == observers.end()) {
+            return false;
+        }
+        observers.erase(existing);
+        updateCounts();
+
+        if (!observers.empty()) {
+            if (sub->second.latest.empty()) {
+                return false;  // nothing to answer with yet, the device can
+            }
+            Observer leaving = candidate;
+            send(leaving, sub->second.latest, false, toClient);
+            return true;
+        }
+
+        // Last observer: cancel on the device and give the device's answer to this client
+        spdlog::debug("Observe {}: last observer left, deregistering with the device", key.uri);
+        if (closing.size() >= closingLimit) {
+            closing.clear();  // deregistrations the device never answered
+        }
+        closing[sub->first] = candidate;
+        toDevice(hubPort, deviceRequest(sub->second, sub->first, observeDeregister, view.type, view.mid));
+        endSubscription(sub, false, toDevice);
+        return true;
+    }
+
+    return false;
+}
+
+void CoapObserveHub::onDeviceMessage(const uint8_t *msg, size_t len, const EmitFn &toClient,
+                                     const EmitFn &toDevice) {
+    FXN_TRACE;
+    // Empty ACKs and RSTs to the hub's own messages need no action
+    if (!Coap::looksLikeCoap(msg, len) || !Coap::isResponse(msg)) {
+        return;
+    }
+
+    Coap::MessageView view;
+    try {
+        view = Coap::parseMessage(msg, len);
+    }
+    catch (CoapException &e) {
+        return;
+    }
+
+    const std::string token(reinterpret_cast<const char *>(view.token), view.tokenLength);
+    auto leaving = closing.find(token);
+    auto sub = subscriptions.find(token);
+
+    if (leaving == closing.end() && sub == subscriptions.end()) {
+        // Nobody is listening any more, a reset makes the device drop the observation
+        if (view.type != Coap::Type::ACK) {
+            const auto reset = Coap::createResetMsg(view.mid);
+            toDevice(hubPort, std::vector<uint8_t>(reset.begin(), reset.end()));
+        }
+        return;
+    }
+
+    if (view.type == Coap::Type::CON) {
+        scratch.clear();
+        appendHeader(scratch, Coap::Type::ACK, 0, view.mid, nullptr, 0);
+        toDevice(hubPort, scratch);
+    }
+
+    const std::vector<uint8_t> message(msg, msg + len);
+
+    if (leaving != closing.end()) {
+        send(leaving->second, message, false, toClient);
+        closing.erase(leaving);
+        return;
+    }
+
+    notifications.fetch_add(1, std::memory_order_relaxed);
+    for (Observer &observer : sub->second.observers) {
+        send(observer, message, true, toClient);
+    }
+
+    uint8_t codeClass = 0;
+    Coap::getCode(msg, &codeClass);
+    if (codeClass != 2 || !view.hasObserve) {
+        // An error, or the device would not observe the resource: the observation is over
+        spdlog::debug("Observe {}: device ended the observation with code {}.{:02d}", sub->second.key,
+                      codeClass, Coap::getCode(msg) & 0x1F);
+        endSubscription(sub, false, toDevice);
+        return;
+    }
+    sub->second.latest = message;
+}
+
+CoapObserveHub::Stats CoapObserveHub::stats() const {
+    return {subscriptionCount.load(std::memory_order_relaxed), observerCount.load(std::memory_order_relaxed),
+            notifications.load(std::memory_order_relaxed), replicated.load(std::memory_order_relaxed),
+            shared.load(std::memory_order_relaxed)};
+}
+
+CoapObserveHub::Observer CoapObserveHub::observerFor(uint16_t port, const Coap::MessageView &view) {
+    Observer observer{port, {}, static_cast<uint8_t>(view.tokenLength), view.type, view.mid, false, 0};
+    std::copy_n(view.token, view.tokenLength, observer.token.begin());
+    return observer;
+}
+
+void CoapObserveHub::send(Observer &observer, const std::vector<uint8_t> &message, bool keepObserve,
+                          const EmitFn &toClient) {
+    // The first message to a CON registration is its ACK, everything else is a NON
+    const bool ack = !observer.answered && observer.requestType == Coap::Type::CON;
+    const uint16_t mid = ack ? observer.requestMid : midCounter++;
+
+    scratch.clear();
+    appendHeader(scratch, ack ? Coap::Type::ACK : Coap::Type::NON, message[1], mid, observer.token.data(),
+                 observer.tokenLength);
+
+    const size_t restStart = Coap::COAP_TOKEN_START_INDEX + Coap::getTokenLength(message.data());
+    if (keepObserve) {
+        scratch.insert(scratch.end(), message.begin() + restStart, message.end());
+    } else {
+        uint16_t lastNumber = 0;
+        const size_t payloadStart = Coap::forEachOption(message.data(), message.size(),
+                                                        [&](const Coap::Option &option) {
+            if (option.number != optionObserve) {
+                Coap::appendOption(scratch, option.number, option.value, option.length, lastNumber);
+            }
+        });
+        if (payloadStart < message.size()) {
+            scratch.push_back(0xFF);
+            scratch.insert(scratch.end(), message.begin() + payloadStart, message.end());
+        }
+    }
+
+    observer.answered = true;
+    observer.lastMid = mid;
+    toClient(observer.port, scratch);
+    replicated.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<uint8_t> CoapObserveHub::deviceRequest(const Subscription &sub, const std::string &token,
+                                                   uint32_t observeValue, Coap::Type type,
+                                                   uint16_t mid) const {
+    std::vector<uint8_t> out;
+    appendHeader(out, type, codeGet, mid, reinterpret_cast<const uint8_t *>(token.data()), token.size());
+
+    uint16_t lastNumber = 0;
+    bool observeWritten = false;
+    const size_t payloadStart = Coap::forEachOption(sub.request.data(), sub.request.size(),
+                                                    [&](const Coap::Option &option) {
+        if (!observeWritten && option.number >= optionObserve) {
+            Coap::appendUintOption(out, optionObserve, observeValue, lastNumber);
+            observeWritten = true;
+        }
+        if (option.number != optionObserve) {
+            Coap::appendOption(out, option.number, option.value, option.length, lastNumber);
+        }
+    });
+    if (!observeWritten) {
+        Coap::appendUintOption(out, optionObserve, observeValue, lastNumber);
+    }
+    if (payloadStart < sub.request.size()) {
+        out.push_back(0xFF);
+        out.insert(out.end(), sub.request.begin() + payloadStart, sub.request.end());
+    }
+    return out;
+}
+
+void CoapObserveHub::endSubscription(SubscriptionIt sub, bool cancelOnDevice, const EmitFn &toDevice) {
+    if (cancelOnDevice) {
+        spdlog::debug("Observe {}: no observers left, deregistering with the device", sub->second.key);
+        toDevice(hubPort, deviceRequest(sub->second, sub->first, observeDeregister, Coap::Type::CON,
+                                        midCounter++));
+    }
+    byKey.erase(sub->second.key);
+    subscriptions.erase(sub);
+    updateCounts();
+}
+
+std::string CoapObserveHub::nextToken() {
+    std::string token;
+    do {
+        const uint16_t n = tokenCounter++;
+        token = {'o', 'b', static_cast<char>(n >> 8), static_cast<char>(n & 0xFF)};
+    } while (subscriptions.count(token) != 0 || closing.count(token) != 0);
+    return token;
+}
+
+void CoapObserveHub::updateCounts() {
+    size_t observers = 0;
+    for (const auto &sub : subscriptions) {
+        observers += sub.second.observers.size();
+    }
+    subscriptionCount.store(subscriptions.size(), std::memory_order_relaxed);
+    observerCount.store(observers, std::memory_order_relaxed);
+}
@@ -67,6 +67,7 @@ CoapPortTracker::CoapPortTracker(boost::asio::io_service &service,
                                  uint16_t defaultCoapPort) :
     defaultPort(defaultCoapPort),
     mids(),
+    trackerStrand(service, "tracker"),
     midExpirationTimer(service) {
     // nothing to remove yet, but calling this will start the timer
     removeOldMids();
@@ -87,13 +88,13 @@ void CoapPortTracker::removeOldMids() {
     }
 
     midExpirationTimer.expires_from_now(std::chrono::seconds(1));
-    midExpirationTimer.async_wait([this](const boost::system::error_code &ec) {
+    midExpirationTimer.async_wait(trackerStrand.wrap([this](const boost::system::error_code &ec) {
         if (ec.value() == 125) {
             // operation cancelled
             return;
         }
         removeOldMids();
-    });
+    }));
 }
 
 void CoapPortTracker::trackMid(uint16_t port, uint16_t mid) {
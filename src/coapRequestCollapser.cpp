@@ -0,0 +1,149 @@
+#include <fort_agent/coapRequestCollapser.h>
+
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+namespace {
+    constexpr uint8_t codeGet = 0x01;
+}
+
+CoapRequestCollapser::CoapRequestCollapser(std::chrono::milliseconds leaderTimeout, size_t maxWaiters,
+                                           size_t maxInFlight) :
+    timeout(leaderTimeout),
+    waiterLimit(maxWaiters),
+    flightLimit(maxInFlight),
+    flights(),
+    scratch() {
+    flights.reserve(flightLimit);
+}
+
+bool CoapRequestCollapser::onRequest(uint16_t port, const uint8_t *msg, size_t len) {
+    FXN_TRACE;
+    if (!Coap::looksLikeCoap(msg, len) || Coap::getCode(msg) != codeGet) {
+        return false;
+    }
+
+    Coap::RequestHash request;
+    try {
+        request = Coap::requestHash(msg, len);
+    }
+    catch (CoapException &e) {
+        return false;
+    }
+    if (request.observe) {
+        return false;
+    }
+
+    const auto now = Clock::now();
+    const Coap::ExchangeId exchange = Coap::exchangeId(port, msg);
+
+    auto it = std::find_if(flights.begin(), flights.end(),
+                           [&](const InFlight &flight) { return flight.request == request.value; });
+    if (it != flights.end() && now - it->sent < timeout) {
+        if (it->leader == exchange) {
+            return false;  // leader retransmission, let it through
+        }
+
+        const uint16_t mid = Coap::getMid(msg);
+        const bool duplicate = std::any_of(it->waiters.begin(), it->waiters.end(),
+                                           [&](const Waiter &w) { return w.port == port && w.mid == mid; });
+        if (duplicate) {
+            return true;
+        }
+        if (it->waiters.size() >= waiterLimit) {
+            return false;
+        }
+
+        Waiter waiter{port, Coap::getCoapType(msg), mid, {}, Coap::getTokenLength(msg)};
+        std::copy_n(msg + Coap::COAP_TOKEN_START_INDEX, waiter.tokenLength, waiter.token.begin());
+        it->waiters.push_back(waiter);
+        collapsed.fetch_add(1, std::memory_order_relaxed);
+        spdlog::debug("Collapsed GET from port {} into the in-flight request from port {}", port, it->leader.port);
+        return true;
+    }
+
+    if (it != flights.end()) {
+        abandon(*it);
+        remove(it);
+    }
+    if (flights.size() >= flightLimit) {
+        pruneStale(now);
+    }
+    forwarded.fetch_add(1, std::memory_order_relaxed);
+    if (flights.size() >= flightLimit) {
+        return false;  // every slot has a live leader, forward untracked
+    }
+
+    flights.push_back({request.value, exchange, now, {}});
+    inFlightCount.store(flights.size(), std::memory_order_relaxed);
+    return false;
+}
+
+void CoapRequestCollapser::onResponse(uint16_t port, const uint8_t *msg, size_t len, const EmitFn &emit) {
+    FXN_TRACE;
+    if (flights.empty() || !Coap::looksLikeCoap(msg, len) || !Coap::isResponse(msg)) {
+        return;
+    }
+
+    const Coap::ExchangeId exchange = Coap::exchangeId(port, msg);
+    auto it = std::find_if(flights.begin(), flights.end(),
+                           [&](const InFlight &flight) { return flight.leader == exchange; });
+    if (it == flights.end()) {
+        return;
+    }
+    const std::vector<Waiter> waiters = std::move(it->waiters);
+    remove(it);
+
+    // everything after the token (options and payload) is shared by all the copies
+    const size_t restStart = Coap::COAP_TOKEN_START_INDEX + Coap::getTokenLength(msg);
+    const bool piggybacked = Coap::getCoapType(msg) == Coap::Type::ACK;
+
+    for (const Waiter &waiter : waiters) {
+        const Coap::Type type = (piggybacked && waiter.type == Coap::Type::CON) ? Coap::Type::ACK
+                                                                                : Coap::Type::NON;
+        scratch.clear();
+        scratch.push_back(static_cast<uint8_t>((1 << 6) | (static_cast<uint8_t>(type) << 4) | waiter.tokenLength));
+        scratch.push_back(Coap::getCode(msg));
+        scratch.push_back(static_cast<uint8_t>(waiter.mid >> 8));
+        scratch.push_back(static_cast<uint8_t>(waiter.mid & 0xFF));
+        scratch.insert(scratch.end(), waiter.token.begin(), waiter.token.begin() + waiter.tokenLength);
+        scratch.insert(scratch.end(), msg + restStart, msg + len);
+
+        emit(waiter.port, scratch);
+        fannedOut.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void CoapRequestCollapser::abandon(InFlight &flight) {
+    if (!flight.waiters.empty()) {
+        abandoned.fetch_add(flight.waiters.size(), std::memory_order_relaxed);
+        spdlog::debug("Abandoning {} collapsed GET(s), leader got no response", flight.waiters.size());
+        flight.waiters.clear();
+    }
+}
+
+void CoapRequestCollapser::remove(std::vector<InFlight>::iterator it) {
+    if (it != flights.end() - 1) {
+        *it = std::move(flights.back());
+    }
+    flights.pop_back();
+    inFlightCount.store(flights.size(), std::memory_order_relaxed);
+}
+
+void CoapRequestCollapser::pruneStale(Clock::time_point now) {
+    for (size_t i = 0; i < flights.size();) {
+        if (now - flights[i].sent >= timeout) {
+            abandon(flights[i]);
+            remove(flights.begin() + i);    // the last flight now sits at i, check it next
+        } else {
+            i++;
+        }
+    }
+}
+
+CoapRequestCollapser::Stats CoapRequestCollapser::stats() const {
+    return {forwarded.load(std::memory_order_relaxed), collapsed.load(std::memory_order_relaxed),
+            fannedOut.load(std::memory_order_relaxed), abandoned.load(std::memory_order_relaxed),
+            inFlightCount.load(std::memory_order_relaxed)};
+}
@@ -0,0 +1,207 @@
+#include <fort_agent/coapResponseCache.h>
+
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+namespace {
+    constexpr uint16_t observeOption = 6;
+    constexpr uint16_t maxAgeOption = 14;
+    constexpr uint8_t codeGet = 0x01;
+    constexpr uint8_t codeContent = 0x45;  // 2.05
+
+    // Requests whose response never arrives are forgotten after this long
+    constexpr auto pendingLifetime = std::chrono::seconds(60);
+    constexpr size_t maxPending = 256;
+
+    bool isModifyingMethod(uint8_t code) {
+        return code == 0x02 || code == 0x03 || code == 0x04;  // POST, PUT, DELETE
+    }
+}
+
+CoapResponseCache::CoapResponseCache(TtlMap resourceTtls, size_t maxEntries) :
+    ttls(std::move(resourceTtls)),
+    capacity(maxEntries),
+    entries(),
+    pending() {
+}
+
+bool CoapResponseCache::onRequest(uint16_t port, const uint8_t *msg, size_t len,
+                                  std::vector<uint8_t> &reply) {
+    FXN_TRACE;
+    if (!Coap::looksLikeCoap(msg, len) || !Coap::isRequest(msg)) {
+        return false;
+    }
+
+    Coap::RequestKey key;
+    Coap::MessageView request;
+    try {
+        key = Coap::requestKey(msg, len);
+        request = Coap::parseMessage(msg, len);
+    }
+    catch (CoapException &e) {
+        return false;  // let the device reject it
+    }
+
+    if (isModifyingMethod(request.code)) {
+        invalidate(key.path);
+        return false;
+    }
+    if (request.code != codeGet || key.observe) {
+        return false;
+    }
+
+    lookups.fetch_add(1, std::memory_order_relaxed);
+    const auto now = Clock::now();
+
+    auto it = entries.find(key.key);
+    if (it != entries.end()) {
+        if (it->second.expires > now) {
+            hits.fetch_add(1, std::memory_order_relaxed);
+            buildReply(it->second, request, reply);
+            spdlog::debug("Cache: served {} to port {} from cache", key.uri, port);
+            return true;
+        }
+        entries.erase(it);
+        entryCount.store(entries.size(), std::memory_order_relaxed);
+    }
+
+    // remember the exchange so the device's answer can be stored
+    if (pending.size() >= maxPending) {
+        for (auto p = pending.begin(); p != pending.end();) {
+            p = (now - p->second.sent > pendingLifetime) ? pending.erase(p) : std::next(p);
+        }
+        if (pending.size() >= maxPending) {
+            pending.clear();
+        }
+    }
+    pending[Coap::exchangeKey(port, msg)] =
+        {std::move(key.key), std::move(key.uri), std::move(key.path), now};
+    return false;
+}
+
+void CoapResponseCache::onResponse(uint16_t port, const uint8_t *msg, size_t len) {
+    FXN_TRACE;
+    if (pending.empty() || !Coap::looksLikeCoap(msg, len) || !Coap::isResponse(msg)) {
+        return;
+    }
+
+    auto it = pending.find(Coap::exchangeKey(port, msg));
+    if (it == pending.end()) {
+        return;
+    }
+    const PendingGet get = std::move(it->second);
+    pending.erase(it);
+
+    if (Coap::getCode(msg) != codeContent) {
+        return;
+    }
+
+    Entry entry{get.path, codeContent, {}, {}, {}};
+    bool hasMaxAge = false;
+    uint32_t maxAge = 0;
+    size_t payloadStart = 0;
+    try {
+        payloadStart = Coap::forEachOption(msg, len, [&](const Coap::Option &option) {
+            if (option.number == maxAgeOption) {
+                hasMaxAge = true;
+                maxAge = Coap::decodeUintOption(option);
+            } else if (option.number != observeOption) {
+                entry.options.emplace_back(option.number,
+                                           std::vector<uint8_t>(option.value, option.value + option.length));
+            }
+        });
+    }
+    catch (CoapException &e) {
+        return;
+    }
+
+    std::chrono::seconds ttl(0);
+    const auto configured = ttls.find(get.uri);
+    if (configured != ttls.end()) {
+        ttl = configured->second;
+    } else if (hasMaxAge) {
+        ttl = std::chrono::seconds(maxAge);
+    }
+    if (ttl.count() <= 0) {
+        return;
+    }
+
+    entry.payload.assign(msg + payloadStart, msg + len);
+    entry.expires = Clock::now() + ttl;
+
+    if (entries.size() >= capacity && entries.find(get.key) == entries.end()) {
+        evictOne();
+    }
+    entries[get.key] = std::move(entry);
+    entryCount.store(entries.size(), std::memory_order_relaxed);
+    stores.fetch_add(1, std::memory_order_relaxed);
+    spdlog::debug("Cache: stored {} for {}s", get.uri, ttl.count());
+}
+
+void CoapResponseCache::buildReply(const Entry &entry, const Coap::MessageView &request,
+                                   std::vector<uint8_t> &reply) const {
+    const Coap::Type type = request.type == Coap::Type::CON ? Coap::Type::ACK : Coap::Type::NON;
+
+    reply.clear();
+    reply.push_back(static_cast<uint8_t>((1 << 6) | (static_cast<uint8_t>(type) << 4) | request.tokenLength));
+    reply.push_back(entry.code);
+    reply.push_back(static_cast<uint8_t>(request.mid >> 8));
+    reply.push_back(static_cast<uint8_t>(request.mid & 0xFF));
+    reply.insert(reply.end(), request.token, request.token + request.tokenLength);
+
+    // tell the client how much freshness is left, rounded up
+    const auto remaining = std::chrono::duration_cast<std::chrono::seconds>(
+        entry.expires - Clock::now() + std::chrono::milliseconds(999));
+
+    uint16_t lastNumber = 0;
+    bool maxAgeWritten = false;
+    for (const auto &option : entry.options) {
+        if (!maxAgeWritten && option.first > maxAgeOption) {
+            Coap::appendUintOption(reply, maxAgeOption, static_cast<uint32_t>(remaining.count()), lastNumber);
+            maxAgeWritten = true;
+        }
+        Coap::appendOption(reply, option.first, option.second.data(), option.second.size(), lastNumber);
+    }
+    if (!maxAgeWritten) {
+        Coap::appendUintOption(reply, maxAgeOption, static_cast<uint32_t>(remaining.count()), lastNumber);
+    }
+
+    if (!entry.payload.empty()) {
+        reply.push_back(0xFF);
+        reply.insert(reply.end(), entry.payload.begin(), entry.payload.end());
+    }
+}
+
+void CoapResponseCache::invalidate(const std::string &path) {
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->second.path == path) {
+            it = entries.erase(it);
+            invalidations.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            it++;
+        }
+    }
+    entryCount.store(entries.size(), std::memory_order_relaxed);
+
+    // A GET still in flight may be answered with the value from before the change, don't store it
+    for (auto it = pending.begin(); it != pending.end();) {
+        it = it->second.path == path ? pending.erase(it) : std::next(it);
+    }
+}
+
+void CoapResponseCache::evictOne() {
+    // the entry closest to expiry is the least valuable
+    auto victim = std::min_element(entries.begin(), entries.end(), [](const auto &a, const auto &b) {
+        return a.second.expires < b.second.expires;
+    });
+    if (victim != entries.end()) {
+        entries.erase(victim);
+    }
+}
+
+CoapResponseCache::Stats CoapResponseCache::stats() const {
+    return {lookups.load(std::memory_order_relaxed), hits.load(std::memory_order_relaxed),
+            stores.load(std::memory_order_relaxed), invalidations.load(std::memory_order_relaxed),
+            entryCount.load(std::memory_order_relaxed)};
+}
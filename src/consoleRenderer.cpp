@@ -0,0 +1,99 @@
+#include <ostream>
+
+#include <fort_agent/consoleRenderer.h>
+
+ConsoleRenderer::ConsoleRenderer(std::ostream &out) : out(out) {
+}
+
+ConsoleRenderer::~ConsoleRenderer() {
+    stop();
+}
+
+bool ConsoleRenderer::post(std::string frame) {
+    if (!enabled()) {
+        return false;
+    }
+    if (!queue.push(std::move(frame))) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    postedCount.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void ConsoleRenderer::show(std::string frame) {
+    if (!enabled()) {
+        return;
+    }
+    auto next = std::make_shared<std::string>(std::move(frame));
+    if (std::atomic_exchange_explicit(&screen, std::move(next), std::memory_order_acq_rel)) {
+        coalescedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void ConsoleRenderer::setView(std::function<std::string()> render) {
+    std::lock_guard<std::mutex> lock(wakeMutex);
+    view = std::move(render);
+}
+
+void ConsoleRenderer::start(bool enable, std::chrono::milliseconds interval) {
+    if (!enable || thread.joinable()) {
+        return;
+    }
+    running = true;
+    active.store(true, std::memory_order_relaxed);
+    thread = std::thread(&ConsoleRenderer::run, this, interval);
+}
+
+void ConsoleRenderer::stop() {
+    if (!thread.joinable()) {
+        return;
+    }
+    active.store(false, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        running = false;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+ConsoleRenderer::Stats ConsoleRenderer::stats() const {
+    return {postedCount.load(std::memory_order_relaxed), droppedCount.load(std::memory_order_relaxed),
+            coalescedCount.load(std::memory_order_relaxed), refreshCount.load(std::memory_order_relaxed)};
+}
+
+void ConsoleRenderer::run(std::chrono::milliseconds interval) {
+    // Refreshes once more after stop(), so nothing queued before it is lost
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    bool last = false;
+    while (!last) {
+        wake.wait_for(lock, interval, [this]() { return !running; });
+        last = !running;
+        const std::function<std::string()> render = view;
+        lock.unlock();
+        refresh(render);
+        lock.lock();
+    }
+}
+
+void ConsoleRenderer::refresh(const std::function<std::string()> &render) {
+    // One write per refresh, the only place that can block on stdout
+    std::string text;
+    std::string frame;
+    while (queue.pop(frame)) {
+        text += frame;
+    }
+    if (const auto latest = std::atomic_exchange_explicit(&screen, std::shared_ptr<std::string>(),
+                                                          std::memory_order_acq_rel)) {
+        text += *latest;
+    }
+    if (render) {
+        text += render();
+    }
+    if (text.empty()) {
+        return;
+    }
+    out << text << std::flush;
+    refreshCount.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,79 @@
+#include <fort_agent/datagramPool.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+// keep every buffer on its own cache line so RX and TX handlers don't false-share
+static constexpr size_t slabAlignment = 64;
+
+DatagramPool::DatagramPool(size_t bufferSize, size_t bufferCount) :
+    size(bufferSize),
+    count(bufferCount),
+    slab(),
+    slots(),
+    freeList(),
+    highWater(0),
+    acquired(0),
+    exhausted(0) {
+    if (bufferSize == 0 || bufferCount == 0) {
+        throw std::invalid_argument("DatagramPool needs a non-zero buffer size and count");
+    }
+
+    const size_t stride = (size + slabAlignment - 1) / slabAlignment * slabAlignment;
+    slab.reset(new uint8_t[stride * count]);
+    slots.reset(new DatagramSlot[count]);
+    freeList.reserve(count);
+
+    for (size_t i = 0; i < count; i++) {
+        slots[i].pool = this;
+        slots[i].storage = slab.get() + i * stride;
+        slots[i].size = size;
+        freeList.push_back(&slots[i]);
+    }
+}
+
+DatagramPtr DatagramPool::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(freeMutex);
+        if (!freeList.empty()) {
+            DatagramSlot *slot = freeList.back();
+            freeList.pop_back();
+            acquired++;
+            highWater = std::max(highWater, count - freeList.size());
+            return DatagramPtr(slot);
+        }
+        exhausted++;
+    }
+
+    // slab is empty, hand out a heap buffer that is freed rather than recycled
+    auto *slot = new DatagramSlot();
+    slot->storage = new uint8_t[size];
+    slot->size = size;
+    return DatagramPtr(slot);
+}
+
+void DatagramPool::release(DatagramSlot *slot) {
+    std::lock_guard<std::mutex> lock(freeMutex);
+    freeList.push_back(slot);
+}
+
+DatagramPoolStats DatagramPool::stats() const {
+    std::lock_guard<std::mutex> lock(freeMutex);
+    return {count, size, count - freeList.size(), highWater, acquired, exhausted};
+}
+
+void DatagramPtr::reset() {
+    if (slot == nullptr) {
+        return;
+    }
+
+    if (slot->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        if (slot->pool != nullptr) {
+            slot->pool->release(slot);
+        } else {
+            delete[] slot->storage;
+            delete slot;
+        }
+    }
+    slot = nullptr;
+}
@@ -0,0 +1,102 @@
+#include <fort_agent/fairScheduler.h>
+
+#include <algorithm>
+
+namespace {
+    constexpr size_t pruneThreshold = 64;
+}
+
+FairScheduler::FairScheduler(size_t quantumBytes, size_t maxQueuedPerClient) :
+    quantum(std::max<size_t>(1, quantumBytes)),
+    queueLimit(maxQueuedPerClient),
+    clientsMutex(),
+    clients(),
+    active() {
+}
+
+bool FairScheduler::enqueue(uint16_t port, DatagramPtr &&data, size_t length) {
+    Client &c = client(port);
+    if (c.queue.size() >= queueLimit) {
+        c.dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (c.queue.empty()) {
+        active.push_back(port);
+    }
+    c.queue.push_back({port, std::move(data), length});
+    c.queued.store(c.queue.size(), std::memory_order_relaxed);
+    return true;
+}
+
+bool FairScheduler::next(const std::function<bool(size_t length)> &fits, Frame &out) {
+    while (!active.empty()) {
+        Client &c = *clients.at(active.front());
+        if (!c.inTurn) {
+            c.deficit += quantum;
+            c.inTurn = true;
+        }
+
+        const size_t length = c.queue.front().length;
+        if (length > c.deficit) {
+            // not enough credit this round, carry it over and move on
+            c.inTurn = false;
+            active.push_back(active.front());
+            active.pop_front();
+            continue;
+        }
+        if (!fits(length)) {
+            return false;
+        }
+
+        out = std::move(c.queue.front());
+        c.queue.pop_front();
+        c.deficit -= length;
+        c.queued.store(c.queue.size(), std::memory_order_relaxed);
+        c.frames.fetch_add(1, std::memory_order_relaxed);
+        c.bytes.fetch_add(length, std::memory_order_relaxed);
+
+        if (c.queue.empty()) {
+            c.deficit = 0;
+            c.inTurn = false;
+            active.pop_front();
+        }
+        return true;
+    }
+    return false;
+}
+
+std::vector<FairScheduler::ClientStats> FairScheduler::stats() const {
+    std::lock_guard<std::mutex> lock(clientsMutex);
+    std::vector<ClientStats> result;
+    result.reserve(clients.size());
+    for (const auto &entry : clients) {
+        const Client &c = *entry.second;
+        result.push_back({entry.first, c.frames.load(std::memory_order_relaxed),
+                          c.bytes.load(std::memory_order_relaxed), c.dropped.load(std::memory_order_relaxed),
+                          c.queued.load(std::memory_order_relaxed)});
+    }
+    std::sort(result.begin(), result.end(),
+              [](const ClientStats &a, const ClientStats &b) { return a.port < b.port; });
+    return result;
+}
+
+FairScheduler::Client &FairScheduler::client(uint16_t port) {
+    auto it = clients.find(port);
+    if (it != clients.end()) {
+        return *it->second;
+    }
+
+    std::lock_guard<std::mutex> lock(clientsMutex);
+    if (clients.size() >= pruneThreshold) {
+        // drop idle clients, their counters start over if they come back
+        for (auto idle = clients.begin(); idle != clients.end();) {
+            if (idle->second->queue.empty()) {
+                idle = clients.erase(idle);
+            } else {
+                idle++;
+            }
+        }
+    }
+    return *clients.emplace(port, std::make_unique<Client>()).first->second;
+}
@@ -0,0 +1,51 @@
+#include <fort_agent/jaus/HeartbeatMonitor.h>
+
+#include <algorithm>
+
+void HeartbeatMonitor::beat(Clock::time_point now) {
+    // Never 0, that means no beat yet
+    const Clock::rep ticks = std::max<Clock::rep>(now.time_since_epoch().count(), 1);
+    lastBeat.store(ticks, std::memory_order_release);
+    beatCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool HeartbeatMonitor::alive(Clock::time_point now) const {
+    const Clock::rep last = lastBeat.load(std::memory_order_acquire);
+    return last != 0 && now - Clock::time_point(Clock::duration(last)) < limit;
+}
+
+HeartbeatMonitor::Clock::time_point HeartbeatMonitor::deadline() const {
+    const Clock::rep last = lastBeat.load(std::memory_order_acquire);
+    if (last == 0 || (lost && last == lostAt)) {
+        return Clock::time_point::max();
+    }
+    return Clock::time_point(Clock::duration(last)) + limit;
+}
+
+bool HeartbeatMonitor::expired(Clock::time_point now, Clock::duration& sinceLastBeat) {
+    const Clock::rep last = lastBeat.load(std::memory_order_acquire);
+    if (last == 0) {
+        return false;
+    }
+    if (lost) {
+        if (last == lostAt) {
+            return false;
+        }
+        lost = false;
+        recoveryCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    sinceLastBeat = now - Clock::time_point(Clock::duration(last));
+    if (sinceLastBeat < limit) {
+        return false;
+    }
+    lost = true;
+    lostAt = last;
+    lossCount.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+HeartbeatMonitor::Stats HeartbeatMonitor::stats() const {
+    return {beatCount.load(std::memory_order_relaxed), lossCount.load(std::memory_order_relaxed),
+            recoveryCount.load(std::memory_order_relaxed)};
+}
@@ -1,11 +1,13 @@
 // #include <signal.h>
-#include <iostream>
+#include <algorithm>
 #include <iomanip>
 #include <cstdint>
 
+#include <fort_agent/consoleRenderer.h>
 #include <fort_agent/uart/FORTJoystick/FORTJoystickHelpers.h>
 #include <fort_agent/jaus/JausBridge.h>
 #include <fort_agent/jaus/JausBridgeSingleton.h>
+#include <fort_agent/jaus/WrenchStreamer.h>
 #include <fort_agent/jaus/states/InitializeState.h>
 #include <fort_agent/uartCoapBridgeSingleton.h>
 #include <fort_agent/dbgTrace.h>
@@ -15,16 +17,22 @@
 #define JS_MID 0x3000
 using namespace coapSRCPro;
 
-// To avoid flooding with identical joystick inputs
-static frc_combined_data_t lastJs = {};
+// The SRC Pro streams the combined joystick resource continuously, a gap this long means the
+// observation was lost
+static constexpr std::chrono::milliseconds combinedJoystickFreshFor{500};
 
 JausBridge::JausBridge(std::unique_ptr<JAUSClient> client) : 
-    jausClient(std::move(client))  {
+    jausClient(std::move(client)),
+    subscriptions(JS_MID + 1, ObserveSubscriptions::Settings())  {
     stateMachine = nullptr;    
     // Constructor implementation
 }
 
-void JausBridge::startServiceLoop() {
+void JausBridge::startServiceLoop(const JausBridgeSettings& settings) {
+    // Responses to the requests below are routed back here by the UART bridge
+    registerResponseHandlers(UartCoapBridgeSingleton::instance().responses());
+    inputStrand = &UartCoapBridgeSingleton::instance().responseStrand();
+
     // Let's setup the Joystick uart modes here
     
     // Verbose stuff
@@ -32,9 +40,22 @@ void JausBridge::startServiceLoop() {
     coapSRCPro::getModelNumber(JS_MID);
     //coapSRCPro::getFirmwareVersion(JS_MID);
 
-    // send Observe request for joystick/combined resource
+    // send Observe request for joystick/combined resource, kept alive by subscriptions
     coapSRCPro::unsubscribeCombinedJoystickKeypad(JS_MID);
-    coapSRCPro::subscribeCombinedJoystickKeypad(JS_MID);
+    subscriptions.add(static_cast<uint16_t>(JausPort::COMBINEDJOYSTICKKEYPAD), "combinedJoystick",
+                      [](uint16_t mid) { coapSRCPro::subscribeCombinedJoystickKeypad(mid); },
+                      combinedJoystickFreshFor);
+    subscriptions.start();
+
+    // The SRC Pro forgets its observers when it restarts
+    UartCoapBridgeSingleton::instance().addLinkListener(
+        [this](LinkMonitor::Event event, std::chrono::milliseconds) {
+            if (event == LinkMonitor::Event::RECOVERED) {
+                subscriptions.resubscribeAll();
+                joystickDisplay().invalidate(); // and its screen contents
+            }
+        });
+    StatTrace::addReporter([this]() { reportStats(); });
 
 
     //coapSRCPro::getBatteryStatus(JS_MID); // observe battery status
@@ -55,9 +76,14 @@ void JausBridge::startServiceLoop() {
     stateMachine = std::make_unique<VehicleStateMachine>(
     std::make_unique<InitializeState>(*jausClient));
 
-    lastJs.keypad_data.buttonStatus = 0xFFFF; // force first input to be processed
+    joystickFilter.configure(settings.joystickFilter); // the first input is always processed
 
     jausClient->initializeJAUS(); // Initialize JAUS client before starting loop
+    spinBeforeSleep = settings.spinBeforeSleep;
+    controlTicks.setRate(settings.controlRateHz);
+    WrenchStreamer::setRate(settings.wrenchRateHz);
+    WrenchStreamer::setMaxHold(combinedJoystickFreshFor);
+    heartbeat.setTimeout(settings.heartbeatTimeout);
     running = true;
     serviceThread = std::thread(&JausBridge::serviceLoop, this);
 
@@ -65,198 +91,274 @@ void JausBridge::startServiceLoop() {
 }
 
 void JausBridge::stopServiceLoop() {
-    {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        running = false;
-    }
-    queueCV.notify_all();
+    running = false;
+    inputReady.notify();
     if (serviceThread.joinable()) {
         serviceThread.join();
     }
 }
 
 void JausBridge::serviceLoop() {
-    while (running) {
-        BridgeMessage msg;
-        {
-            std::unique_lock<std::mutex> lock(queueMutex);
-            queueCV.wait(lock, [&] { return !inputQueue.empty() || !running; });
+    auto ready = [this] {
+        return !eventRing.empty() || latestInput.hasNew() || backlogged.load(std::memory_order_acquire) ||
+               pendingResponses.load(std::memory_order_relaxed) != 0 || !running;
+    };
 
+    controlTicks.start(std::chrono::steady_clock::now());
+    while (running) {
+        // Wake up for input, the next control tick, the heartbeat deadline, pending display text and
+        // the next Observe freshness deadline
+        const auto deadline = std::min({controlTicks.deadline(), heartbeat.deadline(), joystickDisplay().deadline(),
+                                        subscriptions.poll()});
+        if (inputReady.waitUntil(deadline, ready, spinBeforeSleep)) {
             if (!running) break;
-            msg = inputQueue.front();
-            inputQueue.pop();
-        }
 
-        switch (msg.kind) {
-            case BridgeMessage::Kind::JoystickInput:
-                stateMachine->handleInput(msg.joystickInput);
-                break;
-            case BridgeMessage::Kind::JAUSResponse:
+            for (uint32_t responses = pendingResponses.exchange(0); responses != 0; responses--) {
                 stateMachine->handleResponse();
-                break;
+            }
+
+            // Button edges in order, then the newest stick position unless an edge already carried it
+            JoystickInput input;
+            while (eventRing.pop(input)) {
+                handleInput(input);
+            }
+            // The ring has room again, let the tracker strand move the backlog in
+            if (backlogged.exchange(false, std::memory_order_acq_rel)) {
+                inputStrand->post([this]() {
+                    drainBacklog();
+                    inputReady.notify();
+                });
+            }
+            if (latestInput.take(input) && input.sequence > handledSequence) {
+                handleInput(input);
+            }
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        checkHeartbeat(now);
+        joystickDisplay().flush(now);
+        if (controlTicks.due(now)) {
+            controlTick(now);
         }
     }
 }
 
+void JausBridge::controlTick(std::chrono::steady_clock::time_point now) {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
 
-bool JausBridge::evaluateCoapJausMessage(JausBridge::JausPort jausPort, const uint8_t* payload, size_t payloadLen) {
-    bool ret = true; // Assume we handled the message
-
-    switch(jausPort) {
-        case JausPort::SAFETY: // Safety
-            break;
-        case JausPort::DIAGNOSTICS: // Diagnostics
-            break;
-        case JausPort::SAFETYCOMBINED: // Safety Combined
-            break;
-        case JausPort::RADIOMODE: // Radio Mode
-            break;
-        case JausPort::RADIOPOWER: // Radio Power
-            break;
-        case JausPort::RADIOCHANNEL: // Radio Channel
-            break;
-        case JausPort::RADIOSTATUS: // Radio Status
-            break;
-        case JausPort::RADIOUSED: // Radio Used
-            break;
-        case JausPort::FIRMWAREVERSION: // Firmware Version
-            if (payloadLen != 0) {
-                std::string firmware(reinterpret_cast<const char*>(payload), payloadLen);
-                std::cout << "JAUS: Received Firmware Version: " << firmware << std::endl;
-            }
-            break;
-        case JausPort::CPUTEMP: // CPU Temp
-            if (payloadLen != 0) {
-                std::cout << "JAUS: CPU Temperature: " << payload << std::endl;
-            }
-            break;
-        case JausPort::DEVICETEMP: // Device Temp
-            break;
-        case JausPort::GAUGETEMP: // Gauge Temp
-            break;
-        case JausPort::GYROTEMP: // Gyro Temp
-            break;
-        case JausPort::BATTERYSTATUS: // Battery Status
-            if (payloadLen != 0) {
-                batteryStatus = decode_battery_payload(payload, payloadLen);
-                spdlog::debug("JAUS: Battery Status - {}% | {:.2f}V | {:.2f}C | {:.2f}A",
-                    batteryStatus.percent, batteryStatus.volts, batteryStatus.tempC, batteryStatus.amps);
-                }
-            break;
-        case JausPort::SYSTEMSTATUS: // System Status
-            if (payloadLen != 0) {
-                std::string systemStatus = std::string(reinterpret_cast<const char*>(payload), payloadLen);
-                std::cout << "JAUS: System Status: " << systemStatus << std::endl;
-            }
-            break;
-        case JausPort::LOCKDOWNSTATUS: // Lockdown Status
-            break;
-        case JausPort::SERIALNUMBER: // Serial Number
-            if (payloadLen != 0) {
-                std::string serial(reinterpret_cast<const char*>(payload), payloadLen);
-                serialNumber = serial;
-                spdlog::debug("JAUS: Received Serial Number: {}", serial);
-                std::cout << "JAUS: Received Serial Number: " << serial << std::endl;
-            }
-            break;
-        case JausPort::MODELNUMBER: // Model Number
-            if (payloadLen != 0) {
-                std::string model(reinterpret_cast<const char*>(payload), payloadLen);
-                modelNumber = model;
-                spdlog::debug("JAUS: Received Model Number: {}", model);
-                std::cout << "JAUS: Received Model Number: " << model << std::endl;
-            }
-            break;
-        case JausPort::DEVICEMAC: // Device MAC
-            break;
-        case JausPort::DEVICEUID: // Device UID
-            break;
-        case JausPort::DEVICEREV: // Device Rev
-            break;
-        case JausPort::SYSTEMRESET: // System Reset
-            break;
-        case JausPort::DISPLAYMODE: // Display Mode
-                if (payloadLen != 0) {
-                    spdlog::debug("JAUS: Received Display Mode payload of length {}", payloadLen);
-                }
-            break;
-        case JausPort::VIBRATIONLEFT: // Vibration Left
-            break;
-        case JausPort::VIBRATIONRIGHT: // Vibration Right
-            break;
-        case JausPort::VIBRATIONBOTH: // Vibration Both
-            break;
-        case JausPort::FIRMWAREFILEDATA: // Firmware File Data
-            break;
-        case JausPort::FIRMWAREFILEMETADATA: // Firmware File Metadata
-            break;
-        case JausPort::KEYPAD : // Keypad
-            break;
-        case JausPort::JOYSTICKCALIBRATED : // Calibrated Joystick
-            break;
-        case JausPort::COMBINEDJOYSTICKKEYPAD: // Combined Joystick
-            if (decode_combined_payload(payload, payloadLen) ){
-                spdlog::debug("JAUS: Decoded combined joystick payload successfully");
-                postInput(*reinterpret_cast<const frc_combined_data_t*>(payload));
-            } else {
-                spdlog::warn("JAUS: Failed to decode combined joystick payload");                       
-            }
-            break;
-        case JausPort::FSODATA: // FSO Data
-            break;
-        case JausPort::OPTKEY: // OTP Key
-            break;
-        case JausPort::OPTCOMMIT: // OTP Commit
-            break;
-        case JausPort::LOCKDOWNPROCESSORKEY: // Lockdown Processor Key
-            break;
-        case JausPort::SCP03ROTATE: // SCP03 Rotate
-            break;
-        case JausPort::OTPWRITEDEVTEST: // OTP Write Dev Test
-            break;
-        case JausPort::DISPLAYTEXT : // Display Text
-            break;
-        default:
-            spdlog::warn("JAUS: Unknown port {}, cannot handle message", static_cast<uint16_t>(jausPort));
-            ret = false; // Did not handle the message
-            break;
+    tickJitterUs.record(duration_cast<microseconds>(now - controlTicks.deadline()).count());
+    stateMachine->update();
+
+    const auto done = std::chrono::steady_clock::now();
+    tickDurationUs.record(duration_cast<microseconds>(done - now).count());
+    controlTicks.complete(done);
+}
+
+void JausBridge::checkHeartbeat(std::chrono::steady_clock::time_point now) {
+    std::chrono::steady_clock::duration silent{};
+    if (!heartbeat.expired(now, silent)) {
+        return;
     }
-    return ret;
+    spdlog::warn("JAUS heartbeat lost, nothing from the vehicle for {} ms",
+                 std::chrono::duration_cast<std::chrono::milliseconds>(silent).count());
+    stateMachine->handleHeartbeatLost();
+
+    // From the last report to the state machine having acted on the loss
+    heartbeatDetectionMs.record(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - (now - silent)).count());
+}
+
+void JausBridge::handleInput(const JoystickInput& input) {
+    handoffLatencyUs.record(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - input.posted).count());
+    handledSequence = input.sequence;
+    stateMachine->handleInput(input.data);
+}
+
+void JausBridge::reportStats() const {
+    const WakeSignal::Stats wake = inputReady.stats();
+    spdlog::info("JAUS handoff       : latency us {}, event depth {}, {} conflated, {} backlogged, {} dropped, "
+                 "{} sleeps, {} wakeups, {} spin hits",
+                 handoffLatencyUs.summary(), queueDepth.summary(), inputsConflated.load(std::memory_order_relaxed),
+                 eventsBacklogged.load(std::memory_order_relaxed), eventsDropped.load(std::memory_order_relaxed),
+                 wake.sleeps, wake.wakeups, wake.spinHits);
+    const JoystickFilter::Stats filtered = joystickFilter.stats();
+    spdlog::info("Joystick filter    : {}/{} samples forwarded ({:.1f}% suppressed), {} keypad changes, "
+                 "jitter suppressed per axis lx {} ly {} lz {} rx {} ry {} rz {}",
+                 filtered.forwarded, filtered.samples, 100.0 * joystickFilter.suppressionRatio(),
+                 filtered.keypadChanges, filtered.axisSuppressed[0], filtered.axisSuppressed[1],
+                 filtered.axisSuppressed[2], filtered.axisSuppressed[3], filtered.axisSuppressed[4],
+                 filtered.axisSuppressed[5]);
+    const TickSchedule::Stats control = controlTicks.stats();
+    spdlog::info("JAUS control tick  : {} ticks every {} us, jitter us {}, duration us {}, {} overruns",
+                 control.ticks, std::chrono::duration_cast<std::chrono::microseconds>(controlTicks.period()).count(),
+                 tickJitterUs.summary(), tickDurationUs.summary(), control.overruns);
+    const JoystickDisplay::Stats display = joystickDisplay().stats();
+    spdlog::info("Joystick display   : {} requests, {} unchanged, {} coalesced, {} segment writes, "
+                 "{} half writes, {} mode switches, {} mode switches skipped",
+                 display.requests, display.unchanged, display.coalesced, display.segments, display.halves,
+                 display.modeSwitches, display.modeSkipped);
+    const HeartbeatMonitor::Stats pulse = heartbeat.stats();
+    spdlog::info("JAUS heartbeat     : {} reports, {} losses, {} recoveries, timeout {} ms, detection ms {}",
+                 pulse.beats, pulse.losses, pulse.recoveries,
+                 std::chrono::duration_cast<std::chrono::milliseconds>(heartbeat.timeout()).count(),
+                 heartbeatDetectionMs.summary());
+    const WrenchStreamer::Stats wrench = WrenchStreamer::stats();
+    spdlog::info("JAUS wrench stream : {} sent every {} us, {} samples, {} superseded, {} held, {} expired",
+                 wrench.sent,
+                 std::chrono::duration_cast<std::chrono::microseconds>(WrenchStreamer::period()).count(),
+                 wrench.samples, wrench.superseded, wrench.held, wrench.expired);
+    subscriptions.reportStats();
+}
+
+
+namespace {
+    std::string payloadText(const Coap::MessageView &msg) {
+        return std::string(reinterpret_cast<const char*>(msg.payload), msg.payloadLength);
     }
 
-void JausBridge::postJAUSResponse() {
-    {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        BridgeMessage msg;
-        msg.kind = BridgeMessage::Kind::JAUSResponse;
-        inputQueue.push(msg);
+    // Queued for the console thread, the callers run on the tracker strand which must never wait on stdout
+    void printLine(const std::string& text) {
+        if (printToConsole.enabled()) {
+            printToConsole.post(text + "\n");
+        }
     }
-    queueCV.notify_one();
 }
 
+void JausBridge::registerResponseHandlers(ResponseDispatcher& dispatcher) {
+    // Resources without a handler here are requested for their side effect only (POSTs, vibration,
+    // display text); their responses are counted as unhandled and dropped by the dispatcher.
+    auto on = [&dispatcher](JausPort port, const char* name, ResponseDispatcher::Handler handler) {
+        dispatcher.registerHandler(static_cast<uint16_t>(port), name, std::move(handler));
+    };
+
+    on(JausPort::FIRMWAREVERSION, "firmwareVersion", [](const Coap::MessageView& msg) {
+        if (msg.payloadLength != 0) {
+            printLine("JAUS: Received Firmware Version: " + payloadText(msg));
+        }
+    });
+
+    on(JausPort::CPUTEMP, "cpuTemp", [](const Coap::MessageView& msg) {
+        if (msg.payloadLength != 0) {
+            printLine("JAUS: CPU Temperature: " + payloadText(msg));
+        }
+    });
+
+    on(JausPort::BATTERYSTATUS, "batteryStatus", [this](const Coap::MessageView& msg) {
+        if (msg.payloadLength != 0) {
+            batteryStatus = decode_battery_payload(msg.payload, msg.payloadLength);
+            spdlog::debug("JAUS: Battery Status - {}% | {:.2f}V | {:.2f}C | {:.2f}A",
+                batteryStatus.percent, batteryStatus.volts, batteryStatus.tempC, batteryStatus.amps);
+        }
+    });
+
+    on(JausPort::SYSTEMSTATUS, "systemStatus", [](const Coap::MessageView& msg) {
+        if (msg.payloadLength != 0) {
+            printLine("JAUS: System Status: " + payloadText(msg));
+        }
+    });
+
+    on(JausPort::SERIALNUMBER, "serialNumber", [this](const Coap::MessageView& msg) {
+        if (msg.payloadLength != 0) {
+            serialNumber = payloadText(msg);
+            spdlog::debug("JAUS: Received Serial Number: {}", serialNumber);
+            printLine("JAUS: Received Serial Number: " + serialNumber);
+        }
+    });
+
+    on(JausPort::MODELNUMBER, "modelNumber", [this](const Coap::MessageView& msg) {
+        if (msg.payloadLength != 0) {
+            modelNumber = payloadText(msg);
+            spdlog::debug("JAUS: Received Model Number: {}", modelNumber);
+            printLine("JAUS: Received Model Number: " + modelNumber);
+        }
+    });
 
+    on(JausPort::DISPLAYMODE, "displayMode", [](const Coap::MessageView& msg) {
+        if (msg.payloadLength != 0) {
+            spdlog::debug("JAUS: Received Display Mode payload of length {}", msg.payloadLength);
+        }
+    });
+
+    on(JausPort::COMBINEDJOYSTICKKEYPAD, "combinedJoystick", [this](const Coap::MessageView& msg) {
+        subscriptions.onNotification(static_cast<uint16_t>(JausPort::COMBINEDJOYSTICKKEYPAD), msg);
+        if (decode_combined_payload(msg.payload, msg.payloadLength)) {
+            spdlog::debug("JAUS: Decoded combined joystick payload successfully");
+            postInput(*reinterpret_cast<const frc_combined_data_t*>(msg.payload));
+        } else {
+            spdlog::warn("JAUS: Failed to decode combined joystick payload");
+        }
+    });
+}
 
-void JausBridge::postInput(const frc_combined_data_t& input) {
-    if (std::memcmp(&input, &lastJs, sizeof(frc_combined_data_t)) == 0) {
-        return; // No change, no need to post constantly
+void JausBridge::postJAUSResponse() {
+    pendingResponses.fetch_add(1, std::memory_order_relaxed);
+    inputReady.notify();
+}
+
+
+
+void JausBridge::postInput(const frc_combined_data_t& notified) {
+    const bool paused = notified.joystick_data.leftXAxis.dataOK == 0;
+    if (!paused && !isButtonPressed(notified.keypad_data.buttonStatus, KeypadButton::Pause)) {
+        // Before filtering: a stick held still is still live, the wrench stream may keep repeating it
+        WrenchStreamer::confirm();
+    }
+
+    frc_combined_data_t input = notified;
+    if (!joystickFilter.accept(input)) {
+        return; // No change beyond sensor noise, no need to post constantly
     }
-    lastJs = input;
 
-    if (input.joystick_data.leftXAxis.dataOK == 0) {
+    if (paused) {
         // nothing is going to be shown on the joystick screen if data is not OK
-        std::cout << "JAUS: Pause button pressed on keypad." << std::endl;
+        printLine("JAUS: Pause button pressed on keypad.");
+        // The sticks are no longer read, stop commanding their last deflection
+        input.joystick_data = frc_joystick_data_t{};
+        publishInput(input);
     }
     else if (isButtonPressed(input.keypad_data.buttonStatus, KeypadButton::Pause)) {
         // have to wait until data is Ok before printing again - TODO - reprint last message?
-        std::cout << "JAUS: Pause button releasing." << std::endl;
+        printLine("JAUS: Pause button releasing.");
     } else {    // normal operation
-        std::lock_guard<std::mutex> lock(queueMutex);
-        BridgeMessage msg;
-        msg.joystickInput = input;
-        msg.kind = BridgeMessage::Kind::JoystickInput;
-        inputQueue.push(msg);
+        publishInput(input);
+    }
+}
+
+void JausBridge::publishInput(const frc_combined_data_t& input) {
+    const JoystickInput sample{input, std::chrono::steady_clock::now(), ++inputSequence};
+    const bool buttonEdge = input.keypad_data.buttonStatus != postedButtons;
+    postedButtons = input.keypad_data.buttonStatus;
+
+    // Keep everything in order behind the backlog until the ring has room for it again
+    if (!drainBacklog() || (buttonEdge && !eventRing.push(sample))) {
+        if (eventBacklog.full()) {
+            // The service thread has been stuck for a few hundred edges, nothing left to keep order for
+            eventsDropped.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            eventBacklog.push_back(sample);
+            eventsBacklogged.fetch_add(1, std::memory_order_relaxed);
+        }
+        backlogged.store(true, std::memory_order_release);
+    } else if (buttonEdge) {
+        queueDepth.record(eventRing.size());
+    } else if (!latestInput.publish(sample)) {
+        inputsConflated.fetch_add(1, std::memory_order_relaxed);
+    }
+    inputReady.notify();
+}
+
+bool JausBridge::drainBacklog() {
+    // Tracker strand only.  False if edges are still waiting, the service thread is then told to ask again.
+    while (!eventBacklog.empty() && eventRing.push(eventBacklog.front())) {
+        eventBacklog.pop_front();
+    }
+    if (eventBacklog.empty()) {
+        return true;
     }
-    queueCV.notify_one();
+    backlogged.store(true, std::memory_order_release);
+    return false;
 }
 
 /*
@@ -1,3 +1,5 @@
+#include <sstream>
+
 #include <spdlog/spdlog.h>
 
 #include <fort_agent/fort_agent.h>
@@ -8,6 +10,7 @@
 using namespace openjaus;
 using namespace openjaus::core_v1_1::accesscontrol;
 using namespace openjaus::core_v1_1::management;
+using namespace openjaus::core_v1_1::liveness;
 using namespace openjaus::mobility_v1_1::globalposesensor; // Pull in all GlobalPoseSensor messages
 using namespace openjaus::mobility_v1_1::primitivedriver;  // Pull in all PrimitiveDriver messages
 using namespace openjaus::core_v1_1::informclass::fields::reportstatus;
@@ -16,11 +19,31 @@ using openjaus::mobility_v1_1::PrimitiveDriver;
 
 const std::string JAUS_CLIENT_VERSION = "1.0.0";
 
-// Static member initialization
-bool JAUSClientImpl::controlGranted = false;
-bool JAUSClientImpl::requestPending = false;
-
+namespace {
+    std::string addressText(const transport::Address& address) {
+        std::ostringstream text;
+        text << address;
+        return text.str();
+    }
+}
 
+// Static member initialization
+std::atomic<bool> JAUSClientImpl::controlGranted{false};
+std::atomic<bool> JAUSClientImpl::requestPending{false};
+std::atomic<std::chrono::steady_clock::rep> JAUSClientImpl::statusQuerySentAt{0};
+std::atomic<bool> JAUSClientImpl::vehicleReady{false};
+std::atomic<uint32_t> JAUSClientImpl::controlledComponent{0};
+transport::Address JAUSClientImpl::ownAddress;
+
+std::mutex JAUSClientImpl::statusMutex;
+SeqlockSnapshot<PoseReport> JAUSClientImpl::latestPose;
+SeqlockSnapshot<GeomagneticReport> JAUSClientImpl::latestGeomagnetic;
+SeqlockSnapshot<WrenchReport> JAUSClientImpl::latestWrench;
+SeqlockSnapshot<ControlReport> JAUSClientImpl::latestControl;
+std::atomic<uint64_t> JAUSClientImpl::poseCount{0};
+std::atomic<uint64_t> JAUSClientImpl::geomagneticCount{0};
+std::atomic<uint64_t> JAUSClientImpl::wrenchCount{0};
+std::atomic<uint64_t> JAUSClientImpl::controlCount{0};
 reportstatusrec::Status JAUSClientImpl::currentStatus = reportstatusrec::Status::INITIALIZE;
 
 // Verbose functions..
@@ -32,7 +55,11 @@ JAUSClientImpl::JAUSClientImpl()
       reportWrenchEffortSubscriptionId(0),
       component("FORTClientComponent_v1_1"){
       }
-      
+
+JAUSClientImpl::~JAUSClientImpl() {
+    stopRefresher();
+}
+
 void JAUSClientImpl::initializeJAUS() {
       
     // Constructor implementation
@@ -46,10 +73,14 @@ void JAUSClientImpl::initializeJAUS() {
     // Add the callbacks that will execute when specific messages are received.
     component.addMessageCallback(&JAUSClientImpl::handleIncomingReportControl);
     component.addMessageCallback(&JAUSClientImpl::handleIncomingReportStatus);
+    component.addMessageCallback(&JAUSClientImpl::handleIncomingReportHeartbeatPulse);
     component.addMessageCallback(&JAUSClientImpl::handleIncomingReportGlobalPose);
     component.addMessageCallback(&JAUSClientImpl::handleIncomingReportGeomagneticProperty);
     component.addMessageCallback(&JAUSClientImpl::handleIncomingReportWrenchEffort);
 
+    // Set before any callback can run, ReportControl is compared against it
+    ownAddress = component.getAddress();
+
     try
     {
         // Run the Components which starts the sending/receiving/processing of messages
@@ -57,33 +88,170 @@ void JAUSClientImpl::initializeJAUS() {
     }
     catch(const std::exception& e)
     {
-        std::cerr << e.what() << '\n';
+        spdlog::error("OpenJAUS component failed to run: {}", e.what());
     }
-    
 
+    // The registry is only ever queried from here on, never from the JAUS service thread
+    discoveryRunning = true;
+    discoveryThread = std::thread(&JAUSClientImpl::refreshVehicles, this);
+    StatTrace::addReporter([this]() {
+        const VehicleDirectory::Stats stats = vehicles.stats();
+        const auto age = vehicles.age();
+        spdlog::info("JAUS discovery     : {} vehicles, {} ms old, {} refreshes, {} changes, {} reads",
+                     vehicles.snapshot()->vehicles.size(),
+                     age == VehicleDirectory::Clock::duration::max()
+                         ? -1 : std::chrono::duration_cast<std::chrono::milliseconds>(age).count(),
+                     stats.refreshes, stats.changes, stats.reads);
+    });
+    // Text is only rendered here and by the console view, never in the receive callbacks
+    StatTrace::addReporter([]() {
+        PoseReport pose;
+        if (loadPose(pose)) {
+            spdlog::info("JAUS pose          : {} reports, {}", pose.count, renderSummary(pose));
+        }
+        WrenchReport wrench;
+        if (latestWrench.load(wrench)) {
+            spdlog::info("JAUS wrench        : {} reports, {}", wrench.count, renderSummary(wrench));
+        }
+        ControlReport control;
+        if (latestControl.load(control)) {
+            spdlog::info("JAUS control report: {} reports, {}", control.count, renderSummary(control));
+        }
+    });
+    printToConsole.setView(&JAUSClientImpl::renderChangedReports);
 }
 
-bool JAUSClientImpl::discoverVehicle() {
-    std::vector<transport::Address> pdList = component.getSystemRegistry()->lookupService(PrimitiveDriver::uri());
+void JAUSClientImpl::refreshVehicles() {
+    std::unique_lock<std::mutex> lock(discoveryMutex);
+    while (discoveryRunning) {
+        discoveryRequested = false;
+        lock.unlock();
+
+        std::vector<VehicleDirectory::Vehicle> found;
+        for (const auto& address : component.getSystemRegistry()->lookupService(PrimitiveDriver::uri())) {
+            const uint32_t id = packAddress(address);
+            // Names don't change while a component is registered, only new ones are looked up
+            std::string name = vehicles.knownName(id);
+            if (name.empty()) {
+                bool success = false;
+                const auto info = component.getSystemRegistry()->getComponent(address, success);
+                if (success) {
+                    name = info.getName();
+                }
+            }
+            found.push_back({id, name});
+        }
 
-    if (pdList.size() == 0)  {
-        std::cout << "No components found with the PrimitiveDriver service" << std::endl;
-        return false;
+        if (vehicles.update(std::move(found))) {
+            const auto snapshot = vehicles.snapshot();
+            spdlog::info("Components with the PrimitiveDriver service ({}):", snapshot->vehicles.size());
+            for (size_t i = 0; i < snapshot->vehicles.size(); i++) {
+                const auto& vehicle = snapshot->vehicles[i];
+                spdlog::info("\t{}: {}.{}.{} {}", i, vehicle.id >> 16, (vehicle.id >> 8) & 0xFF, vehicle.id & 0xFF,
+                             vehicle.name);
+            }
+        }
+
+        lock.lock();
+        discoveryWake.wait_for(lock, discoveryInterval, [this] { return !discoveryRunning || discoveryRequested; });
     }
-    else
+}
+
+void JAUSClientImpl::stopRefresher() {
     {
-        std::cout << "Components with the PrimitiveDriver service (" << pdList.size() << "):" << std::endl;
-        for (size_t i = 0; i < pdList.size(); i++)
+        std::lock_guard<std::mutex> lock(discoveryMutex);
+        discoveryRunning = false;
+    }
+    discoveryWake.notify_all();
+    if (discoveryThread.joinable()) {
+        discoveryThread.join();
+    }
+}
+
+bool JAUSClientImpl::discoverVehicle() {
+    // Answered from the refresher's last result, the registry is never queried on this thread
+    const auto snapshot = vehicles.snapshot();
+    const auto age = std::chrono::duration_cast<std::chrono::milliseconds>(vehicles.age());
+
+    if (snapshot->vehicles.empty())  {
+        spdlog::info("No components found with the PrimitiveDriver service, last looked {} ms ago",
+                     age.count());
         {
-            std::cout << "\t" << (int)i << ": " << pdList.at(i) << std::endl;
+            // Look again now rather than at the next interval, the operator will likely retry
+            std::lock_guard<std::mutex> lock(discoveryMutex);
+            discoveryRequested = true;
         }
-        std::cout << std::endl;
+        discoveryWake.notify_one();
+        return false;
+    }
 
-        serverAddress = pdList[0];
-        std::cout << "Auto-selecting Component [0]: " << serverAddress << std::endl;
-        std::cout << std::endl;
+    const VehicleDirectory::Vehicle& best = snapshot->vehicles.front();
+    const transport::Address address(static_cast<uint16_t>(best.id >> 16), static_cast<uint8_t>(best.id >> 8),
+                                     static_cast<uint8_t>(best.id));
+    if (packAddress(serverAddress) != best.id || !serverAddress.isValid()) {
+        unsubscribeFromStateEvents();
+        serverAddress = address;
+        controlledComponent.store(best.id, std::memory_order_relaxed);
+        // A query to the previous vehicle will never be answered by this one
+        statusQuerySentAt.store(0, std::memory_order_release);
+        subscribeToStateEvents();
     }
-    return true; // Placeholder
+    serverName = best.name;
+    vehicles.prefer(best.id);
+    spdlog::info("Auto-selecting Component [0] of {}: {} {}, list {} ms old", snapshot->vehicles.size(),
+                 addressText(serverAddress), serverName, age.count());
+    return true;
+}
+
+void JAUSClientImpl::subscribeToStateEvents() {
+    // The vehicle reports status and control changes as they happen, so nothing polls for them
+    reportStatusSubscriptionId = component.subscribeOnChange(serverAddress, new QueryStatus(),
+                                                             handleEventRequestResponse);
+    reportStatusSubscribed = true;
+    reportControlSubscriptionId = component.subscribeOnChange(serverAddress, new QueryControl(),
+                                                              handleEventRequestResponse);
+    reportControlSubscribed = true;
+
+    // Several pulses per timeout, so one lost pulse doesn't read as a dead vehicle
+    const double timeoutSeconds =
+        std::chrono::duration<double>(JausBridgeSingleton::instance().heartbeatTimeout()).count();
+    reportHeartbeatPulseSubscriptionId = component.subscribePeriodic(
+        serverAddress, new QueryHeartbeatPulse(), 4.0 / timeoutSeconds, handleEventRequestResponse);
+    reportHeartbeatPulseSubscribed = true;
+}
+
+void JAUSClientImpl::unsubscribeFromStateEvents() {
+    if (reportStatusSubscribed) {
+        component.unsubscribe(serverAddress, reportStatusSubscriptionId);
+        reportStatusSubscribed = false;
+    }
+    if (reportControlSubscribed) {
+        component.unsubscribe(serverAddress, reportControlSubscriptionId);
+        reportControlSubscribed = false;
+    }
+    if (reportHeartbeatPulseSubscribed) {
+        component.unsubscribe(serverAddress, reportHeartbeatPulseSubscriptionId);
+        reportHeartbeatPulseSubscribed = false;
+    }
+}
+
+uint32_t JAUSClientImpl::packAddress(const transport::Address& address) {
+    return (static_cast<uint32_t>(address.getSubsystem()) << 16) |
+           (static_cast<uint32_t>(address.getNode()) << 8) | address.getComponent();
+}
+
+bool JAUSClientImpl::noteReportFrom(const transport::Address& source) {
+    const uint32_t controlled = controlledComponent.load(std::memory_order_relaxed);
+    if (controlled == 0 || packAddress(source) != controlled) {
+        return false;
+    }
+    JausBridgeSingleton::instance().postHeartbeat();
+    return true;
+}
+
+void JAUSClientImpl::notifyTransition(const char* what) {
+    spdlog::debug("JAUS {} changed, waking the state machine", what);
+    JausBridgeSingleton::instance().postJAUSResponse();
 }
 
 bool JAUSClientImpl::sendRequestControl() {
@@ -99,19 +267,19 @@ bool JAUSClientImpl::sendRequestControl() {
     // The requestControl method sends a RequestControl message with a SAFETY_CRITICAL priority.
     // When a response is received (ConfirmControl or RejectControl) the provided callback will
     // be executed.
+    // Marked pending first, the response callback may run before requestControl returns
+    JAUSClientImpl::requestPending.store(true, std::memory_order_release);
     component.requestControl(serverAddress, 128, handleRequestControlResponse);
-
-    JAUSClientImpl::requestPending = true;
     return true;
 }
 
 bool JAUSClientImpl::isRequestPending() const {
-    return JAUSClientImpl::requestPending;
-}   
+    return JAUSClientImpl::requestPending.load(std::memory_order_acquire);
+}
 
 bool JAUSClientImpl::hasControl() const {
-    // Implementation to check if control is granted, 
-    return JAUSClientImpl::controlGranted;
+    // Kept current by the RequestControl response and ReportControl events
+    return JAUSClientImpl::controlGranted.load(std::memory_order_acquire);
 }
 
 bool JAUSClientImpl::sendRequestResume() {
@@ -130,49 +298,47 @@ bool JAUSClientImpl::queryStatus() {
     if (!serverAddress.isValid()) {
         return false;
     }
-    // previous status request is pending 
-    if (isRequestPending()) {
+    // A one-off query for the current status, later changes arrive as ReportStatus events.  One
+    // at a time, but a query whose answer was lost doesn't block the next one for long.
+    const auto now = std::chrono::steady_clock::now();
+    const auto sentAt = statusQuerySentAt.load(std::memory_order_acquire);
+    if (sentAt != 0 && now - std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(sentAt)) <
+                           statusQueryTimeout) {
         // we must wait for response
         return false;
     }
+    statusQuerySentAt.store(now.time_since_epoch().count(), std::memory_order_release);
 
     QueryStatus* message = new QueryStatus();
     message->setDestination(serverAddress);
     component.sendMessage(message);
-    JAUSClientImpl::requestPending = true;
 
     return true;
 }
 
 bool JAUSClientImpl::hasReadyState() const {
-    // Implementation of ready state check
-    return currentStatus == reportstatusrec::Status::READY; // Placeholder
+    return vehicleReady.load(std::memory_order_acquire);
 }
 bool JAUSClientImpl::isHeartbeatAlive() const {
-    // Implementation of heartbeat check
-    return true; // Placeholder
+    // Fed by every report from the controlled component, the bridge pushes the loss itself
+    return JausBridgeSingleton::instance().isHeartbeatAlive();
 }
 
 void JAUSClientImpl::sendWrenchEffort(const frc_joystick_data_t& data) {
-    
-    // Implementation of sending wrench effort
-    std::ostringstream frame;
-
+    // OpenJAUS takes ownership of the message and deletes it once sent, so it can't be reused
     auto* message = new SetWrenchEffort();
     message->setDestination(serverAddress);
 
-    // In this example, we will only set the propulsive linear effort X and propulsive rotational effort Z
-
     auto& wrenchEffortRec = message->getWrenchEffortRec();
 
-    // Enable the propulsive linear effort X field and specify the value
-    wrenchEffortRec.setPropulsiveLinearEffortX_percent(normalizeJoysticValue(data.leftXAxis.data));
-    wrenchEffortRec.setPropulsiveLinearEffortY_percent(normalizeJoysticValue(data.leftYAxis.data));
-    wrenchEffortRec.setPropulsiveLinearEffortZ_percent(normalizeJoysticValue(data.leftZAxis.data));
+    // Propulsive efforts straight from the axes, in percent from a compile time table
+    wrenchEffortRec.setPropulsiveLinearEffortX_percent(joystickPercent(data.leftXAxis.data));
+    wrenchEffortRec.setPropulsiveLinearEffortY_percent(joystickPercent(data.leftYAxis.data));
+    wrenchEffortRec.setPropulsiveLinearEffortZ_percent(joystickPercent(data.leftZAxis.data));
 
-    wrenchEffortRec.setPropulsiveRotationalEffortX_percent(normalizeJoysticValue(data.rightXAxis.data));
-    wrenchEffortRec.setPropulsiveRotationalEffortY_percent(normalizeJoysticValue(data.rightYAxis.data));
-    wrenchEffortRec.setPropulsiveRotationalEffortZ_percent(normalizeJoysticValue(data.rightZAxis.data));
+    wrenchEffortRec.setPropulsiveRotationalEffortX_percent(joystickPercent(data.rightXAxis.data));
+    wrenchEffortRec.setPropulsiveRotationalEffortY_percent(joystickPercent(data.rightYAxis.data));
+    wrenchEffortRec.setPropulsiveRotationalEffortZ_percent(joystickPercent(data.rightZAxis.data));
 
     wrenchEffortRec.disableResistiveLinearEffortX();
     wrenchEffortRec.disableResistiveLinearEffortY();
@@ -200,17 +366,13 @@ void JAUSClientImpl::handleRequestControlResponse(const model::ControlResponse&
     frame << "----------------------------------------------------" << std::endl;
 
     // Final flush
-    printToConsole.flushString(frame.str());
-
-    // Set controlGranted based on response
-    // We use a static value to support this in a static method
-    if (response.getResponseType() == model::ControlResponseType::CONTROL_ACCEPTED) {
-        JAUSClientImpl::controlGranted = true;
-    } else {
-        JAUSClientImpl::controlGranted = false; 
-    }
-    JAUSClientImpl::requestPending = false;
-    JausBridgeSingleton::instance().postJAUSResponse();
+    printToConsole.post(frame.str());
+
+    // The states wait on this answer to their request, accepted or not, so it always wakes them
+    const bool granted = response.getResponseType() == model::ControlResponseType::CONTROL_ACCEPTED;
+    JAUSClientImpl::controlGranted.store(granted, std::memory_order_release);
+    JAUSClientImpl::requestPending.store(false, std::memory_order_release);
+    notifyTransition("control response");
 }
 
 void JAUSClientImpl::handleReleaseControlResponse(const model::ControlResponse& response)
@@ -227,84 +389,95 @@ void JAUSClientImpl::handleReleaseControlResponse(const model::ControlResponse&
     frame << "----------------------------------------------------" << std::endl;
 
     // Final flush
-    printToConsole.flushString(frame.str());
+    printToConsole.post(frame.str());
 
     // Not sure what to do on release control response and not CONTROL_RELEASED received
-    if (response.getResponseType() == model::ControlResponseType::CONTROL_RELEASED) {
-        JAUSClientImpl::controlGranted = false;
-    } 
-    JAUSClientImpl::requestPending = false;
-    JausBridgeSingleton::instance().postJAUSResponse();
+    JAUSClientImpl::requestPending.store(false, std::memory_order_release);
+    if (response.getResponseType() == model::ControlResponseType::CONTROL_RELEASED &&
+        JAUSClientImpl::controlGranted.exchange(false, std::memory_order_acq_rel)) {
+        notifyTransition("control");
+    }
 }
 
 bool JAUSClientImpl::handleIncomingReportControl(ReportControl& incoming)
 {
+    // e.g. from the previous vehicle while its unsubscribe is in flight
+    if (!noteReportFrom(incoming.getSource())) {
+        return true;
+    }
     auto& controlRec = incoming.getReportControlRec();
 
-    std::ostringstream frame;
-
-    frame << std::endl;
-
-    frame << "----------------------------------------------------" << std::endl;
-    frame << " Report Control" << std::endl;
-    frame << "----------------------------------------------------" << std::endl;
-    frame << " SubystemID: " << (uint32)controlRec.getSubsystemID() << std::endl;
-    frame << " NodeID: " << (uint32)controlRec.getNodeID() << std::endl;
-    frame << " ComponentID: " << (uint32)controlRec.getComponentID() << std::endl;
-    frame << " AuthorityCode: " << (uint32)controlRec.getAuthorityCode() << std::endl;
-    frame << "----------------------------------------------------" << std::endl;
-
-    // Final flush
-    printToConsole.flushString(frame.str());
-
+    ControlReport report{};
+    report.subsystemId = controlRec.getSubsystemID();
+    report.nodeId = controlRec.getNodeID();
+    report.componentId = controlRec.getComponentID();
+    report.authorityCode = controlRec.getAuthorityCode();
+    report.count = controlCount.fetch_add(1, std::memory_order_relaxed) + 1;
+    latestControl.store(report);
+
+    // Sent on change, and names whoever holds control now; the states only care whether it is us
+    const bool ours = controlRec.getSubsystemID() == ownAddress.getSubsystem() &&
+                      controlRec.getNodeID() == ownAddress.getNode() &&
+                      controlRec.getComponentID() == ownAddress.getComponent();
+    if (JAUSClientImpl::controlGranted.exchange(ours, std::memory_order_acq_rel) != ours) {
+        notifyTransition("control");
+    }
     return true;
 }
 
 bool JAUSClientImpl::handleIncomingReportStatus(ReportStatus& incoming)
 {
+    if (!noteReportFrom(incoming.getSource())) {
+        return true;
+    }
     const auto& reportRec = incoming.getReportStatusRec();
 
-    std::ostringstream frame;
-
-    frame << std::endl;
-
-    frame << "----------------------------------------------------" << std::endl;
-    frame << " Report Status" << std::endl;
-    frame << "----------------------------------------------------" << std::endl;
-    frame << " Status: " << reportRec.getStatus().toString() << std::endl;
-    frame << "----------------------------------------------------" << std::endl;
-
-    // Final flush
-    printToConsole.flushString(frame.str());
+    // Only transitions are logged, the on-change subscription makes repeats rare anyway
+    {
+        std::lock_guard<std::mutex> lock(statusMutex);
+        if (!(reportRec.getStatus() == currentStatus)) {
+            spdlog::info("JAUS vehicle status {} -> {}", currentStatus.toString(), reportRec.getStatus().toString());
+            currentStatus = reportRec.getStatus();
+        }
+    }
+    statusQuerySentAt.store(0, std::memory_order_release);
 
-    currentStatus = reportRec.getStatus();
+    // Repeated reports of the same status leave the states asleep
+    const bool ready = reportRec.getStatus() == reportstatusrec::Status::READY;
+    if (vehicleReady.exchange(ready, std::memory_order_acq_rel) != ready) {
+        notifyTransition("status");
+    }
+    return true;
+}
 
-    JAUSClientImpl::requestPending = false;
-    JausBridgeSingleton::instance().postJAUSResponse();
+bool JAUSClientImpl::handleIncomingReportHeartbeatPulse(ReportHeartbeatPulse& incoming)
+{
+    // Periodic, so no console frame; it only keeps the liveness deadline moving
+    noteReportFrom(incoming.getSource());
     return true;
 }
 
 bool JAUSClientImpl::handleIncomingReportGlobalPose(ReportGlobalPose& message)
 {
+    noteReportFrom(message.getSource());
     auto& globalPoseRec = message.getGlobalPoseRec();
 
-    std::ostringstream frame;
-
-    frame << std::endl;
-
-    frame << "----------------------------------------------------" << std::endl;
-    frame << " Report Global Pose" << std::endl;
-    frame << "----------------------------------------------------" << std::endl;
-    frame << " Latitude: " << toString(globalPoseRec.getLatitude_deg(), globalPoseRec.isLatitudeEnabled()) << std::endl;
-    frame << " Longitude: " << toString(globalPoseRec.getLongitude_deg(), globalPoseRec.isLongitudeEnabled()) << std::endl;
-    frame << " Altitude: " << toString(globalPoseRec.getAltitude_m(), globalPoseRec.isAltitudeEnabled()) << std::endl;
-    frame << " Roll: " << toString(globalPoseRec.getRoll_rad(), globalPoseRec.isRollEnabled()) << std::endl;
-    frame << " Pitch: " << toString(globalPoseRec.getPitch_rad(), globalPoseRec.isPitchEnabled()) << std::endl;
-    frame << " Yaw: " << toString(globalPoseRec.getYaw_rad(), globalPoseRec.isYawEnabled()) << std::endl;
-    frame << "----------------------------------------------------" << std::endl;
-
-    // Final flush
-    printToConsole.flushString(frame.str());
+    // The magnetic variation comes with ReportGeomagneticProperty and is merged in by loadPose()
+    PoseReport report{};
+    const auto set = [&report](double& field, double value, bool enabled, PoseReport::Field flag) {
+        field = value;
+        if (enabled) {
+            report.fields |= flag;
+        }
+    };
+    set(report.latitudeDeg, globalPoseRec.getLatitude_deg(), globalPoseRec.isLatitudeEnabled(), PoseReport::LATITUDE);
+    set(report.longitudeDeg, globalPoseRec.getLongitude_deg(), globalPoseRec.isLongitudeEnabled(), PoseReport::LONGITUDE);
+    set(report.altitudeM, globalPoseRec.getAltitude_m(), globalPoseRec.isAltitudeEnabled(), PoseReport::ALTITUDE);
+    set(report.rollRad, globalPoseRec.getRoll_rad(), globalPoseRec.isRollEnabled(), PoseReport::ROLL);
+    set(report.pitchRad, globalPoseRec.getPitch_rad(), globalPoseRec.isPitchEnabled(), PoseReport::PITCH);
+    set(report.yawRad, globalPoseRec.getYaw_rad(), globalPoseRec.isYawEnabled(), PoseReport::YAW);
+    report.count = poseCount.fetch_add(1, std::memory_order_relaxed) + 1;
+    latestPose.store(report);
 
     return true;
 }
@@ -313,18 +486,10 @@ bool JAUSClientImpl::handleIncomingReportGeomagneticProperty(ReportGeomagneticPr
 {
     auto& geomagneticRec = message.getGeomagneticPropertyRec();
 
-    std::ostringstream frame;
-
-    frame << std::endl;
-
-    frame << "----------------------------------------------------" << std::endl;
-    frame << " Report Geomagnetic Property" << std::endl;
-    frame << "----------------------------------------------------" << std::endl;
-    frame << " Magnetic Variation: " << geomagneticRec.getMagneticVariation_rad() << std::endl;
-    frame << "----------------------------------------------------" << std::endl;
-
-    // Final flush
-    printToConsole.flushString(frame.str());
+    GeomagneticReport report{};
+    report.magneticVariationRad = geomagneticRec.getMagneticVariation_rad();
+    report.count = geomagneticCount.fetch_add(1, std::memory_order_relaxed) + 1;
+    latestGeomagnetic.store(report);
 
     return true;
 }
@@ -344,82 +509,83 @@ void JAUSClientImpl::handleEventRequestResponse(const model::EventRequestRespons
     frame << "---------------------------" << std::endl;
 
     // Final flush
-    printToConsole.flushString(frame.str());
+    printToConsole.post(frame.str());
 }
 
 bool JAUSClientImpl::handleIncomingReportWrenchEffort(ReportWrenchEffort& message)
 {
+    noteReportFrom(message.getSource());
     auto& wrenchEffortRec = message.getWrenchEffortRec();
 
-    std::ostringstream frame;
-
-    frame << std::endl;
-
-    frame << "----------------------------------------------------" << std::endl;
-    frame << " Report Wrench Effort" << std::endl;
-    frame << "----------------------------------------------------" << std::endl;
-    frame << " Propulive Effort" << std::endl;
-    frame << "   Linear X: " << toString(wrenchEffortRec.getPropulsiveLinearEffortX_percent(), wrenchEffortRec.isPropulsiveLinearEffortXEnabled()) << std::endl;
-    frame << "   Linear Y: " << toString(wrenchEffortRec.getPropulsiveLinearEffortY_percent(), wrenchEffortRec.isPropulsiveLinearEffortYEnabled()) << std::endl;
-    frame << "   Linear Z: " << toString(wrenchEffortRec.getPropulsiveLinearEffortZ_percent(), wrenchEffortRec.isPropulsiveLinearEffortZEnabled()) << std::endl;
-    frame << std::endl;
-    frame << "   Rotational X: " << toString(wrenchEffortRec.getPropulsiveRotationalEffortX_percent(), wrenchEffortRec.isPropulsiveRotationalEffortXEnabled()) << std::endl;
-    frame << "   Rotational Y: " << toString(wrenchEffortRec.getPropulsiveRotationalEffortY_percent(), wrenchEffortRec.isPropulsiveRotationalEffortYEnabled()) << std::endl;
-    frame << "   Rotational Z: " << toString(wrenchEffortRec.getPropulsiveRotationalEffortZ_percent(), wrenchEffortRec.isPropulsiveRotationalEffortZEnabled()) << std::endl;
-    frame << std::endl;
-    frame << std::endl;
-    frame << " Resistive Effort" << std::endl;
-    frame << "   Linear X: " << toString(wrenchEffortRec.getResistiveLinearEffortX_percent(), wrenchEffortRec.isResistiveLinearEffortXEnabled()) << std::endl;
-    frame << "   Linear Y: " << toString(wrenchEffortRec.getResistiveLinearEffortY_percent(), wrenchEffortRec.isResistiveLinearEffortYEnabled()) << std::endl;
-    frame << "   Linear Z: " << toString(wrenchEffortRec.getResistiveLinearEffortZ_percent(), wrenchEffortRec.isResistiveLinearEffortZEnabled()) << std::endl;
-    frame << std::endl;
-    frame << "   Rotational X: " << toString(wrenchEffortRec.getResistiveRotationalEffortX_percent(), wrenchEffortRec.isResistiveRotationalEffortXEnabled()) << std::endl;
-    frame << "   Rotational Y: " << toString(wrenchEffortRec.getResistiveRotationalEffortY_percent(), wrenchEffortRec.isResistiveRotationalEffortYEnabled()) << std::endl;
-    frame << "   Rotational Z: " << toString(wrenchEffortRec.getResistiveRotationalEffortZ_percent(), wrenchEffortRec.isResistiveRotationalEffortZEnabled()) << std::endl;
-    frame << "----------------------------------------------------" << std::endl;
-
-    // Final flush
-    printToConsole.flushString(frame.str());
+    WrenchReport report{};
+    const auto set = [](double& field, ReportFieldMask& fields, size_t axis, double value, bool enabled) {
+        field = value;
+        if (enabled) {
+            fields |= ReportFieldMask(1u << axis);
+        }
+    };
+    set(report.propulsive[0], report.propulsiveFields, 0, wrenchEffortRec.getPropulsiveLinearEffortX_percent(), wrenchEffortRec.isPropulsiveLinearEffortXEnabled());
+    set(report.propulsive[1], report.propulsiveFields, 1, wrenchEffortRec.getPropulsiveLinearEffortY_percent(), wrenchEffortRec.isPropulsiveLinearEffortYEnabled());
+    set(report.propulsive[2], report.propulsiveFields, 2, wrenchEffortRec.getPropulsiveLinearEffortZ_percent(), wrenchEffortRec.isPropulsiveLinearEffortZEnabled());
+    set(report.propulsive[3], report.propulsiveFields, 3, wrenchEffortRec.getPropulsiveRotationalEffortX_percent(), wrenchEffortRec.isPropulsiveRotationalEffortXEnabled());
+    set(report.propulsive[4], report.propulsiveFields, 4, wrenchEffortRec.getPropulsiveRotationalEffortY_percent(), wrenchEffortRec.isPropulsiveRotationalEffortYEnabled());
+    set(report.propulsive[5], report.propulsiveFields, 5, wrenchEffortRec.getPropulsiveRotationalEffortZ_percent(), wrenchEffortRec.isPropulsiveRotationalEffortZEnabled());
+    set(report.resistive[0], report.resistiveFields, 0, wrenchEffortRec.getResistiveLinearEffortX_percent(), wrenchEffortRec.isResistiveLinearEffortXEnabled());
+    set(report.resistive[1], report.resistiveFields, 1, wrenchEffortRec.getResistiveLinearEffortY_percent(), wrenchEffortRec.isResistiveLinearEffortYEnabled());
+    set(report.resistive[2], report.resistiveFields, 2, wrenchEffortRec.getResistiveLinearEffortZ_percent(), wrenchEffortRec.isResistiveLinearEffortZEnabled());
+    set(report.resistive[3], report.resistiveFields, 3, wrenchEffortRec.getResistiveRotationalEffortX_percent(), wrenchEffortRec.isResistiveRotationalEffortXEnabled());
+    set(report.resistive[4], report.resistiveFields, 4, wrenchEffortRec.getResistiveRotationalEffortY_percent(), wrenchEffortRec.isResistiveRotationalEffortYEnabled());
+    set(report.resistive[5], report.resistiveFields, 5, wrenchEffortRec.getResistiveRotationalEffortZ_percent(), wrenchEffortRec.isResistiveRotationalEffortZEnabled());
+    report.count = wrenchCount.fetch_add(1, std::memory_order_relaxed) + 1;
+    latestWrench.store(report);
 
     return true;
 }
 
-// TODO: Move to utility file if needed elsewhere
-double JAUSClientImpl::normalizeJoysticValue(int x) {
-    constexpr int min_raw = -2047;
-    constexpr int max_raw = 2047;
-    constexpr double min_norm = -100.0;
-    constexpr double max_norm = 100.0;
-
-    double scale = (max_norm - min_norm) / (max_raw - min_raw);
-    double midpoint_raw = (max_raw + min_raw) / 2.0;
-    double midpoint_norm = (max_norm + min_norm) / 2.0;
-
-    x = std::max(x, min_raw);
-    x = std::min(x, max_raw);
-    return midpoint_norm + (x - midpoint_raw) * scale;
+bool JAUSClientImpl::loadPose(PoseReport& pose) {
+    pose = PoseReport{};
+    const bool havePose = latestPose.load(pose);
+    GeomagneticReport geomagnetic;
+    if (!latestGeomagnetic.load(geomagnetic)) {
+        return havePose;
+    }
+    pose.magneticVariationRad = geomagnetic.magneticVariationRad;
+    pose.fields |= PoseReport::MAGNETIC_VARIATION;
+    return true;
 }
 
-
-std::string JAUSClientImpl::toString(double value, bool enabled) {
-    std::string output;
-
-    if (enabled) {
-        std::stringstream ss;
-        ss << value;
-        output = ss.str();
-    } else {
-        output = "N/A";
+std::string JAUSClientImpl::renderChangedReports() {
+    // Console thread only, so a burst of reports between two refreshes is rendered once
+    static uint64_t poseShown = 0;
+    static uint64_t geomagneticShown = 0;
+    static uint64_t wrenchShown = 0;
+    static uint64_t controlShown = 0;
+
+    std::string out;
+    PoseReport pose;
+    const uint64_t poseVersion = latestPose.version();
+    const uint64_t geomagneticVersion = latestGeomagnetic.version();
+    if ((poseVersion != poseShown || geomagneticVersion != geomagneticShown) && loadPose(pose)) {
+        out += renderFrame(pose);
+        poseShown = poseVersion;
+        geomagneticShown = geomagneticVersion;
     }
-
-    return output;
+    WrenchReport wrench;
+    const uint64_t wrenchVersion = latestWrench.version();
+    if (wrenchVersion != wrenchShown && latestWrench.load(wrench)) {
+        out += renderFrame(wrench);
+        wrenchShown = wrenchVersion;
+    }
+    ControlReport control;
+    const uint64_t controlVersion = latestControl.version();
+    if (controlVersion != controlShown && latestControl.load(control)) {
+        out += renderFrame(control);
+        controlShown = controlVersion;
+    }
+    return out;
 }
 
 std::string JAUSClientImpl::getComponentName() {
-    bool success = false;
-    auto Info = component.getSystemRegistry()->getComponent(serverAddress, success);
-    if (success)
-        std::cout << Info.toString();
-
-    return Info.getName();
+    // Looked up by the refresher when the component was first seen
+    return serverName.empty() ? addressText(serverAddress) : serverName;
 }
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include <fort_agent/jaus/JausReports.h>
+
+#include <spdlog/fmt/fmt.h>
+
+namespace {
+    const char* const separator = "----------------------------------------------------\n";
+    const char* const axisNames[6] = {"Linear X", "Linear Y", "Linear Z", "Rotational X", "Rotational Y",
+                                      "Rotational Z"};
+
+    std::string field(double value, bool enabled) {
+        return enabled ? fmt::format("{}", value) : "N/A";
+    }
+
+    std::string frame(const char* title, const std::string& body) {
+        return fmt::format("\n{} {}\n{}{}{}", separator, title, separator, body, separator);
+    }
+}
+
+std::string renderFrame(const PoseReport& pose) {
+    const auto has = [&pose](PoseReport::Field f) { return (pose.fields & f) != 0; };
+    return frame("Report Global Pose", fmt::format(
+        " Latitude: {}\n Longitude: {}\n Altitude: {}\n Roll: {}\n Pitch: {}\n Yaw: {}\n Magnetic Variation: {}\n",
+        field(pose.latitudeDeg, has(PoseReport::LATITUDE)), field(pose.longitudeDeg, has(PoseReport::LONGITUDE)),
+        field(pose.altitudeM, has(PoseReport::ALTITUDE)), field(pose.rollRad, has(PoseReport::ROLL)),
+        field(pose.pitchRad, has(PoseReport::PITCH)), field(pose.yawRad, has(PoseReport::YAW)),
+        field(pose.magneticVariationRad, has(PoseReport::MAGNETIC_VARIATION))));
+}
+
+std::string renderFrame(const WrenchReport& wrench) {
+    std::string body = " Propulsive Effort\n";
+    for (size_t axis = 0; axis < wrench.propulsive.size(); axis++) {
+        body += fmt::format("   {}: {}\n", axisNames[axis],
+                            field(wrench.propulsive[axis], (wrench.propulsiveFields >> axis) & 1));
+    }
+    body += " Resistive Effort\n";
+    for (size_t axis = 0; axis < wrench.resistive.size(); axis++) {
+        body += fmt::format("   {}: {}\n", axisNames[axis],
+                            field(wrench.resistive[axis], (wrench.resistiveFields >> axis) & 1));
+    }
+    return frame("Report Wrench Effort", body);
+}
+
+std::string renderFrame(const ControlReport& control) {
+    return frame("Report Control", fmt::format(" SubystemID: {}\n NodeID: {}\n ComponentID: {}\n AuthorityCode: {}\n",
+                                               control.subsystemId, control.nodeId, control.componentId,
+                                               control.authorityCode));
+}
+
+std::string renderSummary(const PoseReport& pose) {
+    const auto has = [&pose](PoseReport::Field f) { return (pose.fields & f) != 0; };
+    return fmt::format("lat {} lon {} alt {} yaw {}", field(pose.latitudeDeg, has(PoseReport::LATITUDE)),
+                       field(pose.longitudeDeg, has(PoseReport::LONGITUDE)),
+                       field(pose.altitudeM, has(PoseReport::ALTITUDE)), field(pose.yawRad, has(PoseReport::YAW)));
+}
+
+std::string renderSummary(const WrenchReport& wrench) {
+    std::string out = "propulsive";
+    for (size_t axis = 0; axis < wrench.propulsive.size(); axis++) {
+        out += " " + field(wrench.propulsive[axis], (wrench.propulsiveFields >> axis) & 1);
+    }
+    return out;
+}
+
+std::string renderSummary(const ControlReport& control) {
+    return fmt::format("held by {}.{}.{} authority {}", control.subsystemId, control.nodeId, control.componentId,
+                       control.authorityCode);
+}
@@ -0,0 +1,95 @@
+#include <fort_agent/jaus/JoystickFilter.h>
+
+#include <cstdlib>
+
+JoystickFilter::JoystickFilter(const Settings& settings) {
+    configure(settings);
+}
+
+void JoystickFilter::configure(const Settings& settings) {
+    for (size_t i = 0; i < axisCount; i++) {
+        deadband[i] = static_cast<int16_t>(std::min<uint16_t>(settings.deadband[i], JOYSTICK_RAW_MAX));
+        hysteresis[i] = static_cast<int16_t>(std::min<uint16_t>(settings.hysteresis[i], JOYSTICK_RAW_MAX));
+    }
+}
+
+JoystickFilter::Axes JoystickFilter::axesOf(const frc_joystick_data_t& data) {
+    return {static_cast<int16_t>(data.leftXAxis.data), static_cast<int16_t>(data.leftYAxis.data),
+            static_cast<int16_t>(data.leftZAxis.data), static_cast<int16_t>(data.rightXAxis.data),
+            static_cast<int16_t>(data.rightYAxis.data), static_cast<int16_t>(data.rightZAxis.data), 0, 0};
+}
+
+uint8_t JoystickFilter::okFlagsOf(const frc_joystick_data_t& data) {
+    return static_cast<uint8_t>(data.leftXAxis.dataOK | data.leftYAxis.dataOK << 1 | data.leftZAxis.dataOK << 2 |
+                                data.rightXAxis.dataOK << 3 | data.rightYAxis.dataOK << 4 |
+                                data.rightZAxis.dataOK << 5);
+}
+
+bool JoystickFilter::accept(frc_combined_data_t& sample) {
+    samples.fetch_add(1, std::memory_order_relaxed);
+
+    const Axes raw = axesOf(sample.joystick_data);
+
+    // Branch-free over all lanes so it vectorizes: snap to centre, then compare with what was sent
+    Axes value;
+    Axes moved;
+    Axes jitter;
+    for (size_t i = 0; i < lanes; i++) {
+        const int16_t magnitude = static_cast<int16_t>(raw[i] < 0 ? -raw[i] : raw[i]);
+        value[i] = magnitude <= deadband[i] ? 0 : raw[i];
+        const int16_t delta = static_cast<int16_t>(value[i] - lastForwarded[i]);
+        const int16_t distance = static_cast<int16_t>(delta < 0 ? -delta : delta);
+        moved[i] = static_cast<int16_t>((distance > hysteresis[i]) | (value[i] == 0 && lastForwarded[i] != 0));
+        jitter[i] = static_cast<int16_t>(raw[i] != lastRaw[i]);
+    }
+    lastRaw = raw;
+
+    int16_t anyMoved = 0;
+    for (size_t i = 0; i < lanes; i++) {
+        anyMoved |= moved[i];
+    }
+
+    const uint8_t okFlags = okFlagsOf(sample.joystick_data);
+    const bool keypadChanged = first || sample.keypad_data.buttonStatus != lastButtons;
+    const bool forward = keypadChanged || okFlags != lastOkFlags || anyMoved != 0;
+    first = false;
+
+    if (!forward) {
+        for (size_t i = 0; i < axisCount; i++) {
+            if (jitter[i]) {
+                axisSuppressed[i].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        return false;
+    }
+
+    if (keypadChanged) {
+        keypadChanges.fetch_add(1, std::memory_order_relaxed);
+    }
+    forwarded.fetch_add(1, std::memory_order_relaxed);
+    lastForwarded = value;
+    lastButtons = sample.keypad_data.buttonStatus;
+    lastOkFlags = okFlags;
+
+    sample.joystick_data.leftXAxis.data = value[0];
+    sample.joystick_data.leftYAxis.data = value[1];
+    sample.joystick_data.leftZAxis.data = value[2];
+    sample.joystick_data.rightXAxis.data = value[3];
+    sample.joystick_data.rightYAxis.data = value[4];
+    sample.joystick_data.rightZAxis.data = value[5];
+    return true;
+}
+
+JoystickFilter::Stats JoystickFilter::stats() const {
+    Stats result{samples.load(std::memory_order_relaxed), forwarded.load(std::memory_order_relaxed),
+                 keypadChanges.load(std::memory_order_relaxed), {}};
+    for (size_t i = 0; i < axisCount; i++) {
+        result.axisSuppressed[i] = axisSuppressed[i].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+double JoystickFilter::suppressionRatio() const {
+    const uint64_t total = samples.load(std::memory_order_relaxed);
+    return total == 0 ? 0.0 : 1.0 - static_cast<double>(forwarded.load(std::memory_order_relaxed)) / total;
+}
@@ -0,0 +1,25 @@
+#include <fort_agent/jaus/TickSchedule.h>
+
+void TickSchedule::setRate(double hz) {
+    interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / hz));
+}
+
+void TickSchedule::start(Clock::time_point now) {
+    next = now + interval;
+}
+
+void TickSchedule::complete(Clock::time_point done) {
+    tickCount.fetch_add(1, std::memory_order_relaxed);
+
+    // Ticks missed while this one or the input before it ran are skipped, not run back to back
+    next += interval;
+    if (done >= next) {
+        const auto missed = (done - next) / interval + 1;
+        overrunCount.fetch_add(missed, std::memory_order_relaxed);
+        next += missed * interval;
+    }
+}
+
+TickSchedule::Stats TickSchedule::stats() const {
+    return {tickCount.load(std::memory_order_relaxed), overrunCount.load(std::memory_order_relaxed)};
+}
@@ -0,0 +1,65 @@
+#include <fort_agent/jaus/VehicleDirectory.h>
+
+#include <algorithm>
+#include <tuple>
+
+VehicleDirectory::VehicleDirectory() :
+    current(std::make_shared<const Snapshot>(Snapshot{{}, 0})) {
+}
+
+bool VehicleDirectory::update(std::vector<Vehicle> found, Clock::time_point now) {
+    refreshCount.fetch_add(1, std::memory_order_relaxed);
+    refreshedAt.store(std::max<Clock::rep>(now.time_since_epoch().count(), 1), std::memory_order_release);
+
+    rank(found);
+    const auto previous = std::atomic_load_explicit(&current, std::memory_order_acquire);
+    const bool same = std::equal(found.begin(), found.end(), previous->vehicles.begin(), previous->vehicles.end(),
+                                 [](const Vehicle& a, const Vehicle& b) {
+                                     return a.id == b.id && a.name == b.name;
+                                 });
+    if (same) {
+        return false;
+    }
+
+    auto next = std::make_shared<const Snapshot>(Snapshot{std::move(found), previous->generation + 1});
+    std::atomic_store_explicit(&current, std::move(next), std::memory_order_release);
+    changeCount.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+std::shared_ptr<const VehicleDirectory::Snapshot> VehicleDirectory::snapshot() const {
+    readCount.fetch_add(1, std::memory_order_relaxed);
+    return std::atomic_load_explicit(&current, std::memory_order_acquire);
+}
+
+void VehicleDirectory::prefer(uint32_t id) {
+    preferred.store(id, std::memory_order_relaxed);
+}
+
+VehicleDirectory::Clock::duration VehicleDirectory::age(Clock::time_point now) const {
+    const Clock::rep last = refreshedAt.load(std::memory_order_acquire);
+    if (last == 0) {
+        return Clock::duration::max();
+    }
+    return now - Clock::time_point(Clock::duration(last));
+}
+
+std::string VehicleDirectory::knownName(uint32_t id) const {
+    const auto list = std::atomic_load_explicit(&current, std::memory_order_acquire);
+    const auto found = std::find_if(list->vehicles.begin(), list->vehicles.end(),
+                                    [id](const Vehicle& vehicle) { return vehicle.id == id; });
+    return found != list->vehicles.end() ? found->name : std::string();
+}
+
+VehicleDirectory::Stats VehicleDirectory::stats() const {
+    return {refreshCount.load(std::memory_order_relaxed), changeCount.load(std::memory_order_relaxed),
+            readCount.load(std::memory_order_relaxed)};
+}
+
+void VehicleDirectory::rank(std::vector<Vehicle>& vehicles) const {
+    const uint32_t first = preferred.load(std::memory_order_relaxed);
+    std::sort(vehicles.begin(), vehicles.end(), [first](const Vehicle& a, const Vehicle& b) {
+        return std::make_tuple(a.id != first, a.name.empty(), a.id) <
+               std::make_tuple(b.id != first, b.name.empty(), b.id);
+    });
+}
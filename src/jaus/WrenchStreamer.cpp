@@ -0,0 +1,84 @@
+#include <fort_agent/jaus/WrenchStreamer.h>
+
+#include <algorithm>
+
+std::atomic<WrenchStreamer::Clock::rep> WrenchStreamer::periodTicks{
+    std::chrono::duration_cast<WrenchStreamer::Clock::duration>(std::chrono::milliseconds(40)).count()};
+std::atomic<WrenchStreamer::Clock::rep> WrenchStreamer::maxHoldTicks{
+    std::chrono::duration_cast<WrenchStreamer::Clock::duration>(std::chrono::milliseconds(500)).count()};
+std::atomic<WrenchStreamer::Clock::rep> WrenchStreamer::confirmedAt{0};
+std::atomic<uint64_t> WrenchStreamer::sampleCount{0};
+std::atomic<uint64_t> WrenchStreamer::sentCount{0};
+std::atomic<uint64_t> WrenchStreamer::heldCount{0};
+std::atomic<uint64_t> WrenchStreamer::supersededCount{0};
+std::atomic<uint64_t> WrenchStreamer::expiredCount{0};
+
+void WrenchStreamer::setRate(double hz) {
+    const auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / hz));
+    periodTicks.store(interval.count(), std::memory_order_relaxed);
+}
+
+WrenchStreamer::Clock::duration WrenchStreamer::period() {
+    return Clock::duration(periodTicks.load(std::memory_order_relaxed));
+}
+
+void WrenchStreamer::setMaxHold(Clock::duration limit) {
+    maxHoldTicks.store(limit.count(), std::memory_order_relaxed);
+}
+
+void WrenchStreamer::confirm(Clock::time_point now) {
+    confirmedAt.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+}
+
+WrenchStreamer::Stats WrenchStreamer::stats() {
+    return {sampleCount.load(std::memory_order_relaxed), sentCount.load(std::memory_order_relaxed),
+            heldCount.load(std::memory_order_relaxed), supersededCount.load(std::memory_order_relaxed),
+            expiredCount.load(std::memory_order_relaxed)};
+}
+
+void WrenchStreamer::update(const frc_joystick_data_t& sample, Clock::time_point now) {
+    sampleCount.fetch_add(1, std::memory_order_relaxed);
+    if (fresh) {
+        supersededCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    latest = sample;
+    haveSample = true;
+    fresh = true;
+    zeroed = false;
+    sampleAt = now;
+}
+
+void WrenchStreamer::poll(Clock::time_point now) {
+    const Clock::duration interval = period();
+    // Polls come from a tick that may run a little ahead of this grid; a quarter period of slack
+    // keeps one from being missed, which would halve the rate
+    if (!haveSample || now + interval / 4 < nextSend) {
+        return;
+    }
+    if (nextSend == Clock::time_point{}) {
+        nextSend = now;
+    }
+
+    // Never keep commanding a deflection nobody is confirming any more
+    const Clock::time_point confirmed(Clock::duration(confirmedAt.load(std::memory_order_relaxed)));
+    const Clock::duration maxHold(maxHoldTicks.load(std::memory_order_relaxed));
+    if (!zeroed && now - std::max(sampleAt, confirmed) > maxHold) {
+        latest = frc_joystick_data_t{};
+        zeroed = true;
+        fresh = true;
+        expiredCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    client.sendWrenchEffort(latest);
+    sentCount.fetch_add(1, std::memory_order_relaxed);
+    if (!fresh) {
+        heldCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    fresh = false;
+
+    // Stay on the period grid, but never send twice to make up for a late poll
+    nextSend += interval;
+    if (nextSend <= now) {
+        nextSend = now + interval - (now - nextSend) % interval;
+    }
+}
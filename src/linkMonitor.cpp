@@ -0,0 +1,107 @@
+#include <fort_agent/linkMonitor.h>
+
+#include <random>
+
+#include <spdlog/spdlog.h>
+
+#include <fort_agent/coapHelpers.h>
+
+LinkMonitor::LinkMonitor(boost::asio::io_service &service, TimedStrand &strand, SendFn send,
+                         Settings settings, EventFn onEvent) :
+    strand(strand),
+    timer(service),
+    send(std::move(send)),
+    settings(settings),
+    onEvent(std::move(onEvent)),
+    pingOutstanding(false),
+    pingMid(static_cast<uint16_t>(std::random_device()())),
+    pingSent(),
+    lastRx(Clock::now().time_since_epoch().count()),
+    rttUs() {
+}
+
+void LinkMonitor::start() {
+    if (settings.pingInterval.count() > 0) {
+        lastRx.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+        schedule();
+    }
+}
+
+void LinkMonitor::schedule() {
+    timer.expires_after(settings.pingInterval);
+    timer.async_wait(strand.wrap([this](const boost::system::error_code &ec) {
+        if (ec == boost::asio::error::operation_aborted) {
+            return;
+        }
+        poll();
+        schedule();
+    }));
+}
+
+bool LinkMonitor::onFrame(const uint8_t *frame, size_t length, Clock::time_point now) {
+    FXN_TRACE;
+    const Clock::time_point previousRx{Clock::duration(lastRx.exchange(now.time_since_epoch().count(),
+                                                                       std::memory_order_relaxed))};
+    if (silent.exchange(false, std::memory_order_relaxed)) {
+        const auto outage = std::chrono::duration_cast<std::chrono::milliseconds>(now - previousRx);
+        spdlog::info("Serial link RX resumed after {} ms of silence", outage.count());
+        if (onEvent) {
+            onEvent(Event::RECOVERED, outage);
+        }
+    }
+
+    if (!pingOutstanding || length != Coap::COAP_MIN_LEN || !Coap::looksLikeCoap(frame, length) ||
+        Coap::getCoapType(frame) != Coap::Type::RST || Coap::getMid(frame) != pingMid) {
+        return false;
+    }
+
+    pingOutstanding = false;
+    pongs.fetch_add(1, std::memory_order_relaxed);
+    rttUs.record(std::chrono::duration_cast<std::chrono::microseconds>(now - pingSent).count());
+    return true;
+}
+
+void LinkMonitor::poll(Clock::time_point now) {
+    FXN_TRACE;
+    if (pingOutstanding && now - pingSent >= settings.pingTimeout) {
+        pingOutstanding = false;
+        lost.fetch_add(1, std::memory_order_relaxed);
+        spdlog::debug("Serial link ping MID {} lost", pingMid);
+    }
+
+    const Clock::time_point previousRx{Clock::duration(lastRx.load(std::memory_order_relaxed))};
+    const auto quiet = std::chrono::duration_cast<std::chrono::milliseconds>(now - previousRx);
+    if (quiet >= settings.silenceThreshold && !silent.exchange(true, std::memory_order_relaxed)) {
+        silenceEvents.fetch_add(1, std::memory_order_relaxed);
+        spdlog::warn("Serial link silent: nothing received for {} ms", quiet.count());
+        if (onEvent) {
+            onEvent(Event::SILENT, quiet);
+        }
+    }
+
+    if (!pingOutstanding) {
+        // An empty CON: version 1, type CON, no token, code 0.00
+        pingMid++;
+        const uint8_t ping[Coap::COAP_MIN_LEN] = {0x40, 0x00, static_cast<uint8_t>(pingMid >> 8),
+                                                  static_cast<uint8_t>(pingMid & 0xFF)};
+        if (send(ping, sizeof(ping))) {
+            pingOutstanding = true;
+            pingSent = now;
+            pingsSent.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+double LinkMonitor::lossRate() const {
+    const uint64_t sent = pingsSent.load(std::memory_order_relaxed);
+    return sent == 0 ? 0.0 : static_cast<double>(lost.load(std::memory_order_relaxed)) / sent;
+}
+
+LinkMonitor::Stats LinkMonitor::stats() const {
+    const Clock::time_point previousRx{Clock::duration(lastRx.load(std::memory_order_relaxed))};
+    return {pingsSent.load(std::memory_order_relaxed), pongs.load(std::memory_order_relaxed),
+            lost.load(std::memory_order_relaxed), silenceEvents.load(std::memory_order_relaxed),
+            silent.load(std::memory_order_relaxed),
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                Clock::now() - previousRx).count())};
+}
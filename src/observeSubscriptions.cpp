@@ -0,0 +1,132 @@
+#include <fort_agent/observeSubscriptions.h>
+
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+namespace {
+    constexpr auto idlePoll = std::chrono::seconds(1);
+}
+
+ObserveSubscriptions::ObserveSubscriptions(uint16_t firstMid, Settings settings) :
+    settings(settings),
+    mutex(),
+    subscriptions(),
+    nextMid(firstMid),
+    started(false) {
+}
+
+void ObserveSubscriptions::add(uint16_t id, std::string name, RegisterFn subscribe,
+                               std::chrono::milliseconds freshFor) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Subscription sub{std::move(name), std::move(subscribe), freshFor, {}, {}, settings.initialBackoff,
+                     0, false, 0, 0, 0};
+    auto &added = subscriptions[id] = std::move(sub);
+    if (started) {
+        registerNow(added, Clock::now());
+    }
+}
+
+void ObserveSubscriptions::start(Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex);
+    started = true;
+    for (auto &entry : subscriptions) {
+        entry.second.lastNotification = now;
+        registerNow(entry.second, now);
+    }
+}
+
+void ObserveSubscriptions::onNotification(uint16_t id, const Coap::MessageView &msg, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = subscriptions.find(id);
+    if (it == subscriptions.end()) {
+        return;
+    }
+    Subscription &sub = it->second;
+
+    if ((msg.code >> 5) != 2 || !msg.hasObserve) {
+        if (msg.type == Coap::Type::ACK && msg.mid != sub.mid) {
+            return;  // the answer to some other request for the resource, e.g. a deregistration
+        }
+        // the device is not (or no longer) observing for us, try again right away
+        spdlog::warn("Observe {}: notification {}.{:02d} ends the subscription, re-registering", sub.name,
+                     msg.code >> 5, msg.code & 0x1F);
+        sub.deadline = now;
+        return;
+    }
+
+    sub.notifications++;
+    sub.lastNotification = now;
+    sub.backoff = settings.initialBackoff;
+    sub.deadline = now + (sub.freshFor.count() > 0 ? sub.freshFor
+                                                   : std::chrono::milliseconds(std::chrono::seconds(msg.maxAge)));
+    if (sub.stale) {
+        sub.stale = false;
+        spdlog::info("Observe {}: notifications resumed", sub.name);
+    }
+}
+
+void ObserveSubscriptions::resubscribeAll(Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!started) {
+        return;
+    }
+    spdlog::info("Re-registering {} Observe subscription(s)", subscriptions.size());
+    for (auto &entry : subscriptions) {
+        entry.second.backoff = settings.initialBackoff;
+        registerNow(entry.second, now);
+    }
+}
+
+ObserveSubscriptions::Clock::time_point ObserveSubscriptions::poll(Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!started || subscriptions.empty()) {
+        return now + idlePoll;
+    }
+
+    Clock::time_point next = Clock::time_point::max();
+
+    for (auto &entry : subscriptions) {
+        Subscription &sub = entry.second;
+        if (now >= sub.deadline) {
+            if (!sub.stale) {
+                sub.stale = true;
+                sub.staleEvents++;
+                spdlog::warn("Observe {}: no notification for {} ms, re-registering", sub.name,
+                             std::chrono::duration_cast<std::chrono::milliseconds>(now - sub.lastNotification).count());
+            }
+            registerNow(sub, now);
+            sub.backoff = std::min(sub.backoff * 2, settings.maxBackoff);
+        }
+        next = std::min(next, sub.deadline);
+    }
+    return next;
+}
+
+void ObserveSubscriptions::registerNow(Subscription &sub, Clock::time_point now) {
+    sub.mid = nextMid++;
+    sub.subscribe(sub.mid);
+    sub.registrations++;
+    // The registration's own response is a notification; if that doesn't arrive, retry after backoff
+    sub.deadline = now + sub.backoff;
+}
+
+std::vector<ObserveSubscriptions::Stats> ObserveSubscriptions::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    const Clock::time_point now = Clock::now();
+    std::vector<Stats> result;
+    for (const auto &entry : subscriptions) {
+        const Subscription &sub = entry.second;
+        result.push_back({sub.name, sub.stale, sub.notifications, sub.registrations, sub.staleEvents,
+                          std::chrono::duration_cast<std::chrono::milliseconds>(now - sub.lastNotification)});
+    }
+    return result;
+}
+
+void ObserveSubscriptions::reportStats() const {
+    for (const Stats &sub : stats()) {
+        spdlog::info("Observe {:<11}: {} notifications, {} registrations, {} stale events, last {} ms ago{}",
+                     sub.name, sub.notifications, sub.registrations, sub.staleEvents,
+                     sub.sinceLastNotification.count(), sub.stale ? " (STALE)" : "");
+    }
+}
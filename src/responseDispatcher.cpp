@@ -0,0 +1,69 @@
+#include <fort_agent/responseDispatcher.h>
+
+#include <chrono>
+#include <stdexcept>
+
+#include <spdlog/spdlog.h>
+
+ResponseDispatcher::ResponseDispatcher(uint16_t firstId) :
+    first(firstId),
+    registerMutex(),
+    entries() {
+    for (auto &slot : table) {
+        slot.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+void ResponseDispatcher::registerHandler(uint16_t id, std::string name, Handler handler) {
+    if (!owns(id)) {
+        throw std::invalid_argument(fmt::format("Response id {} ({}) is outside the dispatch table [{}, {})",
+                                                id, name, first, first + capacity));
+    }
+
+    std::lock_guard<std::mutex> lock(registerMutex);
+    std::atomic<Entry *> &slot = table[id - first];
+    if (slot.load(std::memory_order_relaxed) != nullptr) {
+        throw std::invalid_argument(fmt::format("Response id {} already has handler {}",
+                                                id, slot.load(std::memory_order_relaxed)->name));
+    }
+
+    auto entry = std::make_unique<Entry>();
+    entry->id = id;
+    entry->name = std::move(name);
+    entry->handler = std::move(handler);
+    slot.store(entry.get(), std::memory_order_release);
+    entries.push_back(std::move(entry));
+}
+
+void ResponseDispatcher::dispatch(uint16_t id, const uint8_t *message, size_t len) {
+    FXN_TRACE;
+    Entry *entry = owns(id) ? table[id - first].load(std::memory_order_acquire) : nullptr;
+    if (entry == nullptr) {
+        unhandled.fetch_add(1, std::memory_order_relaxed);
+        spdlog::debug("No handler for response id {}, dropping it", id);
+        return;
+    }
+
+    const Coap::MessageView view = Coap::parseMessage(message, len);
+
+    const auto start = std::chrono::steady_clock::now();
+    entry->handler(view);
+    entry->processingUs.record(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    entry->calls.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t ResponseDispatcher::callCount(uint16_t id) const {
+    const Entry *entry = owns(id) ? table[id - first].load(std::memory_order_acquire) : nullptr;
+    return entry == nullptr ? 0 : entry->calls.load(std::memory_order_relaxed);
+}
+
+void ResponseDispatcher::reportStats() const {
+    for (const auto &slot : table) {
+        const Entry *entry = slot.load(std::memory_order_acquire);
+        if (entry != nullptr && entry->calls.load(std::memory_order_relaxed) > 0) {
+            spdlog::info("Response {:<19}: processing us {}", entry->name, entry->processingUs.summary());
+        }
+    }
+    spdlog::info("Responses unhandled : {}", unhandledCount());
+}
@@ -8,15 +8,24 @@ uint8_t FAUX_write_byte(uint8_t byte) {
 SerialHandler::SerialHandler(boost::asio::io_service &ioService,
                              const std::string &serialPath,
                              errorCb onFailure,
-                             dataCb onDataCb) :
+                             dataCb onDataCb,
+                             readDoneCb onReadDoneCb,
+                             writeReadyCb onWriteReadyCb,
+                             size_t mtu) :
     service(ioService),
     serial(ioService),
-    readTempBuffer(),
-    readBuffer(RX_BUFFER_SIZE),
-    writeBuffer(TX_BUFFER_SIZE),
+    serialStrand(ioService, "serial"),
+    frameSize(mtu),
+    readTempBuffer(mtu),
+    readBuffer(mtu),
+    writeBuffer(txFramesBuffered * FortAgentSlip::slipEncodedMaxSize(mtu)),
     writeInProgress(false),
     onFailure(onFailure),
-    onData(onDataCb) {
+    onData(onDataCb),
+    onReadDone(onReadDoneCb),
+    onWriteReady(onWriteReadyCb),
+    slip_buffer(mtu),
+    encodeBuffer(FortAgentSlip::slipEncodedMaxSize(mtu)) {
     FXN_TRACE;
     try {
         state = State::RESETTING;
@@ -27,8 +36,8 @@ SerialHandler::SerialHandler(boost::asio::io_service &ioService,
             boost::asio::serial_port_base::flow_control(flowControl));
 
 
-        slip_desc.buf = slip_buffer;
-        slip_desc.buf_size = FORT_AGENT_BUFFER_UNIT_SZ;
+        slip_desc.buf = slip_buffer.data();
+        slip_desc.buf_size = static_cast<uint32_t>(frameSize);
         slip_desc.recv_message = onData;
         slip_desc.write_byte = FAUX_write_byte;
 
@@ -58,35 +67,40 @@ bool SerialHandler::asyncSendMessageToSerialPort(const void *dataBytes,
         return false;
     }
 
-    // don't bother trying to send if there's not enough free space in the buffer for the whole command
-    if (writeBuffer.reserve() < dataLen) {
+    // Splitting would leave the SRC Pro with pieces that are not CoAP messages, so refuse instead
+    if (dataLen > frameSize) {
+        spdlog::error("Can't send data message: {} bytes exceed the {} byte serial frame", dataLen, frameSize);
+        return false;
+    }
+
+    const uint32_t cmdLen = FortAgentSlip::createSlipEncodedMessage(
+        encodeBuffer.data(),
+        reinterpret_cast<const uint8_t *const>(dataBytes),
+        static_cast<uint32_t>(dataLen),
+        static_cast<uint32_t>(frameSize));
+    if (cmdLen == 0) {
         spdlog::error(
-            "Can't send data message: not enough free write buffer space");
+            "Can't send data message: creating data command failed");
         return false;
     }
 
-    // larger messages will need to be split across multiple data commands
-    while (dataLen > 0) {
-        const auto toSend = std::min((size_t) FORT_AGENT_BUFFER_UNIT_SZ,
-                                     dataLen);
-        uint8_t cmd[FORT_AGENT_BUFFER_UNIT_SZ];
-        const uint32_t cmdLen = FortAgentSlip::createSlipEncodedMessage(
-            reinterpret_cast<uint8_t *>(&cmd),
-            reinterpret_cast<const uint8_t *const>(dataBytes),
-            static_cast<uint32_t>(toSend));
-        if (cmdLen == 0) {
-            spdlog::error(
-                "Can't send data message: creating data command failed");
-            return false;
-        } else {
-            asyncSendDataToSerialPort(&cmd, cmdLen);
-            dataLen -= toSend;
-        }
+    // don't bother trying to send if there's not enough free space in the buffer for the whole command
+    if (writeBuffer.reserve() < cmdLen) {
+        spdlog::error(
+            "Can't send data message: not enough free write buffer space");
+        return false;
     }
 
+    asyncSendDataToSerialPort(encodeBuffer.data(), cmdLen);
     return true;
 }
 
+bool SerialHandler::canSend(size_t dataLen) const {
+    // SLIP escaping at most doubles the message, plus the END bytes either side
+    return state == State::OPERATIONAL &&
+           (writeBuffer.empty() || writeBuffer.reserve() >= 2 * dataLen + 2);
+}
+
 size_t
 SerialHandler::asyncSendDataToSerialPort(const void *sendData, size_t len) {
     FXN_TRACE;
@@ -108,9 +122,9 @@ SerialHandler::asyncSendDataToSerialPort(const void *sendData, size_t len) {
         const auto &range = writeBuffer.array_one();
         auto toWrite = boost::asio::buffer(range.first, range.second);
 
-        serial.async_write_some(toWrite, std::bind(
+        serial.async_write_some(toWrite, serialStrand.wrap(std::bind(
             &SerialHandler::asyncWriteToSerialPortCb, this,
-            std::placeholders::_1, std::placeholders::_2));
+            std::placeholders::_1, std::placeholders::_2)));
     }
 
     return written;
@@ -132,9 +146,13 @@ SerialHandler::asyncWriteToSerialPortCb(const boost::system::error_code &ec,
         } else {  // kick off another async write for the remaining data
             const auto &range = writeBuffer.array_one();
             auto toWrite = boost::asio::buffer(range.first, range.second);
-            serial.async_write_some(toWrite, std::bind(
+            serial.async_write_some(toWrite, serialStrand.wrap(std::bind(
                 &SerialHandler::asyncWriteToSerialPortCb, this,
-                std::placeholders::_1, std::placeholders::_2));
+                std::placeholders::_1, std::placeholders::_2)));
+        }
+
+        if (onWriteReady) {
+            onWriteReady();
         }
     }
 }
@@ -152,7 +170,7 @@ void SerialHandler::listenToSerialPort() {
     FXN_TRACE;
     serial.async_read_some(
         boost::asio::buffer(readTempBuffer.data(), readTempBuffer.size()),
-        [this](const boost::system::error_code &ec, size_t bytes_transferred) {
+        serialStrand.wrap([this](const boost::system::error_code &ec, size_t bytes_transferred) {
             if (ec) {
                 if (ec == boost::asio::error::operation_aborted) {
                     spdlog::error("Operational mode serial listener cancelled");
@@ -179,12 +197,16 @@ void SerialHandler::listenToSerialPort() {
                     readBuffer.pop_front();
                 }
 
+                if (onReadDone) {
+                    onReadDone();
+                }
+
                 // continue listening so long as the state is OPERATIONAL
                 if (state == State::OPERATIONAL) {
                     listenToSerialPort();
                 }
             }
-        }
+        })
     );
 }
 
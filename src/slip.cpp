@@ -7,16 +7,16 @@ namespace FortAgentSlip {
 
     uint32_t
     createSlipEncodedMessage(uint8_t *dataToBeSent, const uint8_t *const data,
-                             uint32_t length) {
-        uint16_t slipDataLength = 0;
+                             uint32_t length, uint32_t mtu) {
+        uint32_t slipDataLength = 0;
 
-        // We are supporting MAX_PDU_FRAME_LEN frame size only
-        if (length > FORT_AGENT_BUFFER_UNIT_SZ) {
+        // We are supporting MTU frame size only
+        if (length > mtu) {
             return 0;
         }
 
         dataToBeSent[slipDataLength++] = SLIP_SPECIAL_BYTE_END;
-        for (int i = 0; i < length; i++) {
+        for (uint32_t i = 0; i < length; i++) {
             if (data[i] == SLIP_SPECIAL_BYTE_END) {
                 dataToBeSent[slipDataLength++] = SLIP_SPECIAL_BYTE_ESC;
                 dataToBeSent[slipDataLength++] = SLIP_ESCAPED_BYTE_END;
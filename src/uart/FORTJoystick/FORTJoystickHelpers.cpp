@@ -1,5 +1,5 @@
-#include <iostream>
 #include <iomanip>
+#include <sstream>
 #include <cstdint>
 
 #include <cbor.h>
@@ -13,7 +13,7 @@ using namespace coapSRCPro;
 
 void printJoystickStatus(const frc_combined_data_t& js) {
     static frc_combined_data_t lastJs = {};
-    if (spdlog::get_level() != spdlog::level::info) {
+    if (spdlog::get_level() != spdlog::level::info || !printToConsole.enabled()) {
         return;
     }
 
@@ -27,8 +27,8 @@ void printJoystickStatus(const frc_combined_data_t& js) {
     }
     lastJs = js;
     
-    printToConsole.flushString("\033[2J\033[3J\033[H\n");
     std::ostringstream frame;
+    frame << "\033[2J\033[3J\033[H\n";
 
     auto decode = [](jsCal_t val) -> std::string {
         int16_t value = static_cast<int16_t>(val.data);
@@ -78,8 +78,8 @@ void printJoystickStatus(const frc_combined_data_t& js) {
         << "                          \n";
     frame << "------------------\n";
 
-    // Final flush
-    printToConsole.flushString(frame.str());
+    // Clears the screen, so only the latest frame is worth printing
+    printToConsole.show(frame.str());
 }
 
 uint16_t compute_crc16(const uint8_t* data, size_t size) {
@@ -152,7 +152,7 @@ BatteryStatus decode_battery_payload(const uint8_t* payload, size_t size) {
 
 bool decode_combined_payload(const uint8_t* data, size_t size) {
     if (size < sizeof(frc_combined_data_t)) {
-        std::cerr << "Combined payload too small\n";
+        spdlog::warn("Combined payload too small, {} bytes", size);
         return false;
     }
 
@@ -162,12 +162,12 @@ bool decode_combined_payload(const uint8_t* data, size_t size) {
     // Compute and verify CRCs
     uint16_t expected_joystick_crc = compute_crc16((const uint8_t*)&payload.joystick_data, sizeof(frc_joystick_data_t) - 2);
     if (expected_joystick_crc != payload.joystick_data.crc16) {
-        std::cerr << "Combined Joystick CRC mismatch\n";
+        spdlog::warn("Combined Joystick CRC mismatch");
         return false;
     }
     uint16_t expected_keypad_crc = compute_crc16((const uint8_t*)&payload.keypad_data.buttonStatus, sizeof(uint16_t));
     if (expected_keypad_crc != payload.keypad_data.crc16) {
-        std::cerr << "Combined Keypad CRC mismatch\n";
+        spdlog::warn("Combined Keypad CRC mismatch");
         return false;
     }
 
@@ -175,23 +175,32 @@ bool decode_combined_payload(const uint8_t* data, size_t size) {
     return true;
 }
 
+JoystickDisplay& joystickDisplay() {
+    // Long enough to merge the text of states passed through in one input batch or tick
+    static constexpr std::chrono::milliseconds coalesceWindow{40};
+    static JoystickDisplay display(JoystickDisplay::Sink{
+        [](uint8_t mode) { coapSRCPro::postDisplayMode(JS_MID, mode); },
+        [](uint8_t line, uint8_t segment, const std::string& text) {
+            coapSRCPro::postDisplayTextSegment(JS_MID, line, segment, text);
+        },
+        [](const std::string& line0, const std::string& line1, bool upperHalf) {
+            coapSRCPro::postDisplayTextRawLines(JS_MID, line0, line1, upperHalf);
+        }}, coalesceWindow);
+    return display;
+}
+
 void displayTextOnJoystick(const std::string& text, const std::string& subtext) {
-   std::cout << "UartCoapBridge::postUserDisplayTest: text='" << text << "', subtext='" << subtext << "'" << std::endl;
-   // Implementation to send display text to joystick
-    // This is a placeholder; actual implementation depends on communication protocol
-    std::cout << "Displaying on Joystick:\n";
-    std::cout << "Text: " << text << "\n";
-    std::cout << "Subtext: " << subtext << "\n";
+    spdlog::debug("Displaying on Joystick: '{}' / '{}'", text, subtext);
 
-    coapSRCPro::postDisplayMode(JS_MID, 1); // Switch to display text mode
-    coapSRCPro::postDisplayTextRawLines(JS_MID, text, subtext, true);
+    joystickDisplay().setMode(1); // Switch to display text mode
+    joystickDisplay().setText(true, text, subtext);
 }
 
 void vibrateJoystick(bool leftMotor, bool rightMotor) {
     // Implementation to send vibration command to joystick
     // This is a placeholder; actual implementation depends on communication protocol
-    std::cout << "Vibrating Joystick - Left Motor: " << (leftMotor ? "ON" : "OFF")
-              << ", Right Motor: " << (rightMotor ? "ON" : "OFF") << "\n";
+    spdlog::debug("Vibrating Joystick - Left Motor: {}, Right Motor: {}", leftMotor ? "ON" : "OFF",
+                  rightMotor ? "ON" : "OFF");
 
     if (leftMotor && rightMotor) {
         coapSRCPro::postVibrateBoth(JS_MID);
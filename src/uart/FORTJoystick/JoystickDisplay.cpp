@@ -0,0 +1,149 @@
+#include <fort_agent/uart/FORTJoystick/JoystickDisplay.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+    // Bytes on the serial link per display request: the CoAP header, token, URI and format, plus
+    // the CBOR payload of a segment {"display_text": [line, segment, "xxxxxx"]} or of a half,
+    // a 37 byte string with both lines and the half selector
+    constexpr size_t requestOverhead = 20;
+    constexpr size_t segmentPayload = 24;
+    constexpr size_t halfPayload = 39;
+
+    std::string padded(const std::string& text, size_t width) {
+        std::string out = text.substr(0, width);
+        out.resize(width, ' ');
+        return out;
+    }
+}
+
+JoystickDisplay::JoystickDisplay(Sink sink, Clock::duration window) :
+    sink(std::move(sink)),
+    window(window) {
+    for (auto& line : wanted) {
+        line.fill(' ');
+    }
+    shown = wanted;
+}
+
+void JoystickDisplay::setMode(uint8_t mode, Clock::time_point now) {
+    if (wantedMode == mode) {
+        modeSkippedCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    wantedMode = mode;
+    markPending(now);
+}
+
+void JoystickDisplay::setText(bool upperHalf, const std::string& line0, const std::string& line1,
+                              Clock::time_point now) {
+    requestCount.fetch_add(1, std::memory_order_relaxed);
+    const size_t first = upperHalf ? 0 : 2;
+    Line next0;
+    Line next1;
+    const std::string text0 = padded(line0, lineWidth);
+    const std::string text1 = padded(line1, lineWidth);
+    std::copy(text0.begin(), text0.end(), next0.begin());
+    std::copy(text1.begin(), text1.end(), next1.begin());
+
+    if (wanted[first] == next0 && wanted[first + 1] == next1) {
+        unchangedCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    wanted[first] = next0;
+    wanted[first + 1] = next1;
+    markPending(now);
+}
+
+JoystickDisplay::Clock::time_point JoystickDisplay::deadline() const {
+    // Due at once, but a time the caller can still subtract now from
+    if (invalidated.load(std::memory_order_relaxed)) {
+        return Clock::time_point{};
+    }
+    return pendingSince == Clock::time_point::max() ? pendingSince : pendingSince + window;
+}
+
+bool JoystickDisplay::flush(Clock::time_point now) {
+    if (invalidated.exchange(false, std::memory_order_acq_rel)) {
+        shownKnown = false;
+        shownMode = -1;
+        pendingSince = std::min(pendingSince, now - window);
+    }
+    if (pendingSince == Clock::time_point::max() || now < pendingSince + window) {
+        return false;
+    }
+    pendingSince = Clock::time_point::max();
+
+    bool sent = false;
+    if (wantedMode >= 0 && wantedMode != shownMode) {
+        sink.mode(static_cast<uint8_t>(wantedMode));
+        shownMode = wantedMode;
+        modeWrites.fetch_add(1, std::memory_order_relaxed);
+        sent = true;
+    }
+    for (size_t first = 0; first < lineCount; first += 2) {
+        if (!shownKnown || wanted[first] != shown[first] || wanted[first + 1] != shown[first + 1]) {
+            flushHalf(first);
+            sent = true;
+        }
+    }
+    shownKnown = true;
+    return sent;
+}
+
+void JoystickDisplay::invalidate() {
+    invalidated.store(true, std::memory_order_release);
+}
+
+JoystickDisplay::Stats JoystickDisplay::stats() const {
+    return {requestCount.load(std::memory_order_relaxed), unchangedCount.load(std::memory_order_relaxed),
+            coalescedCount.load(std::memory_order_relaxed), segmentWrites.load(std::memory_order_relaxed),
+            halfWrites.load(std::memory_order_relaxed), modeWrites.load(std::memory_order_relaxed),
+            modeSkippedCount.load(std::memory_order_relaxed)};
+}
+
+void JoystickDisplay::markPending(Clock::time_point now) {
+    if (pendingSince != Clock::time_point::max()) {
+        coalescedCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    pendingSince = now;
+}
+
+void JoystickDisplay::flushHalf(size_t first) {
+    auto segmentText = [this](size_t line, size_t segment) {
+        return std::string(wanted[line].begin() + segment * segmentWidth,
+                           wanted[line].begin() + (segment + 1) * segmentWidth);
+    };
+    auto segmentChanged = [&](size_t line, size_t segment) {
+        return !shownKnown || !std::equal(wanted[line].begin() + segment * segmentWidth,
+                                          wanted[line].begin() + (segment + 1) * segmentWidth,
+                                          shown[line].begin() + segment * segmentWidth);
+    };
+
+    size_t changed = 0;
+    for (size_t line = first; line < first + 2; line++) {
+        for (size_t segment = 0; segment < segmentCount; segment++) {
+            changed += segmentChanged(line, segment) ? 1 : 0;
+        }
+    }
+
+    if (changed * (requestOverhead + segmentPayload) >= requestOverhead + halfPayload) {
+        sink.half(std::string(wanted[first].begin(), wanted[first].end()),
+                  std::string(wanted[first + 1].begin(), wanted[first + 1].end()), first == 0);
+        halfWrites.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        for (size_t line = first; line < first + 2; line++) {
+            for (size_t segment = 0; segment < segmentCount; segment++) {
+                if (segmentChanged(line, segment)) {
+                    sink.segment(static_cast<uint8_t>(line), static_cast<uint8_t>(segment),
+                                 segmentText(line, segment));
+                    segmentWrites.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+    shown[first] = wanted[first];
+    shown[first + 1] = wanted[first + 1];
+}
@@ -3,6 +3,13 @@
 #include <vector>
 #include <sstream>
 #include <iostream>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
 
 #include <fort_agent/uartCoapBridge.h>
 
@@ -11,17 +18,23 @@
 #include <spdlog/fmt/ostr.h>
 
 #include <fort_agent/coapHelpers.h>
-#include <fort_agent/jaus/JausBridgeSingleton.h>
+#include <fort_agent/jaus/JausBridge.h>
 
 using fmt::format;
 
+namespace {
+    // Max-Age of the 5.03 for a request refused because its client's serial queue is full
+    constexpr uint32_t serialQueueFullRetrySeconds = 1;
+}
+
 UartCoapBridge::UartCoapBridge(
     boost::asio::io_service &service,
     const std::string &localAddr,
     uint16_t localPort,
     const std::string &serialPath,
     const std::string &remoteAddr,
-    uint16_t remotePort) :
+    uint16_t remotePort,
+    const UartCoapBridgeSettings &settings) :
     ioService(service),
     serialHandler(),
     listenPort(localPort),
@@ -29,13 +42,27 @@ UartCoapBridge::UartCoapBridge(
     localEndpoint(localHost, localPort),
     localSocket(service),
     localBindRetryTimer(service),
-    from(),
     remoteHost(boost::asio::ip::address::from_string(remoteAddr)),
+    mtu(settings.mtu),
+    datagramPool(settings.mtu + trackingTokenHeadroom, datagramPoolSize),
+    serialRxBatch(),
+    responseCache(settings.cacheTtls),
+    cacheReply(),
+    requestCollapser(),
+    observeHub(),
+    admission(SerialHandler::linkBytesPerSecond(), settings.clientRate, settings.clientBurst),
+    serialScheduler(),
+    udpStrand(service, "udp"),
+    rxBatchSizes(),
+    txBatchSizes(),
     coapPorts(service, remotePort),
+    responseDispatcher(static_cast<uint16_t>(JausBridge::JausPort::START) + 1),
     failedToBindLocal(spdlog::level::err),
     failedToReceiveFromRemote(spdlog::level::err),
     failedToSendSerial(spdlog::level::warn),
     failedToListenSerial(spdlog::level::warn),
+    failedToForwardSerial(spdlog::level::err),
+    serialQueueFull(spdlog::level::warn),
     failedToSendToRemote() {
     FXN_TRACE;
 
@@ -44,10 +71,32 @@ UartCoapBridge::UartCoapBridge(
         serialPath,
         std::bind(&UartCoapBridge::serialError, this, std::placeholders::_1),
         std::bind(&UartCoapBridge::serialDataReceived, this,
-                  std::placeholders::_1, std::placeholders::_2));
+                  std::placeholders::_1, std::placeholders::_2),
+        std::bind(&UartCoapBridge::serialReadDone, this),
+        std::bind(&UartCoapBridge::serialWriteReady, this),
+        mtu + trackingTokenHeadroom);  // serial frames carry the tracking token on top of the CoAP message
+
+    linkMonitor = std::make_unique<LinkMonitor>(
+        service, serialHandler->strand(),
+        [this](const uint8_t *message, size_t length) {
+            return serialHandler->canSend(length) && serialHandler->asyncSendMessageToSerialPort(message, length);
+        },
+        settings.linkHealth,
+        [this](LinkMonitor::Event event, std::chrono::milliseconds silence) {
+            for (const auto &listener : linkListeners) {
+                listener(event, silence);
+            }
+        });
+    linkMonitor->start();
+
+    StatTrace::addReporter([this]() { reportStats(); });
 
     // bind local socket to local port and begin listening
-    bindLocal();
+    udpStrand.post([this]() { bindLocal(); });
+}
+
+void UartCoapBridge::addLinkListener(LinkMonitor::EventFn listener) {
+    linkListeners.push_back(std::move(listener));
 }
 
 void UartCoapBridge::serialError(const std::string &errMsg) {
@@ -78,43 +127,86 @@ void UartCoapBridge::serialDataReceived(uint8_t *message, uint32_t size) {
         return;
     }
 
-    uint16_t port = 0;
+    // Answers to the link monitor's pings stop here
+    if (linkMonitor && linkMonitor->onFrame(message, size)) {
+        return;
+    }
 
-    try {
-        size_t len = size;
-        std::shared_ptr<uint8_t[]> data(new uint8_t[len + 3]);
-        
-        std::copy_n(message, len, data.get());
-        port = coapPorts.serialToUdp(data.get(), &len);
-
-        // Special handling for JAUS messages - forward to JAUS bridge
-        // The port range 900-1100 is reserved for JAUS messages
-        if (port > (uint16_t) JausBridge::JausPort::START && port < (uint16_t) JausBridge::JausPort::END) {
-            spdlog::debug("JAUS: Tracking response MID {} -> port {}, msg = {}",
-            Coap::getMid(data.get()), port, 
-                UartCoapBridge::dataToHex(data.get(), len));
-
-            // Get the payload from the CoAP message
-            Coap::CoapReply reply = Coap::parseObserveReply(data.get(), len);
-
-            // Forward to JAUS bridge for evaluation
-            auto& jausBridge = JausBridgeSingleton::instance();
-            if (jausBridge.evaluateCoapJausMessage((JausBridge::JausPort) port, reply.payload.data(), reply.payload.size())) {
-                // Message was handled by JAUS bridge, do not forward
-                spdlog::debug("JAUS: CoAP message handled by JAUS bridge, not forwarding");
+    DatagramPtr data = datagramPool.acquire();
+    if (size > data.capacity()) {
+        spdlog::error("Dropping serial frame of {} bytes, exceeds datagram buffer of {} bytes",
+                      size, data.capacity());
+        return;
+    }
+    std::copy_n(message, size, data.data());
+
+    // Routing happens on the tracker strand once the serial read that produced this frame has been
+    // fully decoded, so a burst of frames costs one handoff
+    serialRxBatch.push({}, std::move(data), size);
+    if (serialRxBatch.full()) {
+        handOffSerialBatch();
+    }
+}
+
+void UartCoapBridge::serialReadDone() {
+    FXN_TRACE;
+    handOffSerialBatch();
+}
+
+void UartCoapBridge::serialWriteReady() {
+    FXN_TRACE;
+    FairScheduler::Frame frame;
+    while (serialScheduler.next([this](size_t length) { return serialHandler->canSend(length); }, frame)) {
+        serialHandler->asyncSendMessageToSerialPort(frame.data.data(), frame.length);
+    }
+}
+
+void UartCoapBridge::handOffSerialBatch() {
+    FXN_TRACE;
+    if (serialRxBatch.count == 0) {
+        return;
+    }
+
+    coapPorts.strand().post([this, batch = std::move(serialRxBatch)]() mutable {
+        processSerialBatch(batch);
+    });
+    serialRxBatch.count = 0;
+}
+
+void UartCoapBridge::processSerialBatch(DatagramBatch &batch) {
+    FXN_TRACE;
+    DatagramBatch toRemote;
+
+    for (size_t i = 0; i < batch.count; i++) {
+        PendingDatagram &frame = batch.entries[i];
+        uint16_t port = 0;
+
+        try {
+            size_t len = frame.length;
+            port = coapPorts.serialToUdp(frame.data.data(), &len);
+
+            // Responses to the agent's own requests are consumed locally
+            if (responseDispatcher.owns(port)) {
+                spdlog::debug("Dispatching local response MID {} -> id {}, msg = {}",
+                    Coap::getMid(frame.data.data()), port,
+                    UartCoapBridge::dataToHex(frame.data.data(), len));
+                responseDispatcher.dispatch(port, frame.data.data(), len);
+            } else {
+                // Forward everything else to remote CoAP server
+                toRemote.push(boost::asio::ip::udp::endpoint(remoteHost, port), std::move(frame.data), len);
             }
-        } else {
-            // Forward everything else to remote CoAP server
-            sendToRemote(boost::asio::ip::udp::endpoint(remoteHost, port), data, len);
-            clearFailedToSendToRemote(port);
         }
-    }
-    catch (CoapException &e) {
-        logFailedToSendToRemote(port,
-                                "Failed to forward received Serial data: Coap error: {}",
-                                e.what());
+        catch (CoapException &e) {
+            failedToForwardSerial.log("Failed to forward received Serial data for port {}: Coap error: {}",
+                                      port, e.what());
+        }
     }
 
+    if (toRemote.count > 0) {
+        udpStrand.post([this, toRemote = std::move(toRemote)]() mutable {
+            flushToRemote(toRemote);
+        });
+    }
 }
 
 void UartCoapBridge::bindLocal() {
@@ -142,66 +234,33 @@ void UartCoapBridge::bindLocal() {
         // schedule another attempt
         localBindRetryTimer.expires_from_now(
             boost::posix_time::seconds(localBindRetrySeconds));
-        localBindRetryTimer.async_wait(
+        localBindRetryTimer.async_wait(udpStrand.wrap(
             [this](const boost::system::error_code & /*e*/) {
                 bindLocal();
-            });
+            }));
     }
 }
 
 void UartCoapBridge::receiveFromRemote() {
     FXN_TRACE;
     try {
-        std::shared_ptr<char[]> data(new char[FORT_AGENT_BUFFER_UNIT_SZ + 3]);
-
-        /* Using a single 'from' variable should be OK, because only a single instance of
-         * receive() is ever run at a time, so only once instance of async_receive_from() is ever
-         * active per class.
-         */
-        localSocket.async_receive_from(
-            boost::asio::buffer(data.get(), FORT_AGENT_BUFFER_UNIT_SZ),
-            from,
-            // remoteHost,
-            [this, data](boost::system::error_code ec,
-                         std::size_t bytes_recvd) {
+        // Wait for readability and then drain the socket ourselves, so a burst of requests from
+        // several clients costs one wakeup and one recvmmsg instead of one completion per datagram.
+        localSocket.async_wait(
+            boost::asio::ip::udp::socket::wait_read,
+            udpStrand.wrap([this](boost::system::error_code ec) {
                 if (ec == boost::asio::error::operation_aborted) {
                     // operation cancelled
                     return;
-
-                } else if (!ec && bytes_recvd > 0) {
-                    if (from.address() == remoteHost) {
-                        failedToReceiveFromRemote.clear();
-                        const uint16_t port = from.port();
-
-                        try {
-                            size_t len = bytes_recvd;
-                            coapPorts.udpToSerial(port, data.get(), &len,
-                                                  FORT_AGENT_BUFFER_UNIT_SZ +
-                                                  3);
-                            serialHandler->asyncSendMessageToSerialPort(
-                                data.get(),
-                                len);
-                        }
-                        catch (CoapException &e) {
-                            failedToSendSerial.log(
-                                "Failed to send message to serial: {}",
-                                e.what());
-                        }
-                    } else {
-                        spdlog::trace(
-                            "Received traffic from {} and not the desired remote {}",
-                            from.address(), remoteHost);
-                    }
-
-
+                } else if (ec) {
+                    failedToListenSerial.log("Listen failure for {}, ec = {}",
+                                             localEndpoint, ec);
                 } else {
-                    failedToListenSerial.log(
-                        "Listen failure for {}, ec = {}, bytes_recvd = {}",
-                        localEndpoint, ec, bytes_recvd);
+                    drainLocalSocket();
                 }
 
                 receiveFromRemote();
-            }
+            })
         );
     }
     catch (...) {
@@ -210,8 +269,352 @@ void UartCoapBridge::receiveFromRemote() {
     }
 }
 
+void UartCoapBridge::drainLocalSocket() {
+    FXN_TRACE;
+#ifdef __linux__
+    std::array<DatagramPtr, udpBatchSize> buffers;
+    std::array<sockaddr_storage, udpBatchSize> addrs;
+    std::array<iovec, udpBatchSize> iovs;
+    std::array<mmsghdr, udpBatchSize> msgs;
+
+    while (true) {
+        DatagramBatch toSerial;
+        DatagramBatch fromCache;
+        for (size_t i = 0; i < udpBatchSize; i++) {
+            if (!buffers[i]) {
+                buffers[i] = datagramPool.acquire();
+            }
+            iovs[i].iov_base = buffers[i].data();
+            iovs[i].iov_len = mtu;
+            msgs[i].msg_hdr = {};
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_len = 0;
+        }
+
+        const int received = ::recvmmsg(localSocket.native_handle(), msgs.data(),
+                                        udpBatchSize, MSG_DONTWAIT, nullptr);
+        if (received < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                failedToListenSerial.log("recvmmsg failure for {}: {}", localEndpoint,
+                                         std::strerror(errno));
+            }
+            return;
+        }
+        rxBatchSizes.record(received);
+
+        for (int i = 0; i < received; i++) {
+            boost::asio::ip::udp::endpoint from;
+            std::memcpy(from.data(), &addrs[i], msgs[i].msg_hdr.msg_namelen);
+            from.resize(msgs[i].msg_hdr.msg_namelen);
+
+            // Admission before collapsing, so a request that is shed never leads identical ones
+            if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                failedToReceiveFromRemote.log("Dropping datagram from {} larger than {} bytes", from, mtu);
+            } else if (msgs[i].msg_len > 0 && acceptFromRemote(from) &&
+                       !serveFromCache(from, buffers[i], msgs[i].msg_len, fromCache) &&
+                       !shareObservation(from, buffers[i], msgs[i].msg_len, fromCache, toSerial) &&
+                       !shedOverload(from, buffers[i], msgs[i].msg_len, fromCache) &&
+                       !requestCollapser.onRequest(from.port(), buffers[i].data(), msgs[i].msg_len)) {
+                // hand the buffer on, a fresh one is acquired for the next recvmmsg
+                toSerial.push(from, std::move(buffers[i]), msgs[i].msg_len);
+            }
+        }
+
+        sendBatchToRemote(fromCache);
+
+        if (toSerial.count > 0) {
+            coapPorts.strand().post([this, toSerial = std::move(toSerial)]() mutable {
+                processRemoteBatch(toSerial);
+            });
+        }
+
+        if (static_cast<size_t>(received) < udpBatchSize) {
+            return;  // socket drained
+        }
+    }
+#else
+    DatagramBatch toSerial;
+    DatagramBatch fromCache;
+    while (localSocket.available() > 0 && !toSerial.full() && !fromCache.full()) {
+        DatagramPtr data = datagramPool.acquire();
+        boost::asio::ip::udp::endpoint from;
+        boost::system::error_code ec;
+        const size_t received = localSocket.receive_from(
+            boost::asio::buffer(data.data(), mtu), from, 0, ec);
+        if (ec) {
+            failedToListenSerial.log("Listen failure for {}, ec = {}", localEndpoint, ec);
+            return;
+        }
+        rxBatchSizes.record(1);
+        if (acceptFromRemote(from) && !serveFromCache(from, data, received, fromCache) &&
+            !shareObservation(from, data, received, fromCache, toSerial) &&
+            !shedOverload(from, data, received, fromCache) &&
+            !requestCollapser.onRequest(from.port(), data.data(), received)) {
+            toSerial.push(from, std::move(data), received);
+        }
+    }
+
+    sendBatchToRemote(fromCache);
+
+    if (toSerial.count > 0) {
+        coapPorts.strand().post([this, toSerial = std::move(toSerial)]() mutable {
+            processRemoteBatch(toSerial);
+        });
+    }
+#endif
+}
+
+bool UartCoapBridge::acceptFromRemote(const boost::asio::ip::udp::endpoint &from) {
+    FXN_TRACE;
+    if (from.address() != remoteHost) {
+        spdlog::trace("Received traffic from {} and not the desired remote {}",
+                      from.address(), remoteHost);
+        return false;
+    }
+
+    failedToReceiveFromRemote.clear();
+    return true;
+}
+
+bool UartCoapBridge::serveFromCache(const boost::asio::ip::udp::endpoint &from,
+                                    const DatagramPtr &data, std::size_t length,
+                                    DatagramBatch &replies) {
+    FXN_TRACE;
+    if (!responseCache.onRequest(from.port(), data.data(), length, cacheReply)) {
+        return false;
+    }
+
+    DatagramPtr reply = datagramPool.acquire();
+    if (cacheReply.size() > reply.capacity()) {
+        return false;  // let the device answer instead
+    }
+    std::copy(cacheReply.begin(), cacheReply.end(), reply.data());
+    replies.push(from, std::move(reply), cacheReply.size());
+    return true;
+}
+
+bool UartCoapBridge::shareObservation(const boost::asio::ip::udp::endpoint &from,
+                                      const DatagramPtr &data, std::size_t length,
+                                      DatagramBatch &replies, DatagramBatch &toSerial) {
+    FXN_TRACE;
+    // Each datagram produces at most one reply and one device message, so neither batch can fill
+    return observeHub.onRequest(
+        from.port(), data.data(), length,
+        [&](uint16_t port, const std::vector<uint8_t> &message) { queueMessage(replies, port, message); },
+        [&](uint16_t port, const std::vector<uint8_t> &message) { queueMessage(toSerial, port, message); });
+}
+
+bool UartCoapBridge::shedOverload(const boost::asio::ip::udp::endpoint &from, const DatagramPtr &data,
+                                  std::size_t length, DatagramBatch &replies) {
+    FXN_TRACE;
+    // Only requests are budgeted, ACKs and responses to the device's own requests always go through
+    if (!Coap::looksLikeCoap(data.data(), length) || !Coap::isRequest(data.data())) {
+        return false;
+    }
+    const uint32_t retryAfter = admission.admit(from.port(), length);
+    if (retryAfter == 0) {
+        return false;
+    }
+
+    // 5.03 Service Unavailable, Max-Age telling the client when its budget allows another request
+    DatagramPtr reply = datagramPool.acquire();
+    const size_t replyLength = Coap::createServiceUnavailable(data.data(), retryAfter, reply.data());
+
+    spdlog::debug("Port {} over its serial budget, answering 5.03 with Max-Age {}", from.port(), retryAfter);
+    replies.push(from, std::move(reply), replyLength);
+    return true;
+}
+
+void UartCoapBridge::processRemoteBatch(DatagramBatch &batch) {
+    FXN_TRACE;
+    DatagramBatch toSerial;
+
+    for (size_t i = 0; i < batch.count; i++) {
+        PendingDatagram &datagram = batch.entries[i];
+        try {
+            size_t len = datagram.length;
+            coapPorts.udpToSerial(datagram.to.port(), datagram.data.data(), &len,
+                                  datagram.data.capacity());
+            toSerial.push(datagram.to, std::move(datagram.data), len);
+        }
+        catch (CoapException &e) {
+            failedToSendSerial.log("Failed to send message to serial: {}", e.what());
+        }
+    }
+
+    if (toSerial.count > 0) {
+        serialHandler->strand().post([this, toSerial = std::move(toSerial)]() mutable {
+            DatagramBatch refused;
+            for (size_t i = 0; i < toSerial.count; i++) {
+                PendingDatagram &frame = toSerial.entries[i];
+                queueForSerial(frame.to, std::move(frame.data), frame.length, refused);
+            }
+            serialWriteReady();
+
+            returnRefused(refused);
+        });
+    }
+}
+
+bool UartCoapBridge::queueForSerial(const boost::asio::ip::udp::endpoint &to, DatagramPtr &&data, size_t length,
+                                    DatagramBatch &refused) {
+    if (serialScheduler.enqueue(to.port(), std::move(data), length)) {
+        return true;
+    }
+    serialQueueFull.log("Serial queue for port {} full, refusing frame", to.port());
+    if (Coap::isRequest(data.data())) {
+        // Still carries the tracking tokens, so it is routed back like a device response, which
+        // also answers the requests collapsed behind it or tells the agent's own handler
+        DatagramPtr reply = datagramPool.acquire();
+        const size_t replyLength = Coap::createServiceUnavailable(data.data(), serialQueueFullRetrySeconds,
+                                                                  reply.data());
+        refused.push(to, std::move(reply), replyLength);
+    }
+    return false;
+}
+
+void UartCoapBridge::returnRefused(DatagramBatch &refused) {
+    if (refused.count > 0) {
+        coapPorts.strand().post([this, refused = std::move(refused)]() mutable {
+            processSerialBatch(refused);
+        });
+    }
+}
+
+void UartCoapBridge::flushToRemote(DatagramBatch &batch) {
+    FXN_TRACE;
+    replicateNotifications(batch);
+    if (batch.count == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < batch.count; i++) {
+        responseCache.onResponse(batch.entries[i].to.port(), batch.entries[i].data.data(),
+                                 batch.entries[i].length);
+    }
+    fanOutResponses(batch);
+    sendBatchToRemote(batch);
+}
+
+void UartCoapBridge::sendBatchToRemote(DatagramBatch &batch) {
+    FXN_TRACE;
+    if (batch.count == 0) {
+        return;
+    }
+
+    size_t sent = 0;
+#ifdef __linux__
+    if (localSocket.is_open()) {
+        std::array<iovec, udpBatchSize> iovs;
+        std::array<mmsghdr, udpBatchSize> msgs;
+        for (size_t i = 0; i < batch.count; i++) {
+            PendingDatagram &pending = batch.entries[i];
+            iovs[i].iov_base = pending.data.data();
+            iovs[i].iov_len = pending.length;
+            msgs[i].msg_hdr = {};
+            msgs[i].msg_hdr.msg_name = pending.to.data();
+            msgs[i].msg_hdr.msg_namelen = pending.to.size();
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_len = 0;
+        }
+
+        const int result = ::sendmmsg(localSocket.native_handle(), msgs.data(),
+                                      batch.count, MSG_DONTWAIT);
+        if (result > 0) {
+            sent = static_cast<size_t>(result);
+            txBatchSizes.record(sent);
+            for (size_t i = 0; i < sent; i++) {
+                clearFailedToSendToRemote(batch.entries[i].to.port());
+            }
+        }
+    }
+#endif
+
+    // Whatever sendmmsg did not take (socket buffer full, per-destination error, non-Linux build)
+    // goes through the regular async path, which waits for writability and reports errors.
+    for (size_t i = sent; i < batch.count; i++) {
+        PendingDatagram &pending = batch.entries[i];
+        sendToRemote(pending.to, std::move(pending.data), pending.length);
+    }
+}
+
+void UartCoapBridge::fanOutResponses(const DatagramBatch &batch) {
+    FXN_TRACE;
+    DatagramBatch copies;
+
+    for (size_t i = 0; i < batch.count; i++) {
+        const PendingDatagram &response = batch.entries[i];
+        requestCollapser.onResponse(
+            response.to.port(), response.data.data(), response.length,
+            [&](uint16_t port, const std::vector<uint8_t> &message) {
+                if (copies.full()) {
+                    sendBatchToRemote(copies);
+                    copies.count = 0;
+                }
+                queueMessage(copies, port, message);
+            });
+    }
+
+    sendBatchToRemote(copies);
+}
+
+void UartCoapBridge::replicateNotifications(DatagramBatch &batch) {
+    FXN_TRACE;
+    DatagramBatch copies;
+    DatagramBatch toSerial;
+    size_t kept = 0;
+
+    for (size_t i = 0; i < batch.count; i++) {
+        PendingDatagram &pending = batch.entries[i];
+        if (pending.to.port() != CoapObserveHub::hubPort) {
+            if (kept != i) {
+                batch.entries[kept] = std::move(pending);
+            }
+            kept++;
+            continue;
+        }
+
+        observeHub.onDeviceMessage(
+            pending.data.data(), pending.length,
+            [&](uint16_t port, const std::vector<uint8_t> &message) {
+                if (copies.full()) {
+                    sendBatchToRemote(copies);
+                    copies.count = 0;
+                }
+                queueMessage(copies, port, message);
+            },
+            [&](uint16_t port, const std::vector<uint8_t> &message) {
+                if (!toSerial.full()) {
+                    queueMessage(toSerial, port, message);
+                }
+            });
+        pending.data.reset();
+    }
+    batch.count = kept;
+
+    sendBatchToRemote(copies);
+    if (toSerial.count > 0) {
+        coapPorts.strand().post([this, toSerial = std::move(toSerial)]() mutable {
+            processRemoteBatch(toSerial);
+        });
+    }
+}
+
+void UartCoapBridge::queueMessage(DatagramBatch &batch, uint16_t port, const std::vector<uint8_t> &message) {
+    if (message.size() > mtu) {
+        return;
+    }
+    DatagramPtr copy = datagramPool.acquire();
+    std::copy(message.begin(), message.end(), copy.data());
+    batch.push(boost::asio::ip::udp::endpoint(remoteHost, port), std::move(copy), message.size());
+}
+
 void UartCoapBridge::sendToRemote(boost::asio::ip::udp::endpoint to,
-                                  std::shared_ptr<uint8_t[]> data,
+                                  DatagramPtr data,
                                   std::size_t length) {
     FXN_TRACE;
     if (!localSocket.is_open()) {
@@ -222,9 +625,9 @@ void UartCoapBridge::sendToRemote(boost::asio::ip::udp::endpoint to,
     // spdlog::debug("Sending data to {}", to);
 
     localSocket.async_send_to(
-        boost::asio::buffer(data.get(), length),
+        boost::asio::buffer(data.data(), length),
         to,
-        [this, data, to](boost::system::error_code ec, std::size_t bytes_sent) {
+        udpStrand.wrap([this, data, to](boost::system::error_code ec, std::size_t bytes_sent) {
             if (ec) {
                 if (ec == boost::asio::error::operation_aborted) {
                     // operation cancelled
@@ -239,7 +642,7 @@ void UartCoapBridge::sendToRemote(boost::asio::ip::udp::endpoint to,
                 // spdlog::debug("Sent {} to {}", bytes_sent, to);
                 clearFailedToSendToRemote(to.port());
             }
-        }
+        })
     );
 }
 
@@ -271,29 +674,81 @@ void UartCoapBridge::clearFailedToSendToRemote(uint16_t port) {
 void UartCoapBridge::sendSRCRequest(const std::vector<uint8_t> &coapMsg, const uint16_t port) {
     FXN_TRACE;
 
-    try {
-        // Build message with room for tracking tokens
-        size_t len = coapMsg.size();
-        size_t maxLen = len + 3; // room for tracking tokens
+    // Copy into a buffer with room for tracking tokens while the caller's vector is still alive,
+    // the tracking itself has to happen on the tracker strand
+    const size_t msgLen = coapMsg.size();
+    DatagramPtr buffer = datagramPool.acquire();
+    const bool fits = msgLen + trackingTokenHeadroom <= buffer.capacity();
+    if (fits) {
+        std::copy(coapMsg.begin(), coapMsg.end(), buffer.data());
+    }
 
-        std::vector<uint8_t> buffer(maxLen);
-        std::copy(coapMsg.begin(), coapMsg.end(), buffer.begin());
+    coapPorts.strand().post([this, buffer = std::move(buffer), msgLen, fits, port]() mutable {
+        try {
+            if (!fits) {
+                throw CoapException(fmt::format("SRC request of {} bytes exceeds datagram buffer of {} bytes",
+                                                msgLen, buffer.capacity()));
+            }
 
-        coapPorts.udpToSerial(port, buffer.data(), &len, maxLen);
+            size_t len = msgLen;
+            coapPorts.udpToSerial(port, buffer.data(), &len, buffer.capacity());
 
-        spdlog::debug("Sending Observe request: MID {} -> port {}, msg = {}",
-            Coap::getMid(buffer.data()), port,
-            UartCoapBridge::dataToHex(buffer.data(), len));
+            spdlog::debug("Sending Observe request: MID {} -> port {}, msg = {}",
+                Coap::getMid(buffer.data()), port,
+                UartCoapBridge::dataToHex(buffer.data(), len));
 
-        // Send to serial
-        serialHandler->asyncSendMessageToSerialPort(
-            buffer.data(),
-            len);
+            // Send to serial
+            serialHandler->strand().post([this, buffer = std::move(buffer), len, port]() mutable {
+                DatagramBatch refused;
+                queueForSerial(boost::asio::ip::udp::endpoint(remoteHost, port), std::move(buffer), len, refused);
+                serialWriteReady();
+                returnRefused(refused);
+            });
+        }
+        catch (CoapException &e) {
+            failedToSendSerial.log(
+                "Failed to send message to serial: {}",
+                e.what());
+        }
+    });
+}
+
+void UartCoapBridge::reportStats() {
+    const DatagramPoolStats pool = datagramPool.stats();
+    spdlog::info("Datagram pool      : {}/{} in use (high water {}), {} acquired, {} exhausted",
+                 pool.inUse, pool.capacity, pool.highWater, pool.acquired, pool.exhausted);
+    spdlog::info("UDP RX batch size  : {}", rxBatchSizes.summary());
+    spdlog::info("UDP TX batch size  : {}", txBatchSizes.summary());
+    const CoapResponseCache::Stats cache = responseCache.stats();
+    spdlog::info("GET cache          : {}/{} hits ({:.1f}%), {} stored, {} invalidated, {} entries",
+                 cache.hits, cache.lookups, cache.lookups == 0 ? 0.0 : 100.0 * cache.hits / cache.lookups,
+                 cache.stores, cache.invalidations, cache.entries);
+    const CoapRequestCollapser::Stats collapse = requestCollapser.stats();
+    spdlog::info("GET collapsing     : {} forwarded, {} collapsed, {} fanned out, {} abandoned, {} in flight",
+                 collapse.forwarded, collapse.collapsed, collapse.fannedOut, collapse.abandoned,
+                 collapse.inFlight);
+    std::map<uint16_t, std::pair<FairScheduler::ClientStats, uint64_t>> clients;
+    for (const FairScheduler::ClientStats &client : serialScheduler.stats()) {
+        clients[client.port].first = client;
     }
-    catch (CoapException &e) {
-        failedToSendSerial.log(
-            "Failed to send message to serial: {}",
-            e.what());
+    for (const ClientAdmission::ClientStats &client : admission.stats()) {
+        clients[client.port].second = client.rejected;
+    }
+    for (const auto &client : clients) {
+        const FairScheduler::ClientStats &sent = client.second.first;
+        spdlog::info("Serial client {:<5}: {} frames / {} bytes sent, {} queued, {} dropped, {} shed with 5.03",
+                     client.first, sent.frames, sent.bytes, sent.queued, sent.dropped, client.second.second);
+    }
+    const LinkMonitor::Stats link = linkMonitor->stats();
+    spdlog::info("Serial link        : ping rtt us {}, {}/{} lost ({:.1f}%), {} silence events, last RX {} ms ago{}",
+                 linkMonitor->rtt().summary(), link.lost, link.pingsSent, 100.0 * linkMonitor->lossRate(),
+                 link.silenceEvents, link.sinceLastRxMs, link.silent ? " (SILENT)" : "");
+    const CoapObserveHub::Stats observe = observeHub.stats();
+    spdlog::info("Observe sharing    : {} subscriptions, {} observers, {} notifications -> {} copies, {} shared registrations",
+                 observe.subscriptions, observe.observers, observe.notifications, observe.replicated,
+                 observe.registrationsShared);
+    responseDispatcher.reportStats();
+    for (const TimedStrand *strand : {&serialHandler->strand(), &coapPorts.strand(), &udpStrand}) {
+        spdlog::info("Strand {:<11}: queue latency us {}", strand->name(), strand->queueLatency().summary());
     }
-
 }
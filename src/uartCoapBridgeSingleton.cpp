@@ -8,11 +8,12 @@ UartCoapBridge& UartCoapBridgeSingleton::instance(
     uint16_t localPort,
     const std::string& serialPath,
     const std::string& remoteAddr,
-    uint16_t remotePort
+    uint16_t remotePort,
+    const UartCoapBridgeSettings& settings
 ) {
     if (!bridgePtr) {
         bridgePtr = std::make_unique<UartCoapBridge>(
-            service, localAddr, localPort, serialPath, remoteAddr, remotePort
+            service, localAddr, localPort, serialPath, remoteAddr, remotePort, settings
         );
     }
     return *bridgePtr;
@@ -0,0 +1,85 @@
+#include <fort_agent/wakeSignal.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // Sleep no longer than this in one go so a far away deadline can't overflow the timeout
+    constexpr auto longestSleep = std::chrono::hours(1);
+}
+
+#if defined(__linux__)
+
+WakeSignal::WakeSignal() :
+    eventFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {
+    if (eventFd < 0) {
+        throw std::runtime_error(std::string("eventfd failed: ") + std::strerror(errno));
+    }
+}
+
+WakeSignal::~WakeSignal() {
+    close(eventFd);
+}
+
+void WakeSignal::signal() {
+    const uint64_t one = 1;
+    // Only fails when the counter would overflow, in which case the consumer is already signalled
+    (void) !write(eventFd, &one, sizeof(one));
+}
+
+bool WakeSignal::sleepUntil(Clock::time_point deadline) {
+    // Checked before subtracting, a deadline far in the past would overflow
+    const Clock::time_point now = Clock::now();
+    if (deadline <= now) {
+        return false;
+    }
+    const auto remaining = std::min<Clock::duration>(deadline - now, longestSleep);
+
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+    const timespec timeout{static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+    pollfd pfd{eventFd, POLLIN, 0};
+    const int ready = ppoll(&pfd, 1, &timeout, nullptr);
+    if (ready <= 0) {
+        return false;   // timed out, or interrupted by a signal: let the caller check again
+    }
+
+    uint64_t count;
+    (void) !read(eventFd, &count, sizeof(count));
+    return true;
+}
+
+#else
+
+WakeSignal::WakeSignal() = default;
+
+WakeSignal::~WakeSignal() = default;
+
+void WakeSignal::signal() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        signalled = true;
+    }
+    cv.notify_one();
+}
+
+bool WakeSignal::sleepUntil(Clock::time_point deadline) {
+    const Clock::time_point now = Clock::now();
+    if (deadline <= now) {
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    const Clock::time_point until = std::min(deadline, now + longestSleep);
+    const bool woken = cv.wait_until(lock, until, [this] { return signalled; });
+    signalled = false;
+    return woken;
+}
+
+#endif
@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+
+#include <fort_agent/clientAdmission.h>
+
+using Clock = ClientAdmission::Clock;
+
+TEST(ClientAdmissionTest, ShedsOnceTheBurstIsSpent) {
+    ClientAdmission admission(1000, 100, 300);
+    const Clock::time_point start = Clock::now();
+
+    EXPECT_EQ(admission.admit(4000, 100, start), 0u);
+    EXPECT_EQ(admission.admit(4000, 100, start), 0u);
+    EXPECT_EQ(admission.admit(4000, 100, start), 0u);
+    // bucket empty, 100 bytes at 100 bytes/s is a second away
+    EXPECT_EQ(admission.admit(4000, 100, start), 1u);
+    EXPECT_EQ(admission.admit(4000, 250, start), 3u);
+
+    // another client is unaffected
+    EXPECT_EQ(admission.admit(5000, 100, start), 0u);
+
+    // and the first recovers at its rate
+    EXPECT_EQ(admission.admit(4000, 100, start + std::chrono::seconds(1)), 0u);
+
+    const auto stats = admission.stats();
+    ASSERT_EQ(stats.size(), 2u);
+    EXPECT_EQ(stats[0].port, 4000);
+    EXPECT_EQ(stats[0].admitted, 4u);
+    EXPECT_EQ(stats[0].admittedBytes, 400u);
+    EXPECT_EQ(stats[0].rejected, 2u);
+    EXPECT_EQ(stats[1].rejected, 0u);
+}
+
+TEST(ClientAdmissionTest, SplitsTheLinkBetweenActiveClients) {
+    ClientAdmission admission(1000, 0, 100, std::chrono::seconds(5));
+    const Clock::time_point start = Clock::now();
+
+    // alone, a client refills at the full link rate
+    EXPECT_EQ(admission.admit(4000, 100, start), 0u);
+    EXPECT_EQ(admission.admit(4000, 100, start + std::chrono::milliseconds(100)), 0u);
+
+    // once a second client shows up each gets half
+    EXPECT_EQ(admission.admit(5000, 100, start + std::chrono::milliseconds(100)), 0u);
+    EXPECT_EQ(admission.admit(4000, 100, start + std::chrono::milliseconds(200)), 1u);
+    EXPECT_EQ(admission.admit(4000, 100, start + std::chrono::milliseconds(300)), 0u);
+}
@@ -89,4 +89,40 @@ TEST(CoapHelpersTest, CreateResetMsgProducesExpectedLayout) {
     EXPECT_EQ(reset, expected);
 }
 
+TEST(CoapHelpersTest, RequestHashIgnoresExchangeAndNoCacheKeyOptions) {
+    using namespace Coap;
+    auto first = buildMessage(Type::CON, Method::GET, 0x10, {"cfg", "setup"}, {}, {}, {0xA1}, Format::NONE);
+    auto second = buildMessage(Type::NON, Method::GET, 0x20, {"cfg", "setup"}, {}, {}, {0xB1, 0xB2}, Format::NONE);
+    uint16_t last = 11;
+    const uint8_t size1 = 64;
+    appendOption(second, 60, &size1, 1, last);  // Size1 is a NoCacheKey option
+    auto other = buildMessage(Type::CON, Method::GET, 0x10, {"cfg", "setupx"}, {}, {}, {0xA1}, Format::NONE);
+    auto observe = buildMessage(Type::CON, Method::GET, 0x30, {"cfg", "setup"}, {}, {}, {0xC1}, Format::NONE, true, 0);
+
+    const RequestHash hash = requestHash(first.data(), first.size());
+    EXPECT_FALSE(hash.observe);
+    EXPECT_EQ(requestHash(second.data(), second.size()).value, hash.value);
+    EXPECT_NE(requestHash(other.data(), other.size()).value, hash.value);
+
+    const RequestHash observed = requestHash(observe.data(), observe.size());
+    EXPECT_TRUE(observed.observe);
+    EXPECT_EQ(observed.value, hash.value);
+}
+
+TEST(CoapHelpersTest, ExchangeIdUsesTokenOrMid) {
+    using namespace Coap;
+    const std::vector<uint8_t> tokenless{0x40, 0x01, 0x12, 0x34};
+    const std::vector<uint8_t> token{0x42, 0x01, 0x99, 0x99, 0x12, 0x34};
+
+    EXPECT_EQ(exchangeId(4000, tokenless.data()), exchangeId(4000, tokenless.data()));
+    EXPECT_FALSE(exchangeId(4000, tokenless.data()) == exchangeId(5000, tokenless.data()));
+    EXPECT_FALSE(exchangeId(4000, tokenless.data()) == exchangeId(4000, token.data()));
+
+    const ExchangeId id = exchangeId(4000, token.data());
+    EXPECT_EQ(id.tokenLength, 2u);
+    EXPECT_EQ(id.bytes[0], 0x12);
+    EXPECT_EQ(id.bytes[1], 0x34);
+    EXPECT_EQ(id.bytes[2], 0x00);
+}
+
 }  // namespace
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fort_agent/coapObserveHub.h>
+
+namespace {
+
+typedef std::vector<std::pair<uint16_t, std::vector<uint8_t>>> Sent;
+
+std::vector<uint8_t> get(uint16_t mid, std::vector<uint8_t> token, bool withObserve, uint32_t value) {
+    std::vector<uint8_t> msg = {static_cast<uint8_t>(0x40 | token.size()), 0x01,
+                                static_cast<uint8_t>(mid >> 8), static_cast<uint8_t>(mid & 0xFF)};
+    msg.insert(msg.end(), token.begin(), token.end());
+    uint16_t last = 0;
+    if (withObserve) {
+        Coap::appendUintOption(msg, 6, value, last);
+    }
+    for (const std::string segment : {"st", "joystick", "combined"}) {
+        Coap::appendOption(msg, 11, reinterpret_cast<const uint8_t *>(segment.data()), segment.size(), last);
+    }
+    return msg;
+}
+
+std::vector<uint8_t> observe(uint32_t value, uint16_t mid, std::vector<uint8_t> token) {
+    return get(mid, std::move(token), true, value);
+}
+
+// A notification as the device sends it, echoing the token the hub registered with
+std::vector<uint8_t> notification(Coap::Type type, uint16_t mid, const std::vector<uint8_t> &request,
+                                  uint32_t sequence, const std::string &payload) {
+    const size_t tokenLength = request[0] & 0x0F;
+    std::vector<uint8_t> msg = {static_cast<uint8_t>(0x40 | (static_cast<uint8_t>(type) << 4) | tokenLength),
+                                0x45, static_cast<uint8_t>(mid >> 8), static_cast<uint8_t>(mid & 0xFF)};
+    msg.insert(msg.end(), request.begin() + 4, request.begin() + 4 + tokenLength);
+    uint16_t last = 0;
+    Coap::appendUintOption(msg, 6, sequence, last);
+    msg.push_back(0xFF);
+    msg.insert(msg.end(), payload.begin(), payload.end());
+    return msg;
+}
+
+std::string payloadOf(const Coap::MessageView &view) {
+    return std::string(reinterpret_cast<const char *>(view.payload), view.payloadLength);
+}
+
+class CoapObserveHubTest : public ::testing::Test {
+protected:
+    bool request(uint16_t port, const std::vector<uint8_t> &msg) {
+        return hub.onRequest(port, msg.data(), msg.size(), toClient, toDevice);
+    }
+
+    void fromDevice(const std::vector<uint8_t> &msg) {
+        hub.onDeviceMessage(msg.data(), msg.size(), toClient, toDevice);
+    }
+
+    CoapObserveHub hub;
+    Sent clients;
+    Sent device;
+    CoapObserveHub::EmitFn toClient = [this](uint16_t port, const std::vector<uint8_t> &msg) {
+        clients.emplace_back(port, msg);
+    };
+    CoapObserveHub::EmitFn toDevice = [this](uint16_t port, const std::vector<uint8_t> &msg) {
+        device.emplace_back(port, msg);
+    };
+};
+
+}
+
+TEST_F(CoapObserveHubTest, SharesOneDeviceSubscription) {
+    EXPECT_TRUE(request(4000, observe(0, 0x10, {0xA1})));
+    ASSERT_EQ(device.size(), 1u);
+    EXPECT_EQ(device[0].first, CoapObserveHub::hubPort);
+    const std::vector<uint8_t> registration = device[0].second;
+    const Coap::MessageView reg = Coap::parseMessage(registration.data(), registration.size());
+    EXPECT_TRUE(reg.hasObserve);
+    EXPECT_EQ(reg.observe, 0u);
+    EXPECT_EQ(Coap::requestKey(registration.data(), registration.size()).uri, "st/joystick/combined");
+
+    // the device answers the registration, the first client gets the piggybacked ACK
+    auto first = notification(Coap::Type::ACK, reg.mid, registration, 1, "A");
+    fromDevice(first);
+    ASSERT_EQ(clients.size(), 1u);
+    Coap::MessageView toFirst = Coap::parseMessage(clients[0].second.data(), clients[0].second.size());
+    EXPECT_EQ(clients[0].first, 4000);
+    EXPECT_EQ(toFirst.type, Coap::Type::ACK);
+    EXPECT_EQ(toFirst.mid, 0x10);
+    ASSERT_EQ(toFirst.tokenLength, 1u);
+    EXPECT_EQ(toFirst.token[0], 0xA1);
+    EXPECT_EQ(payloadOf(toFirst), "A");
+
+    // a second observer is answered locally, nothing new goes to the device
+    EXPECT_TRUE(request(5000, observe(0, 0x20, {0xB1, 0xB2})));
+    EXPECT_EQ(device.size(), 1u);
+    ASSERT_EQ(clients.size(), 2u);
+    const Coap::MessageView toSecond = Coap::parseMessage(clients[1].second.data(), clients[1].second.size());
+    EXPECT_EQ(clients[1].first, 5000);
+    EXPECT_EQ(toSecond.type, Coap::Type::ACK);
+    EXPECT_EQ(toSecond.mid, 0x20);
+    EXPECT_EQ(toSecond.observe, 1u);
+
+    // one CON notification from the device reaches both, and is ACKed to the device
+    clients.clear();
+    fromDevice(notification(Coap::Type::CON, 0x99, registration, 2, "B"));
+    ASSERT_EQ(device.size(), 2u);
+    EXPECT_TRUE(Coap::isEmpty(device[1].second.data()));
+    EXPECT_EQ(Coap::getCoapType(device[1].second.data()), Coap::Type::ACK);
+    EXPECT_EQ(Coap::getMid(device[1].second.data()), 0x99);
+
+    ASSERT_EQ(clients.size(), 2u);
+    for (const auto &sent : clients) {
+        const Coap::MessageView view = Coap::parseMessage(sent.second.data(), sent.second.size());
+        EXPECT_EQ(view.type, Coap::Type::NON);
+        EXPECT_EQ(view.observe, 2u);
+        EXPECT_EQ(payloadOf(view), "B");
+    }
+    EXPECT_EQ(Coap::parseMessage(clients[1].second.data(), clients[1].second.size()).tokenLength, 2u);
+
+    const CoapObserveHub::Stats stats = hub.stats();
+    EXPECT_EQ(stats.subscriptions, 1u);
+    EXPECT_EQ(stats.observers, 2u);
+    EXPECT_EQ(stats.notifications, 2u);
+    EXPECT_EQ(stats.registrationsShared, 1u);
+}
+
+TEST_F(CoapObserveHubTest, DeregistersWhenLastObserverLeaves) {
+    request(4000, observe(0, 0x10, {0xA1}));
+    const std::vector<uint8_t> registration = device[0].second;
+    fromDevice(notification(Coap::Type::ACK, Coap::getMid(registration.data()), registration, 1, "A"));
+    request(5000, observe(0, 0x20, {0xB1}));
+    clients.clear();
+
+    // the first observer leaves explicitly and gets the representation without Observe
+    EXPECT_TRUE(request(4000, observe(1, 0x11, {0xA1})));
+    EXPECT_EQ(device.size(), 1u);
+    ASSERT_EQ(clients.size(), 1u);
+    const Coap::MessageView reply = Coap::parseMessage(clients[0].second.data(), clients[0].second.size());
+    EXPECT_EQ(reply.mid, 0x11);
+    EXPECT_FALSE(reply.hasObserve);
+    EXPECT_EQ(payloadOf(reply), "A");
+
+    // the other resets a notification, which cancels the device side
+    clients.clear();
+    fromDevice(notification(Coap::Type::NON, 0x98, registration, 2, "B"));
+    ASSERT_EQ(clients.size(), 1u);
+    const auto reset = Coap::createResetMsg(Coap::getMid(clients[0].second.data()));
+    EXPECT_TRUE(request(5000, std::vector<uint8_t>(reset.begin(), reset.end())));
+
+    ASSERT_EQ(device.size(), 2u);
+    const Coap::MessageView cancel = Coap::parseMessage(device[1].second.data(), device[1].second.size());
+    EXPECT_EQ(cancel.observe, 1u);
+    EXPECT_EQ(std::vector<uint8_t>(cancel.token, cancel.token + cancel.tokenLength),
+              std::vector<uint8_t>(registration.begin() + 4, registration.begin() + 4 + (registration[0] & 0x0F)));
+    EXPECT_EQ(hub.stats().subscriptions, 0u);
+
+    // a late CON notification is rejected
+    fromDevice(notification(Coap::Type::CON, 0x97, registration, 3, "C"));
+    ASSERT_EQ(device.size(), 3u);
+    EXPECT_EQ(Coap::getCoapType(device[2].second.data()), Coap::Type::RST);
+
+    // and the next observer starts a fresh subscription
+    EXPECT_TRUE(request(6000, observe(0, 0x30, {0xC1})));
+    EXPECT_EQ(device.size(), 4u);
+    EXPECT_EQ(hub.stats().subscriptions, 1u);
+}
+
+TEST_F(CoapObserveHubTest, ErrorEndsTheSubscription) {
+    request(4000, observe(0, 0x10, {0xA1}));
+    request(5000, observe(0, 0x20, {0xB1}));
+    const std::vector<uint8_t> registration = device[0].second;
+
+    auto error = notification(Coap::Type::ACK, Coap::getMid(registration.data()), registration, 0, "");
+    error[1] = 0x84;  // 4.04
+    fromDevice(error);
+
+    ASSERT_EQ(clients.size(), 2u);
+    EXPECT_EQ(Coap::getCode(clients[0].second.data()), 0x84);
+    EXPECT_EQ(Coap::getCode(clients[1].second.data()), 0x84);
+    EXPECT_EQ(hub.stats().subscriptions, 0u);
+    EXPECT_EQ(hub.stats().observers, 0u);
+}
+
+TEST_F(CoapObserveHubTest, IgnoresPlainRequests) {
+    EXPECT_FALSE(request(4000, get(0x10, {0xA1}, false, 0)));
+    EXPECT_TRUE(device.empty());
+    EXPECT_TRUE(clients.empty());
+}
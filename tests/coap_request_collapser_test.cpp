@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fort_agent/coapRequestCollapser.h>
+
+namespace {
+
+std::vector<uint8_t> get(Coap::Type type, uint16_t mid, std::vector<uint8_t> token,
+                         const std::vector<std::string> &path = {"cfg", "setup", "modelNumber"}) {
+    std::vector<uint8_t> msg = {static_cast<uint8_t>(0x40 | (static_cast<uint8_t>(type) << 4) | token.size()),
+                                0x01, static_cast<uint8_t>(mid >> 8), static_cast<uint8_t>(mid & 0xFF)};
+    msg.insert(msg.end(), token.begin(), token.end());
+    uint16_t last = 0;
+    for (const std::string &segment : path) {
+        Coap::appendOption(msg, 11, reinterpret_cast<const uint8_t *>(segment.data()), segment.size(), last);
+    }
+    return msg;
+}
+
+std::vector<uint8_t> ack(uint16_t mid, std::vector<uint8_t> token, const std::string &payload) {
+    std::vector<uint8_t> msg = {static_cast<uint8_t>(0x60 | token.size()), 0x45,
+                                static_cast<uint8_t>(mid >> 8), static_cast<uint8_t>(mid & 0xFF)};
+    msg.insert(msg.end(), token.begin(), token.end());
+    msg.push_back(0xFF);
+    msg.insert(msg.end(), payload.begin(), payload.end());
+    return msg;
+}
+
+TEST(CoapRequestCollapserTest, FansOutWithEachClientsMidAndToken) {
+    CoapRequestCollapser collapser;
+
+    auto leader = get(Coap::Type::CON, 0x10, {0xA1});
+    auto second = get(Coap::Type::CON, 0x20, {0xB1, 0xB2});
+    auto third = get(Coap::Type::NON, 0x30, {0xC1});
+    EXPECT_FALSE(collapser.onRequest(4000, leader.data(), leader.size()));
+    EXPECT_TRUE(collapser.onRequest(5000, second.data(), second.size()));
+    EXPECT_TRUE(collapser.onRequest(6000, third.data(), third.size()));
+
+    // retransmissions: the leader goes through again, a parked one is absorbed
+    EXPECT_FALSE(collapser.onRequest(4000, leader.data(), leader.size()));
+    EXPECT_TRUE(collapser.onRequest(5000, second.data(), second.size()));
+
+    std::vector<std::pair<uint16_t, std::vector<uint8_t>>> emitted;
+    auto response = ack(0x10, {0xA1}, "M1");
+    collapser.onResponse(4000, response.data(), response.size(),
+                         [&](uint16_t port, const std::vector<uint8_t> &msg) { emitted.emplace_back(port, msg); });
+
+    ASSERT_EQ(emitted.size(), 2u);
+    const Coap::MessageView toSecond = Coap::parseMessage(emitted[0].second.data(), emitted[0].second.size());
+    EXPECT_EQ(emitted[0].first, 5000);
+    EXPECT_EQ(toSecond.type, Coap::Type::ACK);
+    EXPECT_EQ(toSecond.mid, 0x20);
+    ASSERT_EQ(toSecond.tokenLength, 2u);
+    EXPECT_EQ(toSecond.token[1], 0xB2);
+    EXPECT_EQ(std::string(reinterpret_cast<const char *>(toSecond.payload), toSecond.payloadLength), "M1");
+
+    const Coap::MessageView toThird = Coap::parseMessage(emitted[1].second.data(), emitted[1].second.size());
+    EXPECT_EQ(emitted[1].first, 6000);
+    EXPECT_EQ(toThird.type, Coap::Type::NON);
+    EXPECT_EQ(toThird.mid, 0x30);
+
+    const CoapRequestCollapser::Stats stats = collapser.stats();
+    EXPECT_EQ(stats.forwarded, 1u);
+    EXPECT_EQ(stats.collapsed, 2u);
+    EXPECT_EQ(stats.fannedOut, 2u);
+    EXPECT_EQ(stats.inFlight, 0u);
+
+    // once answered, the next GET is a new leader
+    EXPECT_FALSE(collapser.onRequest(5000, second.data(), second.size()));
+}
+
+TEST(CoapRequestCollapserTest, AbandonsTimedOutLeader) {
+    CoapRequestCollapser collapser(std::chrono::milliseconds(1));
+
+    auto leader = get(Coap::Type::CON, 0x10, {0xA1});
+    auto other = get(Coap::Type::CON, 0x20, {0xB1});
+    EXPECT_FALSE(collapser.onRequest(4000, leader.data(), leader.size()));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    // stale leader: the new request is forwarded and becomes the leader
+    EXPECT_FALSE(collapser.onRequest(5000, other.data(), other.size()));
+    EXPECT_EQ(collapser.stats().forwarded, 2u);
+
+    int emitted = 0;
+    auto late = ack(0x10, {0xA1}, "x");
+    collapser.onResponse(4000, late.data(), late.size(), [&](uint16_t, const std::vector<uint8_t> &) { emitted++; });
+    EXPECT_EQ(emitted, 0);
+}
+
+TEST(CoapRequestCollapserTest, ForwardsUntrackedWhenEverySlotHasALiveLeader) {
+    CoapRequestCollapser collapser(std::chrono::seconds(2), 32, 1);
+
+    auto model = get(Coap::Type::CON, 0x10, {0xA1});
+    auto serial = get(Coap::Type::CON, 0x20, {0xB1}, {"cfg", "setup", "serialNumber"});
+    auto sameSerial = get(Coap::Type::CON, 0x30, {0xC1}, {"cfg", "setup", "serialNumber"});
+    EXPECT_FALSE(collapser.onRequest(4000, model.data(), model.size()));
+    EXPECT_FALSE(collapser.onRequest(5000, serial.data(), serial.size()));
+    EXPECT_FALSE(collapser.onRequest(6000, sameSerial.data(), sameSerial.size()));
+
+    const CoapRequestCollapser::Stats stats = collapser.stats();
+    EXPECT_EQ(stats.forwarded, 3u);
+    EXPECT_EQ(stats.collapsed, 0u);
+    EXPECT_EQ(stats.inFlight, 1u);
+
+    // the tracked leader still collapses
+    auto sameModel = get(Coap::Type::NON, 0x40, {0xD1});
+    EXPECT_TRUE(collapser.onRequest(7000, sameModel.data(), sameModel.size()));
+}
+
+}  // namespace
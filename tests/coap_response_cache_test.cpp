@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <fort_agent/coapResponseCache.h>
+
+namespace {
+
+std::vector<uint8_t> request(Coap::Type type, uint8_t code, uint16_t mid, std::vector<uint8_t> token,
+                             const std::vector<std::string> &path, bool observe = false) {
+    std::vector<uint8_t> msg = {static_cast<uint8_t>(0x40 | (static_cast<uint8_t>(type) << 4) | token.size()),
+                                code, static_cast<uint8_t>(mid >> 8), static_cast<uint8_t>(mid & 0xFF)};
+    msg.insert(msg.end(), token.begin(), token.end());
+    uint16_t last = 0;
+    if (observe) {
+        Coap::appendUintOption(msg, 6, 0, last);
+    }
+    for (const auto &segment : path) {
+        Coap::appendOption(msg, 11, reinterpret_cast<const uint8_t *>(segment.data()), segment.size(), last);
+    }
+    return msg;
+}
+
+std::vector<uint8_t> content(uint16_t mid, std::vector<uint8_t> token, const std::string &payload,
+                             int maxAge = -1) {
+    std::vector<uint8_t> msg = {static_cast<uint8_t>(0x60 | token.size()), 0x45,
+                                static_cast<uint8_t>(mid >> 8), static_cast<uint8_t>(mid & 0xFF)};
+    msg.insert(msg.end(), token.begin(), token.end());
+    uint16_t last = 0;
+    Coap::appendUintOption(msg, 12, 0, last);
+    if (maxAge >= 0) {
+        Coap::appendUintOption(msg, 14, maxAge, last);
+    }
+    msg.push_back(0xFF);
+    msg.insert(msg.end(), payload.begin(), payload.end());
+    return msg;
+}
+
+const std::vector<std::string> serialPath = {"cfg", "setup", "serialNumber"};
+
+TEST(CoapResponseCacheTest, ServesConfiguredResourceWithClientMidAndToken) {
+    CoapResponseCache cache({{"cfg/setup/serialNumber", std::chrono::seconds(60)}});
+    std::vector<uint8_t> reply;
+
+    auto first = request(Coap::Type::CON, 0x01, 0x100, {0xA1}, serialPath);
+    EXPECT_FALSE(cache.onRequest(4000, first.data(), first.size(), reply));
+    auto response = content(0x100, {0xA1}, "SN123");
+    cache.onResponse(4000, response.data(), response.size());
+
+    auto second = request(Coap::Type::CON, 0x01, 0x200, {0xB1, 0xB2}, serialPath);
+    ASSERT_TRUE(cache.onRequest(5000, second.data(), second.size(), reply));
+
+    const Coap::MessageView view = Coap::parseMessage(reply.data(), reply.size());
+    EXPECT_EQ(view.type, Coap::Type::ACK);
+    EXPECT_EQ(view.code, 0x45);
+    EXPECT_EQ(view.mid, 0x200);
+    ASSERT_EQ(view.tokenLength, 2u);
+    EXPECT_EQ(view.token[0], 0xB1);
+    EXPECT_EQ(view.token[1], 0xB2);
+    EXPECT_EQ(view.contentFormat, Coap::Format::TEXT_PLAIN);
+    EXPECT_LE(view.maxAge, 60u);
+    EXPECT_EQ(std::string(reinterpret_cast<const char *>(view.payload), view.payloadLength), "SN123");
+
+    const CoapResponseCache::Stats stats = cache.stats();
+    EXPECT_EQ(stats.lookups, 2u);
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.stores, 1u);
+}
+
+TEST(CoapResponseCacheTest, OnlyCachesExplicitMaxAgeWithoutConfig) {
+    CoapResponseCache cache;
+    std::vector<uint8_t> reply;
+    const std::vector<std::string> path = {"st", "mode"};
+
+    auto get = request(Coap::Type::NON, 0x01, 1, {0x01}, path);
+    cache.onRequest(4000, get.data(), get.size(), reply);
+    auto plain = content(1, {0x01}, "a");
+    cache.onResponse(4000, plain.data(), plain.size());
+    EXPECT_FALSE(cache.onRequest(4000, get.data(), get.size(), reply));
+
+    auto withMaxAge = content(1, {0x01}, "b", 30);
+    cache.onResponse(4000, withMaxAge.data(), withMaxAge.size());
+    ASSERT_TRUE(cache.onRequest(4001, get.data(), get.size(), reply));
+    EXPECT_EQ(Coap::parseMessage(reply.data(), reply.size()).type, Coap::Type::NON);
+}
+
+TEST(CoapResponseCacheTest, PostInvalidatesAndObserveBypasses) {
+    CoapResponseCache cache({{"cfg/setup/serialNumber", std::chrono::seconds(60)}});
+    std::vector<uint8_t> reply;
+
+    auto get = request(Coap::Type::CON, 0x01, 1, {0x01}, serialPath);
+    cache.onRequest(4000, get.data(), get.size(), reply);
+    auto response = content(1, {0x01}, "SN1");
+    cache.onResponse(4000, response.data(), response.size());
+
+    auto observe = request(Coap::Type::CON, 0x01, 2, {0x02}, serialPath, true);
+    EXPECT_FALSE(cache.onRequest(4000, observe.data(), observe.size(), reply));
+
+    auto post = request(Coap::Type::CON, 0x02, 3, {0x03}, serialPath);
+    EXPECT_FALSE(cache.onRequest(4000, post.data(), post.size(), reply));
+    EXPECT_EQ(cache.stats().invalidations, 1u);
+    EXPECT_FALSE(cache.onRequest(4000, get.data(), get.size(), reply));
+}
+
+TEST(CoapResponseCacheTest, PostDropsGetsInFlight) {
+    CoapResponseCache cache({{"cfg/setup/serialNumber", std::chrono::seconds(60)}});
+    std::vector<uint8_t> reply;
+
+    // the GET reaches the device first, the POST overtakes its answer
+    auto get = request(Coap::Type::CON, 0x01, 1, {0x01}, serialPath);
+    EXPECT_FALSE(cache.onRequest(4000, get.data(), get.size(), reply));
+    auto post = request(Coap::Type::CON, 0x02, 2, {0x02}, serialPath);
+    EXPECT_FALSE(cache.onRequest(5000, post.data(), post.size(), reply));
+    auto stale = content(1, {0x01}, "SN-old");
+    cache.onResponse(4000, stale.data(), stale.size());
+
+    EXPECT_EQ(cache.stats().stores, 0u);
+    auto again = request(Coap::Type::CON, 0x01, 3, {0x03}, serialPath);
+    EXPECT_FALSE(cache.onRequest(4000, again.data(), again.size(), reply));
+}
+
+}  // namespace
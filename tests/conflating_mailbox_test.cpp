@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include <fort_agent/conflatingMailbox.h>
+
+TEST(ConflatingMailboxTest, LatestValueWins) {
+    ConflatingMailbox<int> mailbox;
+    int value = 0;
+    EXPECT_FALSE(mailbox.hasNew());
+    EXPECT_FALSE(mailbox.take(value));
+
+    EXPECT_TRUE(mailbox.publish(1));
+    EXPECT_FALSE(mailbox.publish(2));   // 1 was never taken
+    EXPECT_FALSE(mailbox.publish(3));
+    EXPECT_TRUE(mailbox.hasNew());
+
+    ASSERT_TRUE(mailbox.take(value));
+    EXPECT_EQ(value, 3);
+    EXPECT_FALSE(mailbox.take(value));
+
+    EXPECT_TRUE(mailbox.publish(4));
+    ASSERT_TRUE(mailbox.take(value));
+    EXPECT_EQ(value, 4);
+}
+
+TEST(ConflatingMailboxTest, ConsumerSeesMonotonicValuesAcrossThreads) {
+    struct Sample {
+        uint64_t sequence;
+        uint64_t check;
+    };
+    constexpr uint64_t count = 200000;
+    ConflatingMailbox<Sample> mailbox;
+    uint64_t conflated = 0;
+
+    std::thread producer([&]() {
+        for (uint64_t i = 1; i <= count; i++) {
+            if (!mailbox.publish({i, ~i})) {
+                conflated++;
+            }
+        }
+    });
+
+    uint64_t last = 0;
+    uint64_t taken = 0;
+    while (last < count) {
+        Sample sample;
+        if (mailbox.take(sample)) {
+            ASSERT_GT(sample.sequence, last);
+            ASSERT_EQ(sample.check, ~sample.sequence);   // never torn
+            last = sample.sequence;
+            taken++;
+        }
+    }
+    producer.join();
+    EXPECT_EQ(taken + conflated, count);
+}
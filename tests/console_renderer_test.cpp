@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include <fort_agent/consoleRenderer.h>
+
+TEST(ConsoleRendererTest, DiscardsEverythingUntilStarted) {
+    std::ostringstream out;
+    ConsoleRenderer console(out);
+    EXPECT_FALSE(console.enabled());
+    EXPECT_FALSE(console.post("lost"));
+    console.show("lost");
+
+    console.start(false, std::chrono::milliseconds(1));
+    EXPECT_FALSE(console.enabled());
+    EXPECT_FALSE(console.post("lost"));
+    console.stop();
+
+    EXPECT_TRUE(out.str().empty());
+    EXPECT_EQ(console.stats().posted, 0u);
+}
+
+TEST(ConsoleRendererTest, PrintsQueuedFramesThenLatestScreenThenView) {
+    std::ostringstream out;
+    ConsoleRenderer console(out);
+    int renders = 0;
+    console.setView([&renders]() { return renders++ == 0 ? std::string("view|") : std::string(); });
+
+    // Long interval, so everything is printed by the refresh stop() makes
+    console.start(true, std::chrono::hours(1));
+    EXPECT_TRUE(console.post("a|"));
+    EXPECT_TRUE(console.post("b|"));
+    console.show("old screen|");
+    console.show("screen|");
+    console.stop();
+
+    EXPECT_EQ(out.str(), "a|b|screen|view|");
+    const ConsoleRenderer::Stats stats = console.stats();
+    EXPECT_EQ(stats.posted, 2u);
+    EXPECT_EQ(stats.coalesced, 1u);
+    EXPECT_EQ(stats.refreshes, 1u);
+}
+
+TEST(ConsoleRendererTest, DropsFramesWhenTheQueueIsFull) {
+    std::ostringstream out;
+    ConsoleRenderer console(out);
+    console.start(true, std::chrono::hours(1));
+    for (size_t i = 0; i < ConsoleRenderer::queueCapacity; i++) {
+        EXPECT_TRUE(console.post("x"));
+    }
+    EXPECT_FALSE(console.post("y"));
+    console.stop();
+
+    EXPECT_EQ(out.str(), std::string(ConsoleRenderer::queueCapacity, 'x'));
+    EXPECT_EQ(console.stats().dropped, 1u);
+    EXPECT_FALSE(console.enabled());
+}
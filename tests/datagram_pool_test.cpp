@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+
+#include <fort_agent/datagramPool.h>
+
+namespace {
+
+TEST(DatagramPoolTest, RecyclesBuffersWhenLastReferenceDrops) {
+    DatagramPool pool(515, 2);
+
+    uint8_t *first = nullptr;
+    {
+        DatagramPtr a = pool.acquire();
+        DatagramPtr copy = a;
+        first = a.data();
+        EXPECT_EQ(a.capacity(), 515u);
+        EXPECT_EQ(pool.stats().inUse, 1u);
+    }
+    EXPECT_EQ(pool.stats().inUse, 0u);
+
+    DatagramPtr again = pool.acquire();
+    EXPECT_EQ(again.data(), first);
+    EXPECT_EQ(pool.stats().acquired, 2u);
+}
+
+TEST(DatagramPoolTest, FallsBackToHeapAndCountsExhaustion) {
+    DatagramPool pool(64, 1);
+
+    DatagramPtr a = pool.acquire();
+    DatagramPtr b = pool.acquire();
+    ASSERT_TRUE(b);
+    EXPECT_NE(a.data(), b.data());
+    EXPECT_EQ(b.capacity(), 64u);
+
+    const DatagramPoolStats stats = pool.stats();
+    EXPECT_EQ(stats.exhausted, 1u);
+    EXPECT_EQ(stats.inUse, 1u);
+    EXPECT_EQ(stats.highWater, 1u);
+
+    b.reset();
+    a.reset();
+    EXPECT_EQ(pool.stats().inUse, 0u);
+}
+
+}  // namespace
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <fort_agent/coapHelpers.h>
+#include <fort_agent/coapPortTracker.h>
+#include <fort_agent/fairScheduler.h>
+#include <fort_agent/responseDispatcher.h>
+
+namespace {
+
+std::vector<uint16_t> drain(FairScheduler &scheduler) {
+    std::vector<uint16_t> order;
+    FairScheduler::Frame frame;
+    while (scheduler.next([](size_t) { return true; }, frame)) {
+        order.push_back(frame.port);
+    }
+    return order;
+}
+
+}
+
+TEST(FairSchedulerTest, AlternatesBetweenClients) {
+    DatagramPool pool(64, 16);
+    FairScheduler scheduler(100, 16);
+
+    // a chatty client queues a burst before a quiet one sends anything
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(scheduler.enqueue(4000, pool.acquire(), 100));
+    }
+    EXPECT_TRUE(scheduler.enqueue(5000, pool.acquire(), 100));
+    EXPECT_TRUE(scheduler.enqueue(5000, pool.acquire(), 100));
+
+    EXPECT_EQ(drain(scheduler), (std::vector<uint16_t>{4000, 5000, 4000, 5000, 4000, 4000}));
+    EXPECT_TRUE(scheduler.empty());
+}
+
+TEST(FairSchedulerTest, SharesBytesNotFrames) {
+    DatagramPool pool(64, 16);
+    FairScheduler scheduler(200, 16);
+
+    // one client sends 200 byte frames, the other 50 byte frames: per round the small one gets four
+    EXPECT_TRUE(scheduler.enqueue(4000, pool.acquire(), 200));
+    EXPECT_TRUE(scheduler.enqueue(4000, pool.acquire(), 200));
+    for (int i = 0; i < 5; i++) {
+        EXPECT_TRUE(scheduler.enqueue(5000, pool.acquire(), 50));
+    }
+
+    EXPECT_EQ(drain(scheduler), (std::vector<uint16_t>{4000, 5000, 5000, 5000, 5000, 4000, 5000}));
+}
+
+TEST(FairSchedulerTest, WaitsForRoomAndBoundsQueues) {
+    DatagramPool pool(64, 16);
+    FairScheduler scheduler(256, 2);
+
+    EXPECT_TRUE(scheduler.enqueue(4000, pool.acquire(), 10));
+    EXPECT_TRUE(scheduler.enqueue(4000, pool.acquire(), 20));
+    DatagramPtr refused = pool.acquire();
+    EXPECT_FALSE(scheduler.enqueue(4000, std::move(refused), 30));
+    EXPECT_TRUE(refused);   // still the caller's, e.g. to answer it
+
+    FairScheduler::Frame frame;
+    EXPECT_FALSE(scheduler.next([](size_t) { return false; }, frame));
+    ASSERT_TRUE(scheduler.next([](size_t) { return true; }, frame));
+    EXPECT_EQ(frame.length, 10u);
+
+    const std::vector<FairScheduler::ClientStats> stats = scheduler.stats();
+    ASSERT_EQ(stats.size(), 1u);
+    EXPECT_EQ(stats[0].port, 4000);
+    EXPECT_EQ(stats[0].frames, 1u);
+    EXPECT_EQ(stats[0].bytes, 10u);
+    EXPECT_EQ(stats[0].dropped, 1u);
+    EXPECT_EQ(stats[0].queued, 1u);
+}
+
+TEST(FairSchedulerTest, RefusedAgentRequestIsAnsweredToItsHandler) {
+    // An agent request queued the way UartCoapBridge::sendSRCRequest does, behind a full queue
+    boost::asio::io_service service;
+    CoapPortTracker tracker(service);
+    ResponseDispatcher dispatcher(901);
+    std::vector<Coap::MessageView> answers;
+    dispatcher.registerHandler(905, "systemStatus", [&answers](const Coap::MessageView &msg) {
+        answers.push_back(msg);
+    });
+
+    DatagramPool pool(64, 4);
+    FairScheduler scheduler(256, 1);
+    EXPECT_TRUE(scheduler.enqueue(905, pool.acquire(), 10));
+
+    const std::vector<uint8_t> request = Coap::buildMessage(Coap::Type::CON, Coap::Method::GET, 0x1234,
+                                                            {"st", "system"}, {}, {}, {});
+    DatagramPtr frame = pool.acquire();
+    std::copy(request.begin(), request.end(), frame.data());
+    size_t length = request.size();
+    tracker.udpToSerial(905, frame.data(), &length, frame.capacity());
+    ASSERT_FALSE(scheduler.enqueue(905, std::move(frame), length));
+
+    // The 5.03 carries the tracking token, so it finds its way back to the handler
+    DatagramPtr reply = pool.acquire();
+    size_t replyLength = Coap::createServiceUnavailable(frame.data(), 1, reply.data());
+    const uint16_t port = tracker.serialToUdp(reply.data(), &replyLength);
+    ASSERT_TRUE(dispatcher.owns(port));
+    dispatcher.dispatch(port, reply.data(), replyLength);
+
+    ASSERT_EQ(answers.size(), 1u);
+    EXPECT_EQ(answers[0].code, 0xA3);
+    EXPECT_EQ(answers[0].type, Coap::Type::ACK);
+    EXPECT_EQ(answers[0].mid, 0x1234);
+    EXPECT_EQ(answers[0].maxAge, 1u);
+}
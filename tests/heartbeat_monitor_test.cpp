@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <fort_agent/jaus/HeartbeatMonitor.h>
+
+TEST(HeartbeatMonitorTest, NothingWatchedBeforeTheFirstBeat) {
+    HeartbeatMonitor monitor(std::chrono::milliseconds(500));
+    const auto now = HeartbeatMonitor::Clock::now();
+    HeartbeatMonitor::Clock::duration latency{};
+
+    EXPECT_FALSE(monitor.alive(now));
+    EXPECT_EQ(monitor.deadline(), HeartbeatMonitor::Clock::time_point::max());
+    EXPECT_FALSE(monitor.expired(now + std::chrono::seconds(5), latency));
+}
+
+TEST(HeartbeatMonitorTest, DeadlineFollowsTheLastBeat) {
+    using std::chrono::milliseconds;
+    HeartbeatMonitor monitor(milliseconds(500));
+    const auto start = HeartbeatMonitor::Clock::now();
+    HeartbeatMonitor::Clock::duration latency{};
+
+    monitor.beat(start);
+    EXPECT_EQ(monitor.deadline(), start + milliseconds(500));
+    EXPECT_TRUE(monitor.alive(start + milliseconds(499)));
+
+    monitor.beat(start + milliseconds(300));
+    EXPECT_EQ(monitor.deadline(), start + milliseconds(800));
+    EXPECT_FALSE(monitor.expired(start + milliseconds(500), latency));
+    EXPECT_EQ(monitor.stats().beats, 2u);
+}
+
+TEST(HeartbeatMonitorTest, ReportsEachLossOnceWithItsLatency) {
+    using std::chrono::milliseconds;
+    HeartbeatMonitor monitor(milliseconds(500));
+    const auto start = HeartbeatMonitor::Clock::now();
+    HeartbeatMonitor::Clock::duration latency{};
+
+    monitor.beat(start);
+    EXPECT_TRUE(monitor.expired(start + milliseconds(520), latency));
+    EXPECT_EQ(latency, milliseconds(520));
+    EXPECT_FALSE(monitor.alive(start + milliseconds(520)));
+
+    // no further deadline until the component is heard from again
+    EXPECT_EQ(monitor.deadline(), HeartbeatMonitor::Clock::time_point::max());
+    EXPECT_FALSE(monitor.expired(start + milliseconds(2000), latency));
+    EXPECT_EQ(monitor.stats().losses, 1u);
+}
+
+TEST(HeartbeatMonitorTest, BeatAfterLossRecovers) {
+    using std::chrono::milliseconds;
+    HeartbeatMonitor monitor(milliseconds(500));
+    const auto start = HeartbeatMonitor::Clock::now();
+    HeartbeatMonitor::Clock::duration latency{};
+
+    monitor.beat(start);
+    ASSERT_TRUE(monitor.expired(start + milliseconds(600), latency));
+
+    monitor.beat(start + milliseconds(1000));
+    EXPECT_TRUE(monitor.alive(start + milliseconds(1100)));
+    EXPECT_EQ(monitor.deadline(), start + milliseconds(1500));
+    EXPECT_FALSE(monitor.expired(start + milliseconds(1100), latency));
+    EXPECT_TRUE(monitor.expired(start + milliseconds(1500), latency));
+
+    const HeartbeatMonitor::Stats stats = monitor.stats();
+    EXPECT_EQ(stats.losses, 2u);
+    EXPECT_EQ(stats.recoveries, 1u);
+}
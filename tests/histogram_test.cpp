@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+
+#include <fort_agent/histogram.h>
+
+namespace {
+
+TEST(HistogramTest, TracksCountMeanAndMax) {
+    Histogram hist;
+    for (uint64_t v : {1, 2, 3, 4, 16}) {
+        hist.record(v);
+    }
+
+    EXPECT_EQ(hist.count(), 5u);
+    EXPECT_EQ(hist.max(), 16u);
+    EXPECT_DOUBLE_EQ(hist.mean(), 26.0 / 5.0);
+}
+
+TEST(HistogramTest, PercentileReportsBucketUpperBound) {
+    Histogram hist;
+    for (int i = 0; i < 99; i++) {
+        hist.record(5);  // bucket [4, 8)
+    }
+    hist.record(1000);
+
+    EXPECT_EQ(hist.percentile(50), 7u);
+    EXPECT_EQ(hist.percentile(100), 1000u);
+
+    hist.reset();
+    EXPECT_EQ(hist.count(), 0u);
+    EXPECT_EQ(hist.percentile(99), 0u);
+}
+
+}  // namespace
@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+
+#include <fort_agent/jaus/JausReports.h>
+
+TEST(JausReportsTest, MissingFieldsRenderAsNotAvailable) {
+    PoseReport pose{};
+    pose.latitudeDeg = 45.5;
+    pose.yawRad = 1.25;
+    pose.fields = PoseReport::LATITUDE | PoseReport::YAW;
+
+    EXPECT_EQ(renderSummary(pose), "lat 45.5 lon N/A alt N/A yaw 1.25");
+    const std::string frame = renderFrame(pose);
+    EXPECT_NE(frame.find(" Report Global Pose\n"), std::string::npos);
+    EXPECT_NE(frame.find(" Latitude: 45.5\n"), std::string::npos);
+    EXPECT_NE(frame.find(" Altitude: N/A\n"), std::string::npos);
+}
+
+TEST(JausReportsTest, WrenchAxesInOrder) {
+    WrenchReport wrench{};
+    wrench.propulsive = {10, 20, 0, 0, 0, -30};
+    wrench.propulsiveFields = 0x23;  // linear X, linear Y, rotational Z
+
+    EXPECT_EQ(renderSummary(wrench), "propulsive 10 20 N/A N/A N/A -30");
+    const std::string frame = renderFrame(wrench);
+    EXPECT_NE(frame.find("   Rotational Z: -30\n"), std::string::npos);
+    EXPECT_NE(frame.find(" Resistive Effort\n   Linear X: N/A\n"), std::string::npos);
+}
+
+TEST(JausReportsTest, ControlNamesTheHolder) {
+    const ControlReport control{12, 1, 3, 128, 1};
+    EXPECT_EQ(renderSummary(control), "held by 12.1.3 authority 128");
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <fort_agent/uart/FORTJoystick/JoystickDisplay.h>
+
+using std::chrono::milliseconds;
+
+namespace {
+
+// What the display sent to the joystick
+struct Screen {
+    std::vector<int> modes;
+    std::vector<std::string> segments;  // "line.segment:text"
+    std::vector<std::string> halves;    // "upper|lower:line0/line1"
+
+    JoystickDisplay::Sink sink() {
+        return {
+            [this](uint8_t mode) { modes.push_back(mode); },
+            [this](uint8_t line, uint8_t segment, const std::string& text) {
+                segments.push_back(std::to_string(line) + "." + std::to_string(segment) + ":" + text);
+            },
+            [this](const std::string& line0, const std::string& line1, bool upperHalf) {
+                halves.push_back(std::string(upperHalf ? "upper" : "lower") + ":" + line0 + "/" + line1);
+            }};
+    }
+};
+
+}
+
+TEST(JoystickDisplayTest, WaitsOutTheWindowThenWritesTheHalf) {
+    Screen screen;
+    JoystickDisplay display(screen.sink(), milliseconds(40));
+    const auto start = JoystickDisplay::Clock::now();
+
+    display.setMode(1, start);
+    display.setText(true, "Searching", "Press 1", start);
+    EXPECT_EQ(display.deadline(), start + milliseconds(40));
+    EXPECT_FALSE(display.flush(start + milliseconds(39)));
+    EXPECT_TRUE(screen.modes.empty());
+
+    EXPECT_TRUE(display.flush(start + milliseconds(40)));
+    EXPECT_EQ(screen.modes, std::vector<int>{1});
+    ASSERT_EQ(screen.halves.size(), 2u);
+    EXPECT_EQ(screen.halves[0], "upper:Searching         /Press 1           ");
+    EXPECT_EQ(display.deadline(), JoystickDisplay::Clock::time_point::max());
+}
+
+TEST(JoystickDisplayTest, SendsOnlyTheChangedSegment) {
+    Screen screen;
+    JoystickDisplay display(screen.sink(), milliseconds(40));
+    const auto start = JoystickDisplay::Clock::now();
+
+    display.setText(true, "Requesting", "Active state...", start);
+    display.flush(start + milliseconds(40));
+    screen.halves.clear();
+
+    display.setText(true, "Requesting", "Active state Retry", start + milliseconds(100));
+    EXPECT_TRUE(display.flush(start + milliseconds(140)));
+    EXPECT_TRUE(screen.halves.empty());
+    EXPECT_EQ(screen.segments, std::vector<std::string>{"1.2: Retry"});
+}
+
+TEST(JoystickDisplayTest, CoalescesAndSkipsRedundantUpdates) {
+    Screen screen;
+    JoystickDisplay display(screen.sink(), milliseconds(40));
+    const auto start = JoystickDisplay::Clock::now();
+
+    display.setMode(1, start);
+    display.setText(true, "Vehicle found", "Husky", start);
+    display.flush(start + milliseconds(40));
+    screen.modes.clear();
+    screen.halves.clear();
+
+    // same text and mode again: nothing pending, nothing sent
+    display.setMode(1, start + milliseconds(50));
+    display.setText(true, "Vehicle found", "Husky", start + milliseconds(50));
+    EXPECT_EQ(display.deadline(), JoystickDisplay::Clock::time_point::max());
+
+    // a burst only sends the last text, and a change undone within the window sends nothing
+    display.setText(true, "Requesting control", "...", start + milliseconds(60));
+    display.setText(true, "Vehicle found", "Husky", start + milliseconds(70));
+    EXPECT_FALSE(display.flush(start + milliseconds(100)));
+    EXPECT_TRUE(screen.modes.empty());
+    EXPECT_TRUE(screen.halves.empty());
+    EXPECT_TRUE(screen.segments.empty());
+
+    const JoystickDisplay::Stats stats = display.stats();
+    EXPECT_EQ(stats.requests, 4u);
+    EXPECT_EQ(stats.unchanged, 1u);
+    EXPECT_EQ(stats.coalesced, 2u);
+    EXPECT_EQ(stats.modeSkipped, 1u);
+    EXPECT_EQ(stats.modeSwitches, 1u);
+}
+
+TEST(JoystickDisplayTest, InvalidateRewritesTheScreen) {
+    Screen screen;
+    JoystickDisplay display(screen.sink(), milliseconds(40));
+    const auto start = JoystickDisplay::Clock::now();
+
+    display.setMode(1, start);
+    display.setText(true, "Ready", "Joystick active", start);
+    display.flush(start + milliseconds(40));
+    screen.modes.clear();
+    screen.halves.clear();
+
+    display.invalidate();
+    EXPECT_LE(display.deadline(), JoystickDisplay::Clock::now());
+    EXPECT_GT(display.deadline(), JoystickDisplay::Clock::time_point::min());
+    EXPECT_TRUE(display.flush(start + milliseconds(50)));
+    EXPECT_EQ(screen.modes, std::vector<int>{1});
+    ASSERT_EQ(screen.halves.size(), 2u);
+    EXPECT_EQ(screen.halves[0], "upper:Ready             /Joystick active   ");
+}
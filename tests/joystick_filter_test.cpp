@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <fort_agent/jaus/JoystickFilter.h>
+
+namespace {
+
+frc_combined_data_t sample(int lx, uint16_t buttons = 0, bool ok = true) {
+    frc_combined_data_t data{};
+    data.keypad_data.buttonStatus = buttons;
+    for (jsCal_t *axis : {&data.joystick_data.leftXAxis, &data.joystick_data.leftYAxis,
+                          &data.joystick_data.leftZAxis, &data.joystick_data.rightXAxis,
+                          &data.joystick_data.rightYAxis, &data.joystick_data.rightZAxis}) {
+        axis->dataOK = ok;
+    }
+    data.joystick_data.leftXAxis.data = lx;
+    return data;
+}
+
+JoystickFilter::Settings thresholds(uint16_t deadband, uint16_t hysteresis) {
+    JoystickFilter::Settings settings{};
+    settings.deadband.fill(deadband);
+    settings.hysteresis.fill(hysteresis);
+    return settings;
+}
+
+bool accept(JoystickFilter &filter, frc_combined_data_t data, int *forwardedLx = nullptr) {
+    const bool forwarded = filter.accept(data);
+    if (forwardedLx != nullptr) {
+        *forwardedLx = data.joystick_data.leftXAxis.data;
+    }
+    return forwarded;
+}
+
+}
+
+TEST(JoystickFilterTest, DefaultsForwardEveryAxisChange) {
+    JoystickFilter filter;
+    EXPECT_TRUE(accept(filter, sample(0)));
+    EXPECT_FALSE(accept(filter, sample(0)));
+    EXPECT_TRUE(accept(filter, sample(1)));
+    EXPECT_FALSE(accept(filter, sample(1)));
+}
+
+TEST(JoystickFilterTest, DeadbandSnapsNoiseAtRestToZero) {
+    JoystickFilter filter(thresholds(20, 5));
+    int lx = -1;
+    EXPECT_TRUE(accept(filter, sample(3), &lx));
+    EXPECT_EQ(lx, 0);
+    for (int noise : {-7, 12, 20, -20, 4}) {
+        EXPECT_FALSE(accept(filter, sample(noise)));
+    }
+    EXPECT_TRUE(accept(filter, sample(21), &lx));
+    EXPECT_EQ(lx, 21);
+
+    const JoystickFilter::Stats stats = filter.stats();
+    EXPECT_EQ(stats.samples, 7u);
+    EXPECT_EQ(stats.forwarded, 2u);
+    EXPECT_EQ(stats.axisSuppressed[0], 5u);
+    EXPECT_EQ(stats.axisSuppressed[1], 0u);
+    EXPECT_NEAR(filter.suppressionRatio(), 5.0 / 7.0, 1e-9);
+}
+
+TEST(JoystickFilterTest, HysteresisIgnoresJitterAroundAHeldPosition) {
+    JoystickFilter filter(thresholds(20, 5));
+    int lx = -1;
+    EXPECT_TRUE(accept(filter, sample(1000)));
+    EXPECT_FALSE(accept(filter, sample(1004)));
+    EXPECT_FALSE(accept(filter, sample(996)));
+    EXPECT_TRUE(accept(filter, sample(1006), &lx));
+    EXPECT_EQ(lx, 1006);
+    // measured from the value last forwarded, so a slow drift still gets through
+    EXPECT_FALSE(accept(filter, sample(1010)));
+    EXPECT_TRUE(accept(filter, sample(1012)));
+}
+
+TEST(JoystickFilterTest, ReturnToCentreAlwaysForwarded) {
+    JoystickFilter filter(thresholds(20, 50));
+    EXPECT_TRUE(accept(filter, sample(0)));
+    EXPECT_TRUE(accept(filter, sample(60)));
+    int lx = -1;
+    EXPECT_TRUE(accept(filter, sample(19), &lx));   // only 41 away, but now inside the deadband
+    EXPECT_EQ(lx, 0);
+}
+
+TEST(JoystickFilterTest, KeypadAndDataOkChangesAlwaysForwarded) {
+    JoystickFilter filter(thresholds(20, 50));
+    EXPECT_TRUE(accept(filter, sample(0, 0)));
+    EXPECT_TRUE(accept(filter, sample(0, static_cast<uint16_t>(KeypadButton::R_Down))));
+    EXPECT_TRUE(accept(filter, sample(0, 0)));
+    EXPECT_TRUE(accept(filter, sample(0, 0, false)));
+    EXPECT_FALSE(accept(filter, sample(0, 0, false)));
+    EXPECT_EQ(filter.stats().keypadChanges, 3u);
+}
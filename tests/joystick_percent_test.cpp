@@ -0,0 +1,20 @@
+#include <gtest/gtest.h>
+
+#include <fort_agent/uart/FORTJoystick/FORTJoystickHelpers.h>
+
+static_assert(joystickPercentTable.size() == 4096, "one entry per 12-bit raw value");
+static_assert(joystickPercentTable[0] == -100.0, "-2048 clamps to full scale");
+static_assert(joystickPercentTable[2048] == 0.0, "centre is zero");
+static_assert(joystickPercentTable[4095] == 100.0, "2047 is full scale");
+
+TEST(JoystickPercentTest, MatchesLinearScaleForEveryRawValue) {
+    for (int raw = -2048; raw <= 2047; raw++) {
+        const double expected = std::max(raw, -2047) * 200.0 / 4094.0;
+        EXPECT_NEAR(joystickPercent(raw), expected, 1e-9) << "raw " << raw;
+    }
+}
+
+TEST(JoystickPercentTest, ClampsOutOfRangeValues) {
+    EXPECT_EQ(joystickPercent(-5000), -100.0);
+    EXPECT_EQ(joystickPercent(5000), 100.0);
+}
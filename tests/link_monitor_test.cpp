@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <fort_agent/coapHelpers.h>
+#include <fort_agent/linkMonitor.h>
+
+using Clock = LinkMonitor::Clock;
+using std::chrono::milliseconds;
+
+TEST(LinkMonitorTest, MeasuresPingRoundTrip) {
+    boost::asio::io_service service;
+    TimedStrand strand(service, "serial");
+    std::vector<std::vector<uint8_t>> sent;
+    std::vector<std::pair<LinkMonitor::Event, milliseconds>> events;
+    LinkMonitor monitor(service, strand,
+                        [&sent](const uint8_t *message, size_t length) {
+                            sent.emplace_back(message, message + length);
+                            return true;
+                        },
+                        LinkMonitor::Settings{milliseconds(100), milliseconds(200), milliseconds(250)},
+                        [&events](LinkMonitor::Event event, milliseconds silence) {
+                            events.emplace_back(event, silence);
+                        });
+
+    const Clock::time_point start = Clock::now();
+    monitor.poll(start);
+
+    ASSERT_EQ(sent.size(), 1u);
+    ASSERT_EQ(sent[0].size(), 4u);
+    EXPECT_TRUE(Coap::isEmpty(sent[0].data()));
+    EXPECT_EQ(Coap::getCoapType(sent[0].data()), Coap::Type::CON);
+
+    // other traffic is not consumed, the matching RST is
+    const auto other = Coap::createResetMsg(Coap::getMid(sent[0].data()) + 1);
+    EXPECT_FALSE(monitor.onFrame(other.data(), other.size(), start + milliseconds(5)));
+    const auto reset = Coap::createResetMsg(Coap::getMid(sent[0].data()));
+    const std::vector<uint8_t> answer(reset.begin(), reset.end());
+    EXPECT_TRUE(monitor.onFrame(answer.data(), answer.size(), start + milliseconds(12)));
+    EXPECT_FALSE(monitor.onFrame(answer.data(), answer.size(), start + milliseconds(13)));
+
+    EXPECT_EQ(monitor.rtt().count(), 1u);
+    EXPECT_GE(monitor.rtt().max(), 12000u);
+    EXPECT_EQ(monitor.stats().pongs, 1u);
+    EXPECT_EQ(monitor.lossRate(), 0.0);
+}
+
+TEST(LinkMonitorTest, CountsLostPings) {
+    boost::asio::io_service service;
+    TimedStrand strand(service, "serial");
+    std::vector<std::vector<uint8_t>> sent;
+    std::vector<std::pair<LinkMonitor::Event, milliseconds>> events;
+    LinkMonitor monitor(service, strand,
+                        [&sent](const uint8_t *message, size_t length) {
+                            sent.emplace_back(message, message + length);
+                            return true;
+                        },
+                        LinkMonitor::Settings{milliseconds(100), milliseconds(200), milliseconds(250)},
+                        [&events](LinkMonitor::Event event, milliseconds silence) {
+                            events.emplace_back(event, silence);
+                        });
+
+    const Clock::time_point start = Clock::now();
+    monitor.poll(start);
+    monitor.poll(start + milliseconds(100));   // still outstanding, no second ping
+    EXPECT_EQ(sent.size(), 1u);
+
+    monitor.poll(start + milliseconds(200));   // timed out, a new one goes out
+    EXPECT_EQ(sent.size(), 2u);
+    EXPECT_NE(Coap::getMid(sent[0].data()), Coap::getMid(sent[1].data()));
+
+    const LinkMonitor::Stats stats = monitor.stats();
+    EXPECT_EQ(stats.pingsSent, 2u);
+    EXPECT_EQ(stats.lost, 1u);
+    EXPECT_DOUBLE_EQ(monitor.lossRate(), 0.5);
+}
+
+TEST(LinkMonitorTest, ReportsSilenceAndRecovery) {
+    boost::asio::io_service service;
+    TimedStrand strand(service, "serial");
+    std::vector<std::vector<uint8_t>> sent;
+    std::vector<std::pair<LinkMonitor::Event, milliseconds>> events;
+    LinkMonitor monitor(service, strand,
+                        [&sent](const uint8_t *message, size_t length) {
+                            sent.emplace_back(message, message + length);
+                            return true;
+                        },
+                        LinkMonitor::Settings{milliseconds(100), milliseconds(200), milliseconds(250)},
+                        [&events](LinkMonitor::Event event, milliseconds silence) {
+                            events.emplace_back(event, silence);
+                        });
+
+    const Clock::time_point start = Clock::now();
+    const std::vector<uint8_t> frame = {0x50, 0x45, 0x12, 0x34};
+    monitor.onFrame(frame.data(), frame.size(), start);
+
+    monitor.poll(start + milliseconds(200));
+    EXPECT_TRUE(events.empty());
+
+    monitor.poll(start + milliseconds(300));
+    monitor.poll(start + milliseconds(400));
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].first, LinkMonitor::Event::SILENT);
+    EXPECT_EQ(events[0].second, milliseconds(300));
+    EXPECT_TRUE(monitor.stats().silent);
+
+    monitor.onFrame(frame.data(), frame.size(), start + milliseconds(450));
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[1].first, LinkMonitor::Event::RECOVERED);
+    EXPECT_EQ(events[1].second, milliseconds(450));
+    EXPECT_FALSE(monitor.stats().silent);
+    EXPECT_EQ(monitor.stats().silenceEvents, 1u);
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fort_agent/mpscRing.h>
+
+TEST(MpscRingTest, PushPopInOrderUntilFull) {
+    MpscRing<std::string, 4> ring;
+    EXPECT_TRUE(ring.empty());
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(ring.push(std::to_string(i)));
+    }
+    EXPECT_FALSE(ring.push("4"));
+    EXPECT_EQ(ring.size(), 4u);
+
+    std::string value;
+    EXPECT_TRUE(ring.pop(value));
+    EXPECT_EQ(value, "0");
+    EXPECT_TRUE(ring.push("4"));
+
+    for (int expected = 1; expected <= 4; expected++) {
+        ASSERT_TRUE(ring.pop(value));
+        EXPECT_EQ(value, std::to_string(expected));
+    }
+    EXPECT_FALSE(ring.pop(value));
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(MpscRingTest, KeepsEachProducersOrderAcrossThreads) {
+    constexpr int producers = 4;
+    constexpr int count = 20000;
+    MpscRing<int, 64> ring;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&ring, p]() {
+            for (int i = 0; i < count; i++) {
+                while (!ring.push(p * count + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> next(producers, 0);
+    int received = 0;
+    while (received < producers * count) {
+        int value;
+        if (!ring.pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        const int producer = value / count;
+        ASSERT_EQ(value % count, next[producer]);
+        next[producer]++;
+        received++;
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_TRUE(ring.empty());
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <fort_agent/observeSubscriptions.h>
+
+using std::chrono::milliseconds;
+
+namespace {
+
+Coap::MessageView notification(Coap::Type type, uint16_t mid, uint8_t code = 0x45, bool hasObserve = true) {
+    Coap::MessageView view{};
+    view.type = type;
+    view.code = code;
+    view.mid = mid;
+    view.hasObserve = hasObserve;
+    view.maxAge = 60;
+    return view;
+}
+
+}
+
+TEST(ObserveSubscriptionsTest, NotificationsKeepTheSubscriptionFresh) {
+    ObserveSubscriptions subscriptions(0x100, ObserveSubscriptions::Settings());
+    std::vector<uint16_t> sent;
+    subscriptions.add(7, "joystick", [&sent](uint16_t mid) { sent.push_back(mid); }, milliseconds(500));
+    const auto start = ObserveSubscriptions::Clock::now();
+
+    subscriptions.start(start);
+    ASSERT_EQ(sent.size(), 1u);
+    EXPECT_EQ(sent[0], 0x100);
+
+    subscriptions.onNotification(7, notification(Coap::Type::ACK, 0x100), start + milliseconds(10));
+    for (int i = 1; i <= 10; i++) {
+        const auto now = start + milliseconds(10 + 100 * i);
+        subscriptions.onNotification(7, notification(Coap::Type::NON, 0x2000 + i), now);
+        EXPECT_EQ(subscriptions.poll(now), now + milliseconds(500));
+    }
+    EXPECT_EQ(sent.size(), 1u);
+    EXPECT_FALSE(subscriptions.stats()[0].stale);
+    EXPECT_EQ(subscriptions.stats()[0].notifications, 11u);
+}
+
+TEST(ObserveSubscriptionsTest, ReRegistersWithBackoffWhenStale) {
+    ObserveSubscriptions subscriptions(0x100, ObserveSubscriptions::Settings());
+    std::vector<uint16_t> sent;
+    subscriptions.add(7, "joystick", [&sent](uint16_t mid) { sent.push_back(mid); }, milliseconds(500));
+    const auto start = ObserveSubscriptions::Clock::now();
+
+    subscriptions.start(start);
+    subscriptions.onNotification(7, notification(Coap::Type::ACK, 0x100), start);
+
+    // nothing for 500 ms: stale, re-registered with a new MID, then retried 100, 200, 400 ms later
+    EXPECT_EQ(subscriptions.poll(start + milliseconds(499)), start + milliseconds(500));
+    EXPECT_EQ(subscriptions.poll(start + milliseconds(500)), start + milliseconds(600));
+    EXPECT_EQ(subscriptions.poll(start + milliseconds(600)), start + milliseconds(800));
+    EXPECT_EQ(subscriptions.poll(start + milliseconds(800)), start + milliseconds(1200));
+    EXPECT_EQ(sent, (std::vector<uint16_t>{0x100, 0x101, 0x102, 0x103}));
+    EXPECT_TRUE(subscriptions.stats()[0].stale);
+    EXPECT_EQ(subscriptions.stats()[0].staleEvents, 1u);
+
+    // the backoff is bounded
+    auto now = start + milliseconds(1200);
+    for (int i = 0; i < 10; i++) {
+        now = subscriptions.poll(now);
+    }
+    EXPECT_EQ(subscriptions.poll(now), now + milliseconds(2000));
+
+    // notifications resume and the backoff starts over
+    subscriptions.onNotification(7, notification(Coap::Type::ACK, sent.back()), now);
+    EXPECT_FALSE(subscriptions.stats()[0].stale);
+    subscriptions.poll(now + milliseconds(500));
+    EXPECT_EQ(subscriptions.poll(now + milliseconds(500)), now + milliseconds(600));
+}
+
+TEST(ObserveSubscriptionsTest, EndOfObservationReRegistersImmediately) {
+    ObserveSubscriptions subscriptions(0x100, ObserveSubscriptions::Settings());
+    std::vector<uint16_t> sent;
+    subscriptions.add(7, "joystick", [&sent](uint16_t mid) { sent.push_back(mid); }, milliseconds(500));
+    const auto start = ObserveSubscriptions::Clock::now();
+
+    subscriptions.start(start);
+
+    // answer to an earlier deregistration for the same resource, not ours
+    subscriptions.onNotification(7, notification(Coap::Type::ACK, 0x3000, 0x45, false), start);
+    EXPECT_EQ(subscriptions.poll(start), start + milliseconds(100));
+    EXPECT_EQ(sent.size(), 1u);
+
+    // the device refuses our registration
+    subscriptions.onNotification(7, notification(Coap::Type::ACK, 0x100, 0x84), start + milliseconds(5));
+    subscriptions.poll(start + milliseconds(5));
+    EXPECT_EQ(sent.size(), 2u);
+}
+
+TEST(ObserveSubscriptionsTest, ResubscribeAllAfterReconnect) {
+    ObserveSubscriptions subscriptions(0x100, ObserveSubscriptions::Settings());
+    std::vector<uint16_t> sent;
+    subscriptions.add(7, "joystick", [&sent](uint16_t mid) { sent.push_back(mid); }, milliseconds(500));
+    const auto start = ObserveSubscriptions::Clock::now();
+
+    subscriptions.resubscribeAll(start);
+    EXPECT_TRUE(sent.empty());  // not started yet
+
+    subscriptions.start(start);
+    subscriptions.onNotification(7, notification(Coap::Type::ACK, 0x100), start);
+    subscriptions.resubscribeAll(start + milliseconds(50));
+    EXPECT_EQ(sent, (std::vector<uint16_t>{0x100, 0x101}));
+    EXPECT_EQ(subscriptions.stats()[0].registrations, 2u);
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fort_agent/responseDispatcher.h>
+
+namespace {
+
+// 2.05 Content ACK, MID 0x1234, token 0xAB, Observe 7, Content-Format 42, payload "hi"
+const std::vector<uint8_t> contentResponse = {
+    0x61, 0x45, 0x12, 0x34, 0xAB,
+    0x61, 0x07,        // Observe (6) = 7
+    0x61, 0x2A,        // Content-Format (12) = 42
+    0xFF, 'h', 'i'
+};
+
+TEST(ResponseDispatcherTest, ParsesMessageView) {
+    const Coap::MessageView view = Coap::parseMessage(contentResponse.data(), contentResponse.size());
+
+    EXPECT_EQ(view.type, Coap::Type::ACK);
+    EXPECT_EQ(view.code, 0x45);
+    EXPECT_EQ(view.mid, 0x1234);
+    ASSERT_EQ(view.tokenLength, 1u);
+    EXPECT_EQ(view.token[0], 0xAB);
+    EXPECT_TRUE(view.hasObserve);
+    EXPECT_EQ(view.observe, 7u);
+    EXPECT_EQ(view.contentFormat, Coap::Format::APPLICATION_OCTET_STREAM);
+    EXPECT_EQ(view.maxAge, 60u);
+    EXPECT_EQ(std::string(reinterpret_cast<const char *>(view.payload), view.payloadLength), "hi");
+}
+
+TEST(ResponseDispatcherTest, RejectsTruncatedOption) {
+    const std::vector<uint8_t> truncated = {0x60, 0x45, 0x00, 0x01, 0xB5, 'a', 'b'};
+    EXPECT_THROW(Coap::parseMessage(truncated.data(), truncated.size()), CoapException);
+}
+
+TEST(ResponseDispatcherTest, DispatchesByIdAndCounts) {
+    ResponseDispatcher dispatcher(901);
+    std::string received;
+    dispatcher.registerHandler(920, "test", [&](const Coap::MessageView &msg) {
+        received.assign(reinterpret_cast<const char *>(msg.payload), msg.payloadLength);
+    });
+
+    EXPECT_TRUE(dispatcher.owns(901));
+    EXPECT_TRUE(dispatcher.owns(901 + ResponseDispatcher::capacity - 1));
+    EXPECT_FALSE(dispatcher.owns(900));
+    EXPECT_FALSE(dispatcher.owns(5683));
+
+    dispatcher.dispatch(920, contentResponse.data(), contentResponse.size());
+    dispatcher.dispatch(920, contentResponse.data(), contentResponse.size());
+    EXPECT_EQ(received, "hi");
+    EXPECT_EQ(dispatcher.callCount(920), 2u);
+
+    // owned id without a handler is dropped and counted
+    dispatcher.dispatch(930, contentResponse.data(), contentResponse.size());
+    EXPECT_EQ(dispatcher.unhandledCount(), 1u);
+    EXPECT_EQ(dispatcher.callCount(930), 0u);
+}
+
+TEST(ResponseDispatcherTest, RejectsBadRegistrations) {
+    ResponseDispatcher dispatcher(901);
+    auto noop = [](const Coap::MessageView &) {};
+
+    dispatcher.registerHandler(901, "first", noop);
+    EXPECT_THROW(dispatcher.registerHandler(901, "again", noop), std::invalid_argument);
+    EXPECT_THROW(dispatcher.registerHandler(900, "below", noop), std::invalid_argument);
+    EXPECT_THROW(dispatcher.registerHandler(901 + ResponseDispatcher::capacity, "above", noop),
+                 std::invalid_argument);
+}
+
+}  // namespace
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+#include <fort_agent/seqlockSnapshot.h>
+
+namespace {
+
+// Every field carries the same value, so a torn read shows up as a mismatch
+struct Record {
+    uint64_t a;
+    double b;
+    uint32_t c;
+    uint8_t d;
+};
+
+Record recordOf(uint64_t n) {
+    return {n, static_cast<double>(n), static_cast<uint32_t>(n), static_cast<uint8_t>(n)};
+}
+
+}
+
+TEST(SeqlockSnapshotTest, EmptyUntilStored) {
+    SeqlockSnapshot<Record> snapshot;
+    Record record{};
+    EXPECT_FALSE(snapshot.load(record));
+    EXPECT_EQ(snapshot.version(), 0u);
+
+    snapshot.store(recordOf(7));
+    ASSERT_TRUE(snapshot.load(record));
+    EXPECT_EQ(record.a, 7u);
+    EXPECT_EQ(record.b, 7.0);
+    EXPECT_EQ(record.d, 7u);
+    EXPECT_EQ(snapshot.version(), 1u);
+}
+
+TEST(SeqlockSnapshotTest, ReadersNeverSeeATornRecord) {
+    SeqlockSnapshot<Record> snapshot;
+    constexpr uint64_t writes = 200000;
+    std::atomic<bool> done{false};
+
+    std::thread writer([&] {
+        for (uint64_t n = 1; n <= writes; n++) {
+            snapshot.store(recordOf(n));
+        }
+        done = true;
+    });
+
+    uint64_t last = 0;
+    uint64_t reads = 0;
+    Record record{};
+    while (!done || record.a != writes) {
+        if (!snapshot.load(record)) {
+            continue;
+        }
+        ASSERT_EQ(record.b, static_cast<double>(record.a));
+        ASSERT_EQ(record.c, static_cast<uint32_t>(record.a));
+        ASSERT_EQ(record.d, static_cast<uint8_t>(record.a));
+        ASSERT_GE(record.a, last);
+        last = record.a;
+        reads++;
+    }
+    writer.join();
+    EXPECT_GT(reads, 0u);
+    EXPECT_EQ(snapshot.version(), writes);
+}
@@ -0,0 +1,81 @@
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <fort_agent/slip.h>
+
+namespace {
+
+using namespace FortAgentSlip;
+
+std::vector<uint8_t> decode(const std::vector<uint8_t> &encoded, uint32_t bufferSize, slip_error_t &error) {
+    std::vector<uint8_t> buffer(bufferSize);
+    std::vector<uint8_t> decoded;
+    slip_descriptor_s desc{};
+    desc.buf = buffer.data();
+    desc.buf_size = bufferSize;
+    desc.recv_message = [&decoded](uint8_t *data, uint32_t size) { decoded.assign(data, data + size); };
+    desc.write_byte = [](uint8_t) -> uint8_t { return 1; };
+    slip_handler_s slip{};
+    slip_init(&slip, &desc);
+
+    error = SLIP_NO_ERROR;
+    for (const uint8_t byte : encoded) {
+        const slip_error_t result = slip_read_byte(&slip, byte);
+        if (result != SLIP_NO_ERROR) {
+            error = result;
+        }
+    }
+    return decoded;
+}
+
+TEST(SlipTest, EscapesSpecialBytes) {
+    const std::vector<uint8_t> message{0x01, SLIP_SPECIAL_BYTE_END, 0x02, SLIP_SPECIAL_BYTE_ESC};
+    std::vector<uint8_t> encoded(slipEncodedMaxSize(message.size()));
+
+    const uint32_t length = createSlipEncodedMessage(encoded.data(), message.data(), message.size(), 16);
+    encoded.resize(length);
+
+    const std::vector<uint8_t> expected{SLIP_SPECIAL_BYTE_END, 0x01, SLIP_SPECIAL_BYTE_ESC, SLIP_ESCAPED_BYTE_END,
+                                        0x02, SLIP_SPECIAL_BYTE_ESC, SLIP_ESCAPED_BYTE_ESC, SLIP_SPECIAL_BYTE_END};
+    EXPECT_EQ(encoded, expected);
+}
+
+TEST(SlipTest, EncodesAnAllEscapedMessageOfExactlyTheMtu) {
+    constexpr uint32_t mtu = 32;
+    std::vector<uint8_t> message(mtu);
+    for (uint32_t i = 0; i < mtu; i++) {
+        message[i] = i % 2 ? SLIP_SPECIAL_BYTE_ESC : SLIP_SPECIAL_BYTE_END;
+    }
+    std::vector<uint8_t> encoded(slipEncodedMaxSize(mtu));
+
+    const uint32_t length = createSlipEncodedMessage(encoded.data(), message.data(), mtu, mtu);
+
+    // Every byte escaped fills the worst case buffer exactly, and decodes back within an MTU sized buffer
+    ASSERT_EQ(length, slipEncodedMaxSize(mtu));
+    slip_error_t error;
+    EXPECT_EQ(decode(encoded, mtu, error), message);
+    EXPECT_EQ(error, SLIP_NO_ERROR);
+}
+
+TEST(SlipTest, RefusesMessagesLongerThanTheMtu) {
+    constexpr uint32_t mtu = 32;
+    const std::vector<uint8_t> message(mtu + 1, SLIP_SPECIAL_BYTE_END);
+    std::vector<uint8_t> encoded(slipEncodedMaxSize(mtu + 1));
+
+    EXPECT_EQ(createSlipEncodedMessage(encoded.data(), message.data(), mtu + 1, mtu), 0u);
+}
+
+TEST(SlipTest, DecoderDropsFramesLongerThanItsBuffer) {
+    constexpr uint32_t mtu = 32;
+    const std::vector<uint8_t> message(mtu + 1, SLIP_SPECIAL_BYTE_ESC);
+    std::vector<uint8_t> encoded(slipEncodedMaxSize(mtu + 1));
+    encoded.resize(createSlipEncodedMessage(encoded.data(), message.data(), mtu + 1, mtu + 1));
+
+    slip_error_t error;
+    EXPECT_TRUE(decode(encoded, mtu, error).empty());
+    EXPECT_EQ(error, SLIP_ERROR_BUFFER_OVERFLOW);
+}
+
+}
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include <fort_agent/spscRing.h>
+#include <fort_agent/wakeSignal.h>
+
+TEST(SpscRingTest, PushPopInOrderUntilFull) {
+    SpscRing<int, 4> ring;
+    EXPECT_TRUE(ring.empty());
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(ring.push(i));
+    }
+    EXPECT_FALSE(ring.push(4));
+    EXPECT_EQ(ring.size(), 4u);
+
+    int value = -1;
+    EXPECT_TRUE(ring.pop(value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(ring.push(4));
+
+    for (int expected = 1; expected <= 4; expected++) {
+        ASSERT_TRUE(ring.pop(value));
+        EXPECT_EQ(value, expected);
+    }
+    EXPECT_FALSE(ring.pop(value));
+}
+
+TEST(SpscRingTest, HandsOffBetweenThreadsWithWakeSignal) {
+    constexpr int count = 100000;
+    SpscRing<int, 64> ring;
+    WakeSignal wake;
+
+    std::thread producer([&]() {
+        for (int i = 0; i < count; i++) {
+            while (!ring.push(i)) {
+                std::this_thread::yield();
+            }
+            wake.notify();
+        }
+    });
+
+    int expected = 0;
+    while (expected < count) {
+        ASSERT_TRUE(wake.waitUntil(WakeSignal::Clock::now() + std::chrono::seconds(5),
+                                   [&] { return !ring.empty(); }, std::chrono::microseconds(20)));
+        int value;
+        while (ring.pop(value)) {
+            ASSERT_EQ(value, expected++);
+        }
+    }
+    producer.join();
+}
+
+TEST(WakeSignalTest, TimesOutWithoutWork) {
+    WakeSignal wake;
+    const auto start = WakeSignal::Clock::now();
+    EXPECT_FALSE(wake.waitUntil(start + std::chrono::milliseconds(20), [] { return false; }));
+    EXPECT_GE(WakeSignal::Clock::now() - start, std::chrono::milliseconds(20));
+    EXPECT_EQ(wake.stats().sleeps, 1u);
+}
+
+TEST(WakeSignalTest, ReturnsAtOnceForDeadlinesLongPast) {
+    WakeSignal wake;
+    const auto start = WakeSignal::Clock::now();
+    EXPECT_FALSE(wake.waitUntil(WakeSignal::Clock::time_point::min(), [] { return false; }));
+    EXPECT_FALSE(wake.waitUntil(WakeSignal::Clock::time_point{}, [] { return false; }));
+    EXPECT_LT(WakeSignal::Clock::now() - start, std::chrono::seconds(1));
+}
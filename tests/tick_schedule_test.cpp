@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <fort_agent/jaus/TickSchedule.h>
+
+using std::chrono::milliseconds;
+
+TEST(TickScheduleTest, OnTimeTicksFollowTheGrid) {
+    TickSchedule schedule(milliseconds(20));
+    const auto start = TickSchedule::Clock::now();
+    schedule.start(start);
+
+    EXPECT_EQ(schedule.deadline(), start + milliseconds(20));
+    EXPECT_FALSE(schedule.due(start + milliseconds(19)));
+    ASSERT_TRUE(schedule.due(start + milliseconds(20)));
+
+    // finishing a little after the deadline does not shift the grid
+    schedule.complete(start + milliseconds(21));
+    EXPECT_EQ(schedule.deadline(), start + milliseconds(40));
+    schedule.complete(start + milliseconds(45));
+    EXPECT_EQ(schedule.deadline(), start + milliseconds(60));
+
+    const TickSchedule::Stats stats = schedule.stats();
+    EXPECT_EQ(stats.ticks, 2u);
+    EXPECT_EQ(stats.overruns, 0u);
+}
+
+TEST(TickScheduleTest, TickRunningIntoTheNextDeadlineSkipsIt) {
+    TickSchedule schedule(milliseconds(20));
+    const auto start = TickSchedule::Clock::now();
+    schedule.start(start);
+
+    // due at 20, finished at 40: the tick at 40 is skipped instead of running straight away
+    schedule.complete(start + milliseconds(40));
+    EXPECT_EQ(schedule.deadline(), start + milliseconds(60));
+    EXPECT_EQ(schedule.stats().overruns, 1u);
+
+    schedule.complete(start + milliseconds(61));
+    EXPECT_EQ(schedule.deadline(), start + milliseconds(80));
+    EXPECT_EQ(schedule.stats().overruns, 1u);
+}
+
+TEST(TickScheduleTest, StallSkipsEveryMissedPeriod) {
+    TickSchedule schedule;
+    schedule.setRate(50);
+    ASSERT_EQ(schedule.period(), milliseconds(20));
+    const auto start = TickSchedule::Clock::now();
+    schedule.start(start);
+
+    // due at 20, stalled until 115: the ticks at 40, 60, 80 and 100 are skipped
+    schedule.complete(start + milliseconds(115));
+    EXPECT_EQ(schedule.deadline(), start + milliseconds(120));
+    EXPECT_FALSE(schedule.due(start + milliseconds(119)));
+
+    const TickSchedule::Stats stats = schedule.stats();
+    EXPECT_EQ(stats.ticks, 1u);
+    EXPECT_EQ(stats.overruns, 4u);
+}
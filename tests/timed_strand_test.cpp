@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <fort_agent/timedStrand.h>
+
+namespace {
+
+TEST(TimedStrandTest, PostedHandlersNeverOverlap) {
+    boost::asio::io_service service;
+    TimedStrand strand(service, "test");
+
+    std::atomic<int> running{0};
+    std::atomic<bool> overlapped{false};
+    int counter = 0;  // only touched on the strand
+    constexpr int posts = 1000;
+
+    for (int i = 0; i < posts; i++) {
+        strand.post([&]() {
+            if (running.fetch_add(1) != 0) {
+                overlapped = true;
+            }
+            EXPECT_TRUE(strand.runningInThisThread());
+            counter++;
+            running.fetch_sub(1);
+        });
+    }
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&]() { service.run(); });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_FALSE(overlapped);
+    EXPECT_EQ(counter, posts);
+    EXPECT_EQ(strand.queueLatency().count(), static_cast<uint64_t>(posts));
+    EXPECT_EQ(strand.name(), "test");
+}
+
+TEST(TimedStrandTest, WrappedCompletionRunsOnStrand) {
+    boost::asio::io_service service;
+    TimedStrand strand(service, "timer");
+    boost::asio::steady_timer timer(service, std::chrono::milliseconds(1));
+
+    bool ranOnStrand = false;
+    timer.async_wait(strand.wrap([&](const boost::system::error_code &) {
+        ranOnStrand = strand.runningInThisThread();
+    }));
+    service.run();
+
+    EXPECT_TRUE(ranOnStrand);
+    // completions of async operations are not counted as queued work
+    EXPECT_EQ(strand.queueLatency().count(), 0u);
+}
+
+}  // namespace
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <fort_agent/jaus/VehicleDirectory.h>
+
+using std::chrono::seconds;
+
+namespace {
+
+std::vector<uint32_t> ids(const VehicleDirectory::Snapshot& snapshot) {
+    std::vector<uint32_t> out;
+    for (const auto& vehicle : snapshot.vehicles) {
+        out.push_back(vehicle.id);
+    }
+    return out;
+}
+
+}
+
+TEST(VehicleDirectoryTest, EmptyBeforeTheFirstRefresh) {
+    VehicleDirectory directory;
+    const auto now = VehicleDirectory::Clock::now();
+
+    const auto snapshot = directory.snapshot();
+    ASSERT_NE(snapshot, nullptr);
+    EXPECT_TRUE(snapshot->vehicles.empty());
+    EXPECT_EQ(directory.age(now), VehicleDirectory::Clock::duration::max());
+}
+
+TEST(VehicleDirectoryTest, RanksNamedComponentsFirstThenByAddress) {
+    VehicleDirectory directory;
+    const auto now = VehicleDirectory::Clock::now();
+
+    EXPECT_TRUE(directory.update({{0x30101, ""}, {0x20101, "Husky"}, {0x10101, ""}, {0x40101, "Warthog"}}, now));
+    const auto snapshot = directory.snapshot();
+    EXPECT_EQ(ids(*snapshot), (std::vector<uint32_t>{0x20101, 0x40101, 0x10101, 0x30101}));
+    EXPECT_EQ(snapshot->generation, 1u);
+    EXPECT_EQ(directory.age(now + seconds(3)), seconds(3));
+}
+
+TEST(VehicleDirectoryTest, OnlyPublishesChanges) {
+    VehicleDirectory directory;
+    const auto now = VehicleDirectory::Clock::now();
+
+    directory.update({{0x10101, "Husky"}, {0x20101, "Jackal"}}, now);
+    const auto first = directory.snapshot();
+
+    // the same components in a different order are not a change
+    EXPECT_FALSE(directory.update({{0x20101, "Jackal"}, {0x10101, "Husky"}}, now + seconds(1)));
+    EXPECT_EQ(directory.snapshot(), first);
+    EXPECT_EQ(directory.age(now + seconds(1)), seconds(0));
+
+    EXPECT_TRUE(directory.update({{0x10101, "Husky A200"}, {0x20101, "Jackal"}}, now + seconds(2)));
+    EXPECT_EQ(directory.snapshot()->generation, 2u);
+    EXPECT_EQ(directory.knownName(0x10101), "Husky A200");
+
+    // readers keep the list they took
+    EXPECT_EQ(first->vehicles[0].name, "Husky");
+
+    const VehicleDirectory::Stats stats = directory.stats();
+    EXPECT_EQ(stats.refreshes, 3u);
+    EXPECT_EQ(stats.changes, 2u);
+}
+
+TEST(VehicleDirectoryTest, SelectedVehicleStaysFirst) {
+    VehicleDirectory directory;
+    const auto now = VehicleDirectory::Clock::now();
+
+    directory.update({{0x20101, "B"}, {0x10101, "A"}}, now);
+    directory.prefer(0x20101);
+    directory.update({{0x10101, "A"}, {0x20101, "B"}, {0x30101, ""}}, now + seconds(1));
+    EXPECT_EQ(ids(*directory.snapshot()), (std::vector<uint32_t>{0x20101, 0x10101, 0x30101}));
+}
@@ -0,0 +1,112 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <fort_agent/jaus/WrenchStreamer.h>
+
+#include "mocks/MockJausClient.h"
+
+using ::testing::_;
+
+using std::chrono::milliseconds;
+
+namespace {
+
+frc_joystick_data_t stick(int x) {
+    frc_joystick_data_t data{};
+    data.leftXAxis.data = x;
+    data.leftXAxis.dataOK = true;
+    return data;
+}
+
+MATCHER_P(LeftX, x, "") { return arg.leftXAxis.data == x; }
+
+}
+
+TEST(WrenchStreamerTest, NothingBeforeTheFirstSample) {
+    WrenchStreamer::setRate(25);
+    MockJAUSClient client;
+    WrenchStreamer streamer(client);
+    const auto start = WrenchStreamer::Clock::now();
+
+    EXPECT_CALL(client, sendWrenchEffort(_)).Times(0);
+    streamer.poll(start);
+    streamer.poll(start + milliseconds(100));
+}
+
+TEST(WrenchStreamerTest, SendsLatestSampleOncePerPeriod) {
+    WrenchStreamer::setRate(25);
+    MockJAUSClient client;
+    WrenchStreamer streamer(client);
+    const auto start = WrenchStreamer::Clock::now();
+
+    const WrenchStreamer::Stats before = WrenchStreamer::stats();
+    {
+        ::testing::InSequence order;
+        EXPECT_CALL(client, sendWrenchEffort(LeftX(3))).Times(1);
+        EXPECT_CALL(client, sendWrenchEffort(LeftX(5))).Times(2);
+    }
+
+    // a burst of three samples is one command
+    streamer.update(stick(1));
+    streamer.update(stick(2));
+    streamer.update(stick(3));
+    streamer.poll(start);
+
+    // polled every 20 ms control tick, sent every 40 ms
+    streamer.update(stick(4));
+    streamer.update(stick(5));
+    streamer.poll(start + milliseconds(20));
+    streamer.poll(start + milliseconds(39));   // slightly early tick still counts
+    streamer.poll(start + milliseconds(60));
+    streamer.poll(start + milliseconds(80));   // held: no new sample since
+
+    const WrenchStreamer::Stats after = WrenchStreamer::stats();
+    EXPECT_EQ(after.samples - before.samples, 5u);
+    EXPECT_EQ(after.sent - before.sent, 3u);
+    EXPECT_EQ(after.superseded - before.superseded, 3u);
+    EXPECT_EQ(after.held - before.held, 1u);
+}
+
+TEST(WrenchStreamerTest, SkipsMissedPeriodsInsteadOfBursting) {
+    WrenchStreamer::setRate(25);
+    MockJAUSClient client;
+    WrenchStreamer streamer(client);
+    const auto start = WrenchStreamer::Clock::now();
+
+    EXPECT_CALL(client, sendWrenchEffort(_)).Times(3);
+    streamer.update(stick(1));
+    streamer.poll(start);
+    // a stall of 10 periods gives one send, then the grid resumes
+    streamer.poll(start + milliseconds(410));
+    streamer.poll(start + milliseconds(420));
+    streamer.poll(start + milliseconds(440));
+}
+
+TEST(WrenchStreamerTest, SendsZeroEffortOnceTheSampleIsNoLongerConfirmed) {
+    WrenchStreamer::setRate(25);
+    MockJAUSClient client;
+    WrenchStreamer streamer(client);
+    const auto start = WrenchStreamer::Clock::now();
+
+    WrenchStreamer::setMaxHold(milliseconds(500));
+    const WrenchStreamer::Stats before = WrenchStreamer::stats();
+    {
+        ::testing::InSequence order;
+        EXPECT_CALL(client, sendWrenchEffort(LeftX(7))).Times(2);
+        EXPECT_CALL(client, sendWrenchEffort(LeftX(0))).Times(2);
+        EXPECT_CALL(client, sendWrenchEffort(LeftX(8))).Times(1);
+    }
+
+    streamer.update(stick(7), start);
+    streamer.poll(start);
+    // filtered notifications still confirm the stick is held where it was
+    WrenchStreamer::confirm(start + milliseconds(400));
+    streamer.poll(start + milliseconds(880));
+    // nothing for more than 500 ms: zero effort, and it stays zero
+    streamer.poll(start + milliseconds(920));
+    streamer.poll(start + milliseconds(960));
+    streamer.update(stick(8), start + milliseconds(990));
+    streamer.poll(start + milliseconds(1000));
+
+    EXPECT_EQ(WrenchStreamer::stats().expired - before.expired, 1u);
+}